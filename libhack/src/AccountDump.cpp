@@ -0,0 +1,439 @@
+/**
+ * @file libhack/src/AccountDump.cpp
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Streaming reader and writer for binary account dumps.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AccountDump.h"
+
+// libhack Includes
+#include "MemoryStream.h"
+
+// Standard C++11 Includes
+#include <cstring>
+#include <unordered_map>
+
+// libobjgen Includes
+#include <MetaObject.h>
+
+// Ignore warnings
+#include <PushIgnore.h>
+
+// tinyxml2 Includes
+#include <tinyxml2.h>
+
+// Stop ignoring warnings
+#include <PopIgnore.h>
+
+using namespace libhack;
+
+/// Magic value at the start of every binary account dump
+#define ACCOUNT_DUMP_MAGIC "CHAD"
+
+/// Size of the magic value in bytes
+#define ACCOUNT_DUMP_MAGIC_SIZE (4)
+
+/// Current version of the binary account dump format
+#define ACCOUNT_DUMP_VERSION (2)
+
+/// Largest single object accepted when reading a dump
+#define ACCOUNT_DUMP_MAX_OBJECT_SIZE (16 * 1024 * 1024)
+
+namespace {
+
+void WriteU16(std::ostream& out, uint16_t value) {
+  char data[2] = {(char)(value & 0xFF), (char)((value >> 8) & 0xFF)};
+
+  out.write(data, sizeof(data));
+}
+
+void WriteU32(std::ostream& out, uint32_t value) {
+  char data[4] = {(char)(value & 0xFF), (char)((value >> 8) & 0xFF),
+                  (char)((value >> 16) & 0xFF), (char)((value >> 24) & 0xFF)};
+
+  out.write(data, sizeof(data));
+}
+
+void WriteString(std::ostream& out, const std::string& value) {
+  WriteU16(out, (uint16_t)value.size());
+  out.write(value.c_str(), (std::streamsize)value.size());
+}
+
+bool ReadU16(std::istream& in, uint16_t& value) {
+  unsigned char data[2];
+
+  if (!in.read((char*)data, sizeof(data))) {
+    return false;
+  }
+
+  value = (uint16_t)(data[0] | (data[1] << 8));
+
+  return true;
+}
+
+bool ReadU32(std::istream& in, uint32_t& value) {
+  unsigned char data[4];
+
+  if (!in.read((char*)data, sizeof(data))) {
+    return false;
+  }
+
+  value = (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+          ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+
+  return true;
+}
+
+uint32_t HashSchema(const libcomp::PersistentObject& obj) {
+  std::stringstream ss;
+
+  if (!obj.GetObjectMetadata()->Save(ss)) {
+    return 0;
+  }
+
+  std::string schema = ss.str();
+
+  // 32-bit FNV-1a over the serialized object metadata
+  uint32_t hash = 2166136261U;
+
+  for (char c : schema) {
+    hash ^= (uint32_t)(unsigned char)c;
+    hash *= 16777619U;
+  }
+
+  return hash;
+}
+
+uint32_t GetSchemaHash(std::unordered_map<std::string, uint32_t>& hashes,
+                       const std::string& objectType,
+                       const libcomp::PersistentObject& obj) {
+  auto it = hashes.find(objectType);
+
+  if (hashes.end() != it) {
+    return it->second;
+  }
+
+  uint32_t hash = HashSchema(obj);
+  hashes[objectType] = hash;
+
+  return hash;
+}
+
+bool ReadString(std::istream& in, std::string& value) {
+  uint16_t size = 0;
+
+  if (!ReadU16(in, size)) {
+    return false;
+  }
+
+  value.resize(size);
+
+  return 0 == size || in.read(&value[0], size);
+}
+
+}  // namespace
+
+AccountDumpWriter::AccountDumpWriter(std::ostream& out)
+    : mStream(out), mStarted(false), mFinished(false), mObjectCount(0) {}
+
+AccountDumpWriter::~AccountDumpWriter() {}
+
+bool AccountDumpWriter::WriteObject(
+    const std::shared_ptr<libcomp::PersistentObject>& obj) {
+  if (!obj) {
+    return false;
+  }
+
+  return WriteObject(obj, obj->GetUUID());
+}
+
+bool AccountDumpWriter::WriteObject(
+    const std::shared_ptr<libcomp::PersistentObject>& obj,
+    const libobjgen::UUID& uuid) {
+  if (!obj || mFinished || !WriteHeader()) {
+    return false;
+  }
+
+  if (uuid.IsNull()) {
+    return false;
+  }
+
+  mBuffer.str(std::string());
+  mBuffer.clear();
+
+  if (!obj->Save(mBuffer)) {
+    return false;
+  }
+
+  std::string payload = mBuffer.str();
+  std::string objectType = obj->GetObjectMetadata()->GetName();
+
+  WriteString(mStream, objectType);
+  WriteU32(mStream, GetSchemaHash(mSchemaHashes, objectType, *obj));
+  WriteString(mStream, uuid.ToString());
+  WriteU32(mStream, (uint32_t)payload.size());
+  mStream.write(payload.c_str(), (std::streamsize)payload.size());
+
+  if (!mStream.good()) {
+    return false;
+  }
+
+  mObjectCount++;
+
+  return true;
+}
+
+bool AccountDumpWriter::Finish() {
+  if (mFinished) {
+    return true;
+  }
+
+  if (!WriteHeader()) {
+    return false;
+  }
+
+  // An empty object type marks the end of the dump.
+  WriteU16(mStream, 0);
+  mStream.flush();
+
+  mFinished = true;
+
+  return mStream.good();
+}
+
+uint32_t AccountDumpWriter::GetObjectCount() const { return mObjectCount; }
+
+bool AccountDumpWriter::WriteHeader() {
+  if (!mStarted) {
+    mStream.write(ACCOUNT_DUMP_MAGIC, ACCOUNT_DUMP_MAGIC_SIZE);
+    WriteU16(mStream, ACCOUNT_DUMP_VERSION);
+
+    mStarted = true;
+  }
+
+  return mStream.good();
+}
+
+AccountDumpReader::AccountDumpReader(std::istream& in)
+    : mStream(in), mStarted(false), mFinished(false) {}
+
+AccountDumpReader::~AccountDumpReader() {}
+
+bool AccountDumpReader::ReadObject(
+    libcomp::String& objectType, libobjgen::UUID& uuid,
+    std::shared_ptr<libcomp::PersistentObject>& obj) {
+  if (mFinished || !mError.IsEmpty() || !ReadHeader()) {
+    return false;
+  }
+
+  std::string typeName;
+
+  if (!ReadString(mStream, typeName)) {
+    mError = "Account dump is truncated.";
+
+    return false;
+  }
+
+  if (typeName.empty()) {
+    mFinished = true;
+
+    return false;
+  }
+
+  objectType = typeName;
+
+  auto typeExists = false;
+  auto typeHash =
+      libcomp::PersistentObject::GetTypeHashByName(typeName, typeExists);
+
+  if (!typeExists) {
+    mError = libcomp::String("Failed to parse unknown object '%1'.")
+                 .Arg(objectType);
+
+    return false;
+  }
+
+  std::string uuidText;
+  uint32_t schemaHash = 0;
+  uint32_t payloadSize = 0;
+
+  if (!ReadU32(mStream, schemaHash) || !ReadString(mStream, uuidText) ||
+      !ReadU32(mStream, payloadSize)) {
+    mError = "Account dump is truncated.";
+
+    return false;
+  }
+
+  uuid = libobjgen::UUID(uuidText);
+
+  // Make sure every object has a UUID.
+  if (uuid.IsNull()) {
+    mError = libcomp::String("Bad UUID '%1' for object '%2'")
+                 .Arg(uuidText)
+                 .Arg(objectType);
+
+    return false;
+  }
+
+  if (ACCOUNT_DUMP_MAX_OBJECT_SIZE < payloadSize) {
+    mError = libcomp::String("Object '%1' with UUID %2 is too large.")
+                 .Arg(objectType)
+                 .Arg(uuidText);
+
+    return false;
+  }
+
+  mBuffer.resize(payloadSize);
+
+  if (0 != payloadSize && !mStream.read(&mBuffer[0], payloadSize)) {
+    mError = "Account dump is truncated.";
+
+    return false;
+  }
+
+  obj = libcomp::PersistentObject::New(typeHash);
+
+  if (!obj) {
+    mError = libcomp::String("Failed to load object '%1' with UUID %2.")
+                 .Arg(objectType)
+                 .Arg(uuidText);
+
+    return false;
+  }
+
+  // The binary serialization has no field names so it can only be loaded
+  // by the same version of the object it was written with.
+  if (GetSchemaHash(mSchemaHashes, typeName, *obj) != schemaHash) {
+    mError = libcomp::String("Object '%1' with UUID %2 was dumped by a "
+                             "server with a different version of the "
+                             "object.")
+                 .Arg(objectType)
+                 .Arg(uuidText);
+
+    return false;
+  }
+
+  MemoryInStream ss(mBuffer);
+
+  if (!obj->Load(ss)) {
+    mError = libcomp::String("Failed to load object '%1' with UUID %2.")
+                 .Arg(objectType)
+                 .Arg(uuidText);
+
+    return false;
+  }
+
+  return true;
+}
+
+libcomp::String AccountDumpReader::GetError() const { return mError; }
+
+bool AccountDumpReader::IsAccountDump(const char* pData, size_t dataSize) {
+  return pData && ACCOUNT_DUMP_MAGIC_SIZE <= dataSize &&
+         0 == memcmp(pData, ACCOUNT_DUMP_MAGIC, ACCOUNT_DUMP_MAGIC_SIZE);
+}
+
+libcomp::String AccountDumpReader::ConvertToXml(std::istream& in,
+                                                std::ostream& out) {
+  AccountDumpReader reader(in);
+
+  libcomp::String objectType;
+  libobjgen::UUID uuid;
+  std::shared_ptr<libcomp::PersistentObject> obj;
+
+  out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << std::endl
+      << "<objects>" << std::endl;
+
+  while (reader.ReadObject(objectType, uuid, obj)) {
+    // Each object gets a small DOM of its own so only one object is ever
+    // held in memory at a time.
+    tinyxml2::XMLDocument doc;
+
+    tinyxml2::XMLElement* pRoot = doc.NewElement("objects");
+    doc.InsertEndChild(pRoot);
+
+    if (!obj->Save(doc, *pRoot)) {
+      return libcomp::String("Failed to convert object '%1' with UUID %2.")
+          .Arg(objectType)
+          .Arg(uuid.ToString());
+    }
+
+    tinyxml2::XMLElement* pObject = pRoot->LastChildElement("object");
+
+    if (!pObject) {
+      return libcomp::String("Failed to convert object '%1' with UUID %2.")
+          .Arg(objectType)
+          .Arg(uuid.ToString());
+    }
+
+    tinyxml2::XMLElement* pMember = doc.NewElement("member");
+    pMember->SetAttribute("name", "UUID");
+    pMember->InsertEndChild(doc.NewText(uuid.ToString().c_str()));
+    pObject->InsertFirstChild(pMember);
+
+    tinyxml2::XMLPrinter printer;
+    pObject->Accept(&printer);
+
+    out << printer.CStr();
+  }
+
+  if (!reader.GetError().IsEmpty()) {
+    return reader.GetError();
+  }
+
+  out << "</objects>" << std::endl;
+
+  if (!out.good()) {
+    return "Failed to write XML account dump.";
+  }
+
+  return {};
+}
+
+bool AccountDumpReader::ReadHeader() {
+  if (mStarted) {
+    return true;
+  }
+
+  char magic[ACCOUNT_DUMP_MAGIC_SIZE];
+  uint16_t version = 0;
+
+  if (!mStream.read(magic, ACCOUNT_DUMP_MAGIC_SIZE) ||
+      !IsAccountDump(magic, ACCOUNT_DUMP_MAGIC_SIZE) ||
+      !ReadU16(mStream, version)) {
+    mError = "Data is not a binary account dump.";
+
+    return false;
+  }
+
+  if (ACCOUNT_DUMP_VERSION != version) {
+    mError = libcomp::String("Unsupported account dump version %1.")
+                 .Arg(version);
+
+    return false;
+  }
+
+  mStarted = true;
+
+  return true;
+}
@@ -0,0 +1,202 @@
+/**
+ * @file libhack/src/AccountDump.h
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Streaming reader and writer for binary account dumps.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHACK_SRC_ACCOUNTDUMP_H
+#define LIBHACK_SRC_ACCOUNTDUMP_H
+
+// Standard C++11 Includes
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+
+// libcomp Includes
+#include <CString.h>
+#include <PersistentObject.h>
+
+namespace libhack {
+
+/**
+ * Writes persistent objects to a binary account dump one at a time. The
+ * dump starts with a magic value and format version followed by one
+ * record per object: the object type name, a hash of the object schema,
+ * the object UUID and the length prefixed binary serialization of the
+ * object. The schema hash lets the reader reject objects written by a
+ * server with a different version of the object. A record with an
+ * empty type name marks the end of the dump. Only the object currently
+ * being written is ever buffered so the memory used does not depend on
+ * the size of the account.
+ */
+class AccountDumpWriter {
+ public:
+  /**
+   * Create a new writer.
+   * @param out Stream to write the dump to
+   */
+  explicit AccountDumpWriter(std::ostream& out);
+
+  /**
+   * Clean up the writer.
+   */
+  ~AccountDumpWriter();
+
+  /**
+   * Write an object to the dump. The header is written before the first
+   * object.
+   * @param obj Registered persistent object to write
+   * @return true if the object was written, false on error
+   */
+  bool WriteObject(const std::shared_ptr<libcomp::PersistentObject>& obj);
+
+  /**
+   * Write an object to the dump under a given UUID. This allows an
+   * unregistered copy of a registered object to be written in its place.
+   * @param obj Persistent object to write
+   * @param uuid UUID to write the object with
+   * @return true if the object was written, false on error
+   */
+  bool WriteObject(const std::shared_ptr<libcomp::PersistentObject>& obj,
+                   const libobjgen::UUID& uuid);
+
+  /**
+   * Write the end of dump marker. No more objects may be written after.
+   * @return true if the dump was completed, false on error
+   */
+  bool Finish();
+
+  /**
+   * Get the number of objects written so far.
+   * @return Number of objects written
+   */
+  uint32_t GetObjectCount() const;
+
+ private:
+  /**
+   * Write the dump header if it has not been written yet.
+   * @return true if the header is written, false on error
+   */
+  bool WriteHeader();
+
+  /// Stream the dump is written to
+  std::ostream& mStream;
+
+  /// Reused buffer holding the serialization of the current object
+  std::stringstream mBuffer;
+
+  /// Indicates if the header has been written
+  bool mStarted;
+
+  /// Indicates if the end of dump marker has been written
+  bool mFinished;
+
+  /// Number of objects written so far
+  uint32_t mObjectCount;
+
+  /// Schema hash of each object type written so far
+  std::unordered_map<std::string, uint32_t> mSchemaHashes;
+};
+
+/**
+ * Reads persistent objects back from a binary account dump written by
+ * @ref AccountDumpWriter one at a time.
+ */
+class AccountDumpReader {
+ public:
+  /**
+   * Create a new reader.
+   * @param in Stream to read the dump from
+   */
+  explicit AccountDumpReader(std::istream& in);
+
+  /**
+   * Clean up the reader.
+   */
+  ~AccountDumpReader();
+
+  /**
+   * Read the next object from the dump. The object is loaded but not
+   * registered.
+   * @param objectType Output type name of the object
+   * @param uuid Output UUID of the object
+   * @param obj Output object that was read
+   * @return true if an object was read, false at the end of the dump or
+   *  on error (check @ref GetError to tell them apart)
+   */
+  bool ReadObject(libcomp::String& objectType, libobjgen::UUID& uuid,
+                  std::shared_ptr<libcomp::PersistentObject>& obj);
+
+  /**
+   * Get the error that stopped the reader.
+   * @return Error string or an empty string if no error occurred
+   */
+  libcomp::String GetError() const;
+
+  /**
+   * Check if the data starts with the binary account dump magic.
+   * @param pData Pointer to the data to check
+   * @param dataSize Size of the data to check
+   * @return true if the data is a binary account dump
+   */
+  static bool IsAccountDump(const char* pData, size_t dataSize);
+
+  /**
+   * Convert a binary account dump into the XML account dump format.
+   * Objects are converted one at a time.
+   * @param in Stream to read the binary dump from
+   * @param out Stream to write the XML dump to
+   * @return Error string or an empty string on success
+   */
+  static libcomp::String ConvertToXml(std::istream& in, std::ostream& out);
+
+ private:
+  /**
+   * Read and check the dump header if it has not been read yet.
+   * @return true if the header is valid, false on error
+   */
+  bool ReadHeader();
+
+  /// Stream the dump is read from
+  std::istream& mStream;
+
+  /// Reused buffer holding the serialization of the current object
+  std::string mBuffer;
+
+  /// Indicates if the header has been read
+  bool mStarted;
+
+  /// Indicates if the end of dump marker has been read
+  bool mFinished;
+
+  /// Error that stopped the reader
+  libcomp::String mError;
+
+  /// Schema hash of each object type read so far
+  std::unordered_map<std::string, uint32_t> mSchemaHashes;
+};
+
+}  // namespace libhack
+
+#endif  // LIBHACK_SRC_ACCOUNTDUMP_H
@@ -0,0 +1,129 @@
+/**
+ * @file libhack/src/DefinitionIndex.h
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Flat ID indexed lookup table for frequently used definitions.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHACK_SRC_DEFINITIONINDEX_H
+#define LIBHACK_SRC_DEFINITIONINDEX_H
+
+// Standard C++11 Includes
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace libhack {
+
+/**
+ * Read-only lookup table of definitions by ID built from a definition map
+ * once loading is complete. When the IDs are close enough together the
+ * table is a vector indexed directly by ID. Otherwise it is a vector of
+ * pairs sorted by ID and searched with a binary search. Either way a
+ * lookup returns a raw pointer without touching the reference count of
+ * the definition, which stays owned by the map it was built from.
+ */
+template <typename T>
+class DefinitionIndex {
+ public:
+  /**
+   * Create an empty index.
+   */
+  DefinitionIndex() : mBuilt(false) {}
+
+  /**
+   * Build the index from a definition map. The map must outlive the
+   * index and must not change until the index is built again.
+   * @param data Map of definitions by ID to index
+   */
+  void Build(const std::unordered_map<uint32_t, std::shared_ptr<T>>& data) {
+    mDense.clear();
+    mSparse.clear();
+
+    uint32_t maxID = 0;
+    for (auto& pair : data) {
+      maxID = std::max(maxID, pair.first);
+    }
+
+    // Only use a dense table if most of it would be filled. Sparse ID
+    // ranges such as item IDs would waste too much memory otherwise.
+    if (!data.empty() &&
+        (size_t)maxID < std::max<size_t>(data.size() * 4, 1024)) {
+      mDense.resize((size_t)maxID + 1, nullptr);
+
+      for (auto& pair : data) {
+        mDense[pair.first] = pair.second.get();
+      }
+    } else {
+      mSparse.reserve(data.size());
+
+      for (auto& pair : data) {
+        mSparse.push_back(std::make_pair(pair.first, pair.second.get()));
+      }
+
+      std::sort(mSparse.begin(), mSparse.end());
+    }
+
+    mBuilt = true;
+  }
+
+  /**
+   * Check if the index has been built.
+   * @return true if the index has been built
+   */
+  bool IsBuilt() const { return mBuilt; }
+
+  /**
+   * Get a definition by ID.
+   * @param id ID of the definition to retrieve
+   * @return Pointer to the definition or null if it does not exist
+   */
+  const T* Get(uint32_t id) const {
+    if (!mDense.empty()) {
+      return (size_t)id < mDense.size() ? mDense[id] : nullptr;
+    }
+
+    auto it = std::lower_bound(
+        mSparse.begin(), mSparse.end(), id,
+        [](const std::pair<uint32_t, const T*>& entry, uint32_t value) {
+          return entry.first < value;
+        });
+
+    return (it != mSparse.end() && it->first == id) ? it->second : nullptr;
+  }
+
+ private:
+  /// Definitions indexed directly by ID
+  std::vector<const T*> mDense;
+
+  /// Definitions sorted by ID when they are too sparse to index directly
+  std::vector<std::pair<uint32_t, const T*>> mSparse;
+
+  /// Indicates the index has been built
+  bool mBuilt;
+};
+
+}  // namespace libhack
+
+#endif  // LIBHACK_SRC_DEFINITIONINDEX_H
@@ -112,6 +112,16 @@
 #include <QmpFile.h>
 #include <Tokusei.h>
 
+// Standard C++11 Includes
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+#ifndef EXOTIC_PLATFORM
+#include <thread>
+#endif  // !EXOTIC_PLATFORM
+
 using namespace libcomp;
 using namespace libhack;
 
@@ -197,6 +207,11 @@ std::shared_ptr<objects::MiDevilData> DefinitionManager::GetDevilData(
   return GetRecordByID(id, mDevilData);
 }
 
+const objects::MiDevilData *DefinitionManager::GetDevilDataPtr(
+    uint32_t id) const {
+  return GetRecordPtrByID(id, mDevilIndex, mDevilData);
+}
+
 const std::shared_ptr<objects::MiDevilData> DefinitionManager::GetDevilData(
     const libcomp::String &name) {
   auto iter = mDevilNameLookup.find(name);
@@ -400,6 +415,11 @@ const std::shared_ptr<objects::MiItemData> DefinitionManager::GetItemData(
   return GetRecordByID(id, mItemData);
 }
 
+const objects::MiItemData *DefinitionManager::GetItemDataPtr(
+    uint32_t id) const {
+  return GetRecordPtrByID(id, mItemIndex, mItemData);
+}
+
 const std::shared_ptr<objects::MiMissionData> DefinitionManager::GetMissionData(
     uint32_t id) {
   return GetRecordByID(id, mMissionData);
@@ -530,6 +550,16 @@ const std::shared_ptr<objects::MiSkillData> DefinitionManager::GetSkillData(
   return GetRecordByID(id, mSkillData);
 }
 
+const objects::MiSkillData *DefinitionManager::GetSkillDataPtr(
+    uint32_t id) const {
+  return GetRecordPtrByID(id, mSkillIndex, mSkillData);
+}
+
+const std::unordered_map<uint32_t, std::shared_ptr<objects::MiSkillData>>
+DefinitionManager::GetAllSkillData() {
+  return mSkillData;
+}
+
 std::set<uint32_t> DefinitionManager::GetFunctionIDSkills(uint16_t fid) const {
   auto it = mFunctionIDSkills.find(fid);
   return it != mFunctionIDSkills.end() ? it->second : std::set<uint32_t>();
@@ -562,6 +592,11 @@ const std::shared_ptr<objects::MiStatusData> DefinitionManager::GetStatusData(
   return GetRecordByID(id, mStatusData);
 }
 
+const objects::MiStatusData *DefinitionManager::GetStatusDataPtr(
+    uint32_t id) const {
+  return GetRecordPtrByID(id, mStatusIndex, mStatusData);
+}
+
 const std::shared_ptr<objects::MiSynthesisData>
 DefinitionManager::GetSynthesisData(uint32_t id) {
   return GetRecordByID(id, mSynthesisData);
@@ -1622,66 +1657,143 @@ bool DefinitionManager::LoadData<objects::MiZoneData>(DataStore *pDataStore) {
 bool DefinitionManager::LoadAllData(DataStore *pDataStore) {
   LogDefinitionManagerInfoMsg("Loading binary data definitions...\n");
 
-  bool success = true;
-  success &= LoadData<objects::MiAIData>(pDataStore);
-  success &= LoadData<objects::MiBlendData>(pDataStore);
-  success &= LoadData<objects::MiBlendExtData>(pDataStore);
-  success &= LoadData<objects::MiCHouraiData>(pDataStore);
-  success &= LoadData<objects::MiCItemData>(pDataStore);
-  success &= LoadData<objects::MiCultureItemData>(pDataStore);
-  success &= LoadData<objects::MiDevilData>(pDataStore);
-  success &= LoadData<objects::MiDevilBookData>(pDataStore);
-  success &= LoadData<objects::MiDevilBoostData>(pDataStore);
-  success &= LoadData<objects::MiDevilBoostExtraData>(pDataStore);
-  success &= LoadData<objects::MiDevilBoostItemData>(pDataStore);
-  success &= LoadData<objects::MiDevilBoostLotData>(pDataStore);
-  success &= LoadData<objects::MiDevilEquipmentData>(pDataStore);
-  success &= LoadData<objects::MiDevilEquipmentItemData>(pDataStore);
-  success &= LoadData<objects::MiDevilFusionData>(pDataStore);
-  success &= LoadData<objects::MiDevilLVUpRateData>(pDataStore);
-  success &= LoadData<objects::MiDisassemblyData>(pDataStore);
-  success &= LoadData<objects::MiDisassemblyTriggerData>(pDataStore);
-  success &= LoadData<objects::MiDynamicMapData>(pDataStore);
-  success &= LoadData<objects::MiEnchantData>(pDataStore);
-  success &= LoadData<objects::MiEquipmentSetData>(pDataStore);
-  success &= LoadData<objects::MiExchangeData>(pDataStore);
-  success &= LoadData<objects::MiExpertData>(pDataStore);
-  success &= LoadData<objects::MiGuardianAssistData>(pDataStore);
-  success &= LoadData<objects::MiGuardianLevelData>(pDataStore);
-  success &= LoadData<objects::MiGuardianSpecialData>(pDataStore);
-  success &= LoadData<objects::MiGuardianUnlockData>(pDataStore);
-  success &= LoadData<objects::MiHNPCData>(pDataStore);
-  success &= LoadData<objects::MiItemData>(pDataStore);
-  success &= LoadData<objects::MiMissionData>(pDataStore);
-  success &= LoadData<objects::MiMitamaReunionBonusData>(pDataStore);
-  success &= LoadData<objects::MiMitamaReunionSetBonusData>(pDataStore);
-  success &= LoadData<objects::MiMitamaUnionBonusData>(pDataStore);
-  success &= LoadData<objects::MiModificationData>(pDataStore);
-  success &= LoadData<objects::MiModificationExtEffectData>(pDataStore);
-  success &= LoadData<objects::MiModificationExtRecipeData>(pDataStore);
-  success &= LoadData<objects::MiModificationTriggerData>(pDataStore);
-  success &= LoadData<objects::MiModifiedEffectData>(pDataStore);
-  success &= LoadData<objects::MiNPCBarterData>(pDataStore);
-  success &= LoadData<objects::MiNPCBarterConditionData>(pDataStore);
-  success &= LoadData<objects::MiNPCBarterGroupData>(pDataStore);
-  success &= LoadData<objects::MiONPCData>(pDataStore);
-  success &= LoadData<objects::MiQuestBonusCodeData>(pDataStore);
-  success &= LoadData<objects::MiQuestData>(pDataStore);
-  success &= LoadData<objects::MiShopProductData>(pDataStore);
-  success &= LoadData<objects::MiSItemData>(pDataStore);
-  success &= LoadData<objects::MiSkillData>(pDataStore);
-  success &= LoadData<objects::MiStatusData>(pDataStore);
-  success &= LoadData<objects::MiSynthesisData>(pDataStore);
-  success &= LoadData<objects::MiTankData>(pDataStore);
-  success &= LoadData<objects::MiTimeLimitData>(pDataStore);
-  success &= LoadData<objects::MiTitleData>(pDataStore);
-  success &= LoadData<objects::MiTriUnionSpecialData>(pDataStore);
-  success &= LoadData<objects::MiUltimateBattleBaseData>(pDataStore);
-  success &= LoadData<objects::MiUraFieldTowerData>(pDataStore);
-  success &= LoadData<objects::MiWarpPointData>(pDataStore);
-  success &= LoadData<objects::MiZoneData>(pDataStore);
+  auto start = std::chrono::steady_clock::now();
+
+  // Every file only populates its own lookups so they can be decrypted,
+  // parsed and indexed at the same time. The largest files are listed
+  // first so the total time is bound by the slowest file rather than the
+  // sum of them all.
+  std::list<std::function<bool()>> loads = {
+      [&]() { return LoadData<objects::MiSkillData>(pDataStore); },
+      [&]() { return LoadData<objects::MiDevilData>(pDataStore); },
+      [&]() { return LoadData<objects::MiItemData>(pDataStore); },
+      [&]() { return LoadData<objects::MiDynamicMapData>(pDataStore); },
+      [&]() { return LoadData<objects::MiZoneData>(pDataStore); },
+      [&]() { return LoadData<objects::MiStatusData>(pDataStore); },
+      [&]() { return LoadData<objects::MiQuestData>(pDataStore); },
+      [&]() { return LoadData<objects::MiONPCData>(pDataStore); },
+      [&]() { return LoadData<objects::MiHNPCData>(pDataStore); },
+      [&]() { return LoadData<objects::MiSItemData>(pDataStore); },
+      [&]() { return LoadData<objects::MiCItemData>(pDataStore); },
+      [&]() { return LoadData<objects::MiAIData>(pDataStore); },
+      [&]() { return LoadData<objects::MiBlendData>(pDataStore); },
+      [&]() { return LoadData<objects::MiBlendExtData>(pDataStore); },
+      [&]() { return LoadData<objects::MiCHouraiData>(pDataStore); },
+      [&]() { return LoadData<objects::MiCultureItemData>(pDataStore); },
+      [&]() { return LoadData<objects::MiDevilBookData>(pDataStore); },
+      [&]() { return LoadData<objects::MiDevilBoostData>(pDataStore); },
+      [&]() { return LoadData<objects::MiDevilBoostExtraData>(pDataStore); },
+      [&]() { return LoadData<objects::MiDevilBoostItemData>(pDataStore); },
+      [&]() { return LoadData<objects::MiDevilBoostLotData>(pDataStore); },
+      [&]() { return LoadData<objects::MiDevilEquipmentData>(pDataStore); },
+      [&]() { return LoadData<objects::MiDevilEquipmentItemData>(pDataStore); },
+      [&]() { return LoadData<objects::MiDevilFusionData>(pDataStore); },
+      [&]() { return LoadData<objects::MiDevilLVUpRateData>(pDataStore); },
+      [&]() { return LoadData<objects::MiDisassemblyData>(pDataStore); },
+      [&]() { return LoadData<objects::MiDisassemblyTriggerData>(pDataStore); },
+      [&]() { return LoadData<objects::MiEnchantData>(pDataStore); },
+      [&]() { return LoadData<objects::MiEquipmentSetData>(pDataStore); },
+      [&]() { return LoadData<objects::MiExchangeData>(pDataStore); },
+      [&]() { return LoadData<objects::MiExpertData>(pDataStore); },
+      [&]() { return LoadData<objects::MiGuardianAssistData>(pDataStore); },
+      [&]() { return LoadData<objects::MiGuardianLevelData>(pDataStore); },
+      [&]() { return LoadData<objects::MiGuardianSpecialData>(pDataStore); },
+      [&]() { return LoadData<objects::MiGuardianUnlockData>(pDataStore); },
+      [&]() { return LoadData<objects::MiMissionData>(pDataStore); },
+      [&]() { return LoadData<objects::MiMitamaReunionBonusData>(pDataStore); },
+      [&]() {
+        return LoadData<objects::MiMitamaReunionSetBonusData>(pDataStore);
+      },
+      [&]() { return LoadData<objects::MiMitamaUnionBonusData>(pDataStore); },
+      [&]() { return LoadData<objects::MiModificationData>(pDataStore); },
+      [&]() {
+        return LoadData<objects::MiModificationExtEffectData>(pDataStore);
+      },
+      [&]() {
+        return LoadData<objects::MiModificationExtRecipeData>(pDataStore);
+      },
+      [&]() {
+        return LoadData<objects::MiModificationTriggerData>(pDataStore);
+      },
+      [&]() { return LoadData<objects::MiModifiedEffectData>(pDataStore); },
+      [&]() { return LoadData<objects::MiNPCBarterData>(pDataStore); },
+      [&]() { return LoadData<objects::MiNPCBarterConditionData>(pDataStore); },
+      [&]() { return LoadData<objects::MiNPCBarterGroupData>(pDataStore); },
+      [&]() { return LoadData<objects::MiQuestBonusCodeData>(pDataStore); },
+      [&]() { return LoadData<objects::MiShopProductData>(pDataStore); },
+      [&]() { return LoadData<objects::MiSynthesisData>(pDataStore); },
+      [&]() { return LoadData<objects::MiTankData>(pDataStore); },
+      [&]() { return LoadData<objects::MiTimeLimitData>(pDataStore); },
+      [&]() { return LoadData<objects::MiTitleData>(pDataStore); },
+      [&]() { return LoadData<objects::MiTriUnionSpecialData>(pDataStore); },
+      [&]() { return LoadData<objects::MiUltimateBattleBaseData>(pDataStore); },
+      [&]() { return LoadData<objects::MiUraFieldTowerData>(pDataStore); },
+      [&]() { return LoadData<objects::MiWarpPointData>(pDataStore); },
+  };
+
+  std::mutex loadLock;
+  std::atomic<bool> success(true);
+
+  auto loadNext = [&]() {
+    while (true) {
+      std::function<bool()> load;
+
+      {
+        std::lock_guard<std::mutex> lock(loadLock);
+
+        if (loads.empty()) {
+          return;
+        }
+
+        load = loads.front();
+        loads.pop_front();
+      }
+
+      if (!load()) {
+        success = false;
+      }
+    }
+  };
+
+#ifndef EXOTIC_PLATFORM
+  size_t threadCount = std::max<size_t>(
+      1, std::min<size_t>(std::thread::hardware_concurrency(), loads.size()));
+
+  std::list<std::thread> threads;
+
+  for (size_t i = 1; i < threadCount; i++) {
+    threads.push_back(std::thread(loadNext));
+  }
+#endif  // !EXOTIC_PLATFORM
+
+  // Work on the current thread too.
+  loadNext();
+
+#ifndef EXOTIC_PLATFORM
+  for (auto &thread : threads) {
+    thread.join();
+  }
+#endif  // !EXOTIC_PLATFORM
+
+  LogDefinitionManagerInfo([&]() {
+    return libcomp::String("Loaded binary data definitions in %1 ms.\n")
+        .Arg((int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::steady_clock::now() - start)
+                 .count());
+  });
+
+  if (mSnapshot) {
+    if (success) {
+      mSnapshot->Save();
+    }
+
+    // Nothing refers to the mapped snapshot once loading is done.
+    mSnapshot.reset();
+  }
 
   if (success) {
+    BuildIndexes();
+
     LogDefinitionManagerInfoMsg("Definition loading complete.\n");
   } else {
     LogDefinitionManagerCriticalMsg("Definition loading failed.\n");
@@ -1690,6 +1802,13 @@ bool DefinitionManager::LoadAllData(DataStore *pDataStore) {
   return success;
 }
 
+void DefinitionManager::BuildIndexes() {
+  mDevilIndex.Build(mDevilData);
+  mItemIndex.Build(mItemData);
+  mSkillIndex.Build(mSkillData);
+  mStatusIndex.Build(mStatusData);
+}
+
 namespace libhack {
 template <>
 bool DefinitionManager::RegisterServerSideDefinition<objects::EnchantSetData>(
@@ -1788,7 +1907,7 @@ std::shared_ptr<objects::QmpFile> DefinitionManager::LoadQmpFile(
     return nullptr;
   }
 
-  std::stringstream ss(std::string(data.begin(), data.end()));
+  MemoryInStream ss(data);
 
   uint32_t magic;
   ss.read(reinterpret_cast<char *>(&magic), sizeof(magic));
@@ -1805,6 +1924,42 @@ std::shared_ptr<objects::QmpFile> DefinitionManager::LoadQmpFile(
   return file;
 }
 
+void DefinitionManager::SetSnapshotPath(const libcomp::String &path,
+                                        bool verify) {
+  mSnapshot = std::make_shared<DefinitionSnapshot>(path, verify);
+}
+
+bool DefinitionManager::ReadBinaryData(DataStore *pDataStore,
+                                       const libcomp::String &binaryFile,
+                                       bool decrypt, std::vector<char> &data,
+                                       const char *&pData, size_t &dataSize) {
+  auto path = libcomp::String("/BinaryData/") + binaryFile;
+
+  DefinitionSnapshot::Source source;
+
+  if (decrypt && mSnapshot && DefinitionSnapshot::GetSource(path, source)) {
+    // Only skip decryption if the encrypted file is unchanged.
+    if (mSnapshot->GetFile(binaryFile, source, pData, dataSize)) {
+      return true;
+    }
+
+    data = pDataStore->DecryptFile(path);
+
+    if (!data.empty()) {
+      mSnapshot->AddFile(binaryFile, source, data);
+    }
+  } else if (decrypt) {
+    data = pDataStore->DecryptFile(path);
+  } else {
+    data = pDataStore->ReadFile(path);
+  }
+
+  pData = data.data();
+  dataSize = data.size();
+
+  return !data.empty();
+}
+
 bool DefinitionManager::LoadBinaryDataHeader(libcomp::ObjectInStream &ois,
                                              const libcomp::String &binaryFile,
                                              uint16_t tablesExpected,
@@ -1833,22 +1988,30 @@ bool DefinitionManager::LoadBinaryDataHeader(libcomp::ObjectInStream &ois,
   return true;
 }
 
-void DefinitionManager::PrintLoadResult(const libcomp::String &binaryFile,
-                                        bool success, uint16_t entriesExpected,
-                                        size_t loadedEntries) {
+void DefinitionManager::PrintLoadResult(
+    const libcomp::String &binaryFile, bool success, uint16_t entriesExpected,
+    size_t loadedEntries, const std::chrono::steady_clock::time_point &start) {
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+
   if (success) {
     LogDefinitionManagerInfo([&]() {
-      return libcomp::String("Successfully loaded %1/%2 records from %3.\n")
+      return libcomp::String(
+                 "Successfully loaded %1/%2 records from %3 in %4 ms.\n")
           .Arg(loadedEntries)
           .Arg(entriesExpected)
-          .Arg(binaryFile);
+          .Arg(binaryFile)
+          .Arg((int64_t)elapsed);
     });
   } else {
     LogDefinitionManagerError([&]() {
-      return libcomp::String("Failed after loading %1/%2 records from %3.\n")
+      return libcomp::String(
+                 "Failed after loading %1/%2 records from %3 in %4 ms.\n")
           .Arg(loadedEntries)
           .Arg(entriesExpected)
-          .Arg(binaryFile);
+          .Arg(binaryFile)
+          .Arg((int64_t)elapsed);
     });
   }
 }
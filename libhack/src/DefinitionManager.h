@@ -34,7 +34,14 @@
 #include "MiCorrectTbl.h"
 #include "Object.h"
 
+// libhack Includes
+#include "DefinitionIndex.h"
+#include "DefinitionSnapshot.h"
+#include "MemoryAccounting.h"
+#include "MemoryStream.h"
+
 // Standard C++11 Includes
+#include <chrono>
 #include <set>
 #include <unordered_map>
 
@@ -220,6 +227,16 @@ class DefinitionManager {
    */
   std::shared_ptr<objects::MiDevilData> GetDevilData(uint32_t id);
 
+  /**
+   * Get the devil definition corresponding to an ID without copying the
+   * shared pointer. Meant for frequently called code; the definition is
+   * valid for as long as the definition manager.
+   * @param id Devil ID to retrieve
+   * @return Pointer to the matching devil definition, null if it does
+   *  not exist
+   */
+  const objects::MiDevilData* GetDevilDataPtr(uint32_t id) const;
+
   /**
    * Get a devil definition corresponding to a name
    * @param name Devil name to retrieve
@@ -456,6 +473,16 @@ class DefinitionManager {
    */
   const std::shared_ptr<objects::MiItemData> GetItemData(uint32_t id);
 
+  /**
+   * Get the item definition corresponding to an ID without copying the
+   * shared pointer. Meant for frequently called code; the definition is
+   * valid for as long as the definition manager.
+   * @param id Item ID to retrieve
+   * @return Pointer to the matching item definition, null if it does
+   *  not exist
+   */
+  const objects::MiItemData* GetItemDataPtr(uint32_t id) const;
+
   /**
    * Get the item definition corresponding to a name
    * @param name Item name to retrieve
@@ -640,6 +667,23 @@ class DefinitionManager {
    */
   const std::shared_ptr<objects::MiSkillData> GetSkillData(uint32_t id);
 
+  /**
+   * Get the skill definition corresponding to an ID without copying the
+   * shared pointer. Meant for frequently called code; the definition is
+   * valid for as long as the definition manager.
+   * @param id Skill ID to retrieve
+   * @return Pointer to the matching skill definition, null if it does
+   *  not exist
+   */
+  const objects::MiSkillData* GetSkillDataPtr(uint32_t id) const;
+
+  /**
+   * Get all skill definitions by ID
+   * @return Map of all skill definitions by ID
+   */
+  const std::unordered_map<uint32_t, std::shared_ptr<objects::MiSkillData>>
+  GetAllSkillData();
+
   /**
    * Get all skill definition IDs that are mapped to the supplied function ID
    * @param fid Skill function ID
@@ -671,6 +715,16 @@ class DefinitionManager {
    */
   const std::shared_ptr<objects::MiStatusData> GetStatusData(uint32_t id);
 
+  /**
+   * Get the status definition corresponding to an ID without copying the
+   * shared pointer. Meant for frequently called code; the definition is
+   * valid for as long as the definition manager.
+   * @param id Status ID to retrieve
+   * @return Pointer to the matching status definition, null if it does
+   *  not exist
+   */
+  const objects::MiStatusData* GetStatusDataPtr(uint32_t id) const;
+
   /**
    * Get the synthesis definition corresponding to an ID
    * @param id Synthesis ID to retrieve
@@ -811,12 +865,24 @@ class DefinitionManager {
   GetAllTokuseiData();
 
   /**
-   * Load all binary data definitions
+   * Load all binary data definitions. Each file only populates its own
+   * lookups so the files are decrypted, parsed and indexed in parallel.
    * @param pDataStore Pointer to the datastore to load binary files from
    * @return true on success, false on failure
    */
   bool LoadAllData(libcomp::DataStore* pDataStore);
 
+  /**
+   * Use a snapshot of the decrypted binary data on the next call to
+   * @ref LoadAllData. Files unchanged since the snapshot was written
+   * are read from it instead of being decrypted again and the snapshot
+   * is rebuilt if any file was missing or out of date.
+   * @param path Path to the snapshot file on disk
+   * @param verify true to check the hash of each file read from the
+   *  snapshot
+   */
+  void SetSnapshotPath(const libcomp::String& path, bool verify = false);
+
   /**
    * Load the binary data definitions of the specified type
    * @param pDataStore Pointer to the datastore to load binary file from
@@ -868,24 +934,23 @@ class DefinitionManager {
                       uint16_t tablesExpected,
                       std::list<std::shared_ptr<T>>& records,
                       bool printResults = true) {
-    std::vector<char> data;
+    auto start = std::chrono::steady_clock::now();
 
-    auto path = libcomp::String("/BinaryData/") + binaryFile;
-
-    if (decrypt) {
-      data = pDataStore->DecryptFile(path);
-    } else {
-      data = pDataStore->ReadFile(path);
-    }
+    std::vector<char> data;
+    const char* pData = nullptr;
+    size_t dataSize = 0;
 
-    if (data.empty()) {
+    if (!ReadBinaryData(pDataStore, binaryFile, decrypt, data, pData,
+                        dataSize)) {
       if (printResults) {
-        PrintLoadResult(binaryFile, false, 0, 0);
+        PrintLoadResult(binaryFile, false, 0, 0, start);
       }
       return false;
     }
 
-    std::stringstream ss(std::string(data.begin(), data.end()));
+    // Parse straight out of the decrypted data instead of copying it
+    // into a string and again into a string stream.
+    MemoryInStream ss(pData, dataSize);
     libcomp::ObjectInStream ois(ss);
 
     uint16_t entryCount, tableCount;
@@ -895,7 +960,7 @@ class DefinitionManager {
     }
 
     size_t dynamicCounts = (size_t)(entryCount * tableCount);
-    for (uint16_t i = 0; i < dynamicCounts; i++) {
+    for (size_t i = 0; i < dynamicCounts; i++) {
       uint16_t ds;
       ois.stream.read(reinterpret_cast<char*>(&ds), sizeof(ds));
       ois.dynamicSizes.push_back(ds);
@@ -906,7 +971,8 @@ class DefinitionManager {
 
       if (!entry->Load(ois)) {
         if (printResults) {
-          PrintLoadResult(binaryFile, false, entryCount, records.size());
+          PrintLoadResult(binaryFile, false, entryCount, records.size(),
+                          start);
         }
         return false;
       }
@@ -916,12 +982,37 @@ class DefinitionManager {
 
     bool success = entryCount == records.size() && ois.stream.good();
     if (printResults) {
-      PrintLoadResult(binaryFile, success, entryCount, records.size());
+      PrintLoadResult(binaryFile, success, entryCount, records.size(), start);
+    }
+
+    if (success) {
+      // The decrypted size is a close enough estimate of the parsed size
+      MemoryAccounting::Add(MemoryTag_t::DEFINITIONS, dataSize,
+                            records.size());
     }
 
     return success;
   }
 
+  /**
+   * Read the contents of a binary file, from the definition snapshot
+   * if one is in use and it holds an up to date copy of the file
+   * @param pDataStore Pointer to a data store location to check
+   *  for the file
+   * @param binaryFile Relative file path to a binary file
+   * @param decrypt true if the file is encrypted and must be
+   *  decrypted first, false if it can just be loaded
+   * @param data Output buffer the file is read into when it does not
+   *  come from the snapshot
+   * @param pData Output pointer to the contents of the file
+   * @param dataSize Output size of the contents of the file
+   * @return true if the file was read, false if it was not
+   */
+  bool ReadBinaryData(libcomp::DataStore* pDataStore,
+                      const libcomp::String& binaryFile, bool decrypt,
+                      std::vector<char>& data, const char*& pData,
+                      size_t& dataSize);
+
   /**
    * Load the data header containing the number of entries and
    * tables that make up the format of the rest of the file
@@ -948,9 +1039,38 @@ class DefinitionManager {
    * @param entriesExpected Number of entries that were supposed to
    *  be in the file according to the data header
    * @param loadedEntries NUmber of entries successfully loaded
+   * @param start Time the file started loading
    */
   void PrintLoadResult(const libcomp::String& binaryFile, bool success,
-                       uint16_t entriesExpected, size_t loadedEntries);
+                       uint16_t entriesExpected, size_t loadedEntries,
+                       const std::chrono::steady_clock::time_point& start);
+
+  /**
+   * Utility function to get a raw pointer to a definition from its flat
+   * index or from the definition map if the index has not been built
+   * @param id ID of the definition to retrieve
+   * @param index Index built from the map
+   * @param data Map to retrieve the data from
+   * @return Pointer to the record matching the supplied ID, null if
+   *  it does not exist
+   */
+  template <class T>
+  const T* GetRecordPtrByID(
+      uint32_t id, const DefinitionIndex<T>& index,
+      const std::unordered_map<uint32_t, std::shared_ptr<T>>& data) const {
+    if (index.IsBuilt()) {
+      return index.Get(id);
+    }
+
+    auto iter = data.find(id);
+    return iter != data.end() ? iter->second.get() : nullptr;
+  }
+
+  /**
+   * Build the flat indexes of the most frequently used definitions once
+   * all definitions have loaded.
+   */
+  void BuildIndexes();
 
   /**
    * Utility function to pull the templated type from a standard
@@ -1017,6 +1137,9 @@ class DefinitionManager {
   std::unordered_map<uint32_t, std::shared_ptr<objects::MiDevilData>>
       mDevilData;
 
+  /// Flat index of devil definitions by ID
+  DefinitionIndex<objects::MiDevilData> mDevilIndex;
+
   /// Map of devil equipment definitions by skill ID
   std::unordered_map<uint32_t, std::shared_ptr<objects::MiDevilEquipmentData>>
       mDevilEquipmentData;
@@ -1112,6 +1235,9 @@ class DefinitionManager {
   /// Map of item definitions by ID
   std::unordered_map<uint32_t, std::shared_ptr<objects::MiItemData>> mItemData;
 
+  /// Flat index of item definitions by ID
+  DefinitionIndex<objects::MiItemData> mItemIndex;
+
   /// Map of mission definitions by ID
   std::unordered_map<uint32_t, std::shared_ptr<objects::MiMissionData>>
       mMissionData;
@@ -1200,6 +1326,9 @@ class DefinitionManager {
   std::unordered_map<uint32_t, std::shared_ptr<objects::MiSkillData>>
       mSkillData;
 
+  /// Flat index of skill definitions by ID
+  DefinitionIndex<objects::MiSkillData> mSkillIndex;
+
   /// Map of skill function IDs to skill IDs
   std::unordered_map<uint16_t, std::set<uint32_t>> mFunctionIDSkills;
 
@@ -1217,6 +1346,9 @@ class DefinitionManager {
   std::unordered_map<uint32_t, std::shared_ptr<objects::MiStatusData>>
       mStatusData;
 
+  /// Flat index of status definitions by ID
+  DefinitionIndex<objects::MiStatusData> mStatusIndex;
+
   /// Map of synthesis definitions by ID
   std::unordered_map<uint32_t, std::shared_ptr<objects::MiSynthesisData>>
       mSynthesisData;
@@ -1276,6 +1408,9 @@ class DefinitionManager {
 
   /// Map of tokusei definitions by ID
   std::unordered_map<int32_t, std::shared_ptr<objects::Tokusei>> mTokuseiData;
+
+  /// Snapshot of decrypted binary data used while loading, if enabled
+  std::shared_ptr<DefinitionSnapshot> mSnapshot;
 };
 
 }  // namespace libhack
@@ -0,0 +1,498 @@
+/**
+ * @file libhack/src/DefinitionSnapshot.cpp
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Memory mapped cache of decrypted binary data definitions.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DefinitionSnapshot.h"
+
+// libcomp Includes
+#include "Constants.h"
+#include "Log.h"
+
+// Standard C++11 Includes
+#include <cstdio>
+#include <cstring>
+
+// PhysFS Includes
+#include <physfs.h>
+
+#ifdef _WIN32
+// Windows Includes
+#include <process.h>
+#else  // _WIN32
+// POSIX Includes
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // _WIN32
+
+using namespace libhack;
+
+/// Magic value at the start of every definition snapshot
+#define SNAPSHOT_MAGIC "CHDS"
+
+/// Size of the magic value in bytes
+#define SNAPSHOT_MAGIC_SIZE (4)
+
+/// Version of the snapshot layout. The server version is stored as well
+/// so a snapshot from another build is never used.
+#define SNAPSHOT_FORMAT_VERSION (2)
+
+namespace {
+
+/// Fixed size header at the start of the snapshot. The file contents
+/// follow the header and the table of contents is at the end so the
+/// contents can be written as soon as each file is decrypted.
+struct SnapshotHeader {
+  char Magic[SNAPSHOT_MAGIC_SIZE];
+  uint32_t FormatVersion;
+  uint32_t ServerVersion[3];
+  uint32_t EntryCount;
+  uint64_t TableOffset;
+  uint64_t TableSize;
+  uint64_t TableHash;
+};
+
+template <typename T>
+bool ReadValue(const char*& pCursor, const char* pEnd, T& value) {
+  if ((size_t)(pEnd - pCursor) < sizeof(T)) {
+    return false;
+  }
+
+  memcpy(&value, pCursor, sizeof(T));
+  pCursor += sizeof(T);
+
+  return true;
+}
+
+template <typename T>
+void WriteValue(std::string& out, const T& value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+}  // namespace
+
+DefinitionSnapshot::DefinitionSnapshot(const libcomp::String& path,
+                                       bool verify)
+    : mPath(path),
+      mData(nullptr),
+      mSize(0),
+      mVerify(verify),
+      mChanged(false),
+      mOutSize(0) {
+#ifdef _WIN32
+  mTempPath = libcomp::String("%1.%2.tmp").Arg(path).Arg(_getpid());
+#else   // _WIN32
+  mTempPath = libcomp::String("%1.%2.tmp").Arg(path).Arg(getpid());
+#endif  // _WIN32
+
+  if (!Open()) {
+    Close();
+
+    // Build a new snapshot once loading is complete.
+    mChanged = true;
+  }
+}
+
+DefinitionSnapshot::~DefinitionSnapshot() {
+  // A new snapshot that was never saved is incomplete.
+  AbortWrite();
+  Close();
+}
+
+bool DefinitionSnapshot::GetFile(const libcomp::String& binaryFile,
+                                 const Source& source, const char*& pData,
+                                 size_t& dataSize) {
+  auto it = mEntries.find(binaryFile.ToUtf8());
+
+  if (it == mEntries.end() || it->second.SourceFile.Size != source.Size ||
+      it->second.SourceFile.ModTime != source.ModTime) {
+    return false;
+  }
+
+  const Entry& entry = it->second;
+  const char* pEntryData = mData + entry.Offset;
+
+  // Hashing every file would cost about as much as the decryption the
+  // snapshot saves, so it is only done when asked for.
+  if (mVerify && Hash(pEntryData, (size_t)entry.Size) != entry.DataHash) {
+    LogDefinitionManagerWarning([&]() {
+      return libcomp::String("Definition snapshot entry '%1' is corrupt.\n")
+          .Arg(binaryFile);
+    });
+
+    return false;
+  }
+
+  pData = pEntryData;
+  dataSize = (size_t)entry.Size;
+
+  // The contents stay in the mapping until the new snapshot is finished.
+  Record record;
+  record.Path = binaryFile.ToUtf8();
+  record.Location = entry;
+  record.pData = pData;
+
+  std::lock_guard<std::mutex> lock(mLock);
+  mRecords.push_back(std::move(record));
+
+  return true;
+}
+
+void DefinitionSnapshot::AddFile(const libcomp::String& binaryFile,
+                                 const Source& source,
+                                 const std::vector<char>& data) {
+  Record record;
+  record.Path = binaryFile.ToUtf8();
+  record.Location.SourceFile = source;
+  record.Location.DataHash = Hash(data.data(), data.size());
+  record.Location.Offset = 0;
+  record.Location.Size = (uint64_t)data.size();
+  record.pData = nullptr;
+
+  std::lock_guard<std::mutex> lock(mLock);
+
+  if (StartWrite()) {
+    WriteRecord(record, data.data());
+  }
+
+  mRecords.push_back(std::move(record));
+  mChanged = true;
+}
+
+bool DefinitionSnapshot::Save() {
+  std::lock_guard<std::mutex> lock(mLock);
+
+  if (!mChanged) {
+    return true;
+  }
+
+  if (!StartWrite()) {
+    return false;
+  }
+
+  // Copy the unchanged files over from the current mapping. A file that
+  // no longer matches its hash is left out so it is decrypted again.
+  for (auto it = mRecords.begin(); it != mRecords.end();) {
+    auto& record = *it;
+
+    if (record.pData) {
+      if (!mVerify && Hash(record.pData, (size_t)record.Location.Size) !=
+                          record.Location.DataHash) {
+        LogDefinitionManagerWarning([&]() {
+          return libcomp::String(
+                     "Definition snapshot entry '%1' is corrupt.\n")
+              .Arg(record.Path);
+        });
+
+        it = mRecords.erase(it);
+
+        continue;
+      }
+
+      WriteRecord(record, record.pData);
+    }
+
+    it++;
+  }
+
+  std::string table;
+
+  for (auto& record : mRecords) {
+    const Entry& entry = record.Location;
+
+    WriteValue(table, (uint16_t)record.Path.size());
+    table.append(record.Path);
+    WriteValue(table, entry.SourceFile.Size);
+    WriteValue(table, entry.SourceFile.ModTime);
+    WriteValue(table, entry.DataHash);
+    WriteValue(table, entry.Offset);
+    WriteValue(table, entry.Size);
+  }
+
+  SnapshotHeader header;
+  memcpy(header.Magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE);
+  header.FormatVersion = SNAPSHOT_FORMAT_VERSION;
+  header.ServerVersion[0] = VERSION_MAJOR;
+  header.ServerVersion[1] = VERSION_MINOR;
+  header.ServerVersion[2] = VERSION_PATCH;
+  header.EntryCount = (uint32_t)mRecords.size();
+  header.TableOffset = mOutSize;
+  header.TableSize = (uint64_t)table.size();
+  header.TableHash = Hash(table.c_str(), table.size());
+
+  mOut.write(table.c_str(), (std::streamsize)table.size());
+
+  // The header goes in last so a partial snapshot never validates.
+  mOut.seekp(0);
+  mOut.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  mOut.close();
+
+  if (mOut.fail()) {
+    LogDefinitionManagerError([&]() {
+      return libcomp::String("Failed to write definition snapshot: %1\n")
+          .Arg(mTempPath);
+    });
+
+    std::remove(mTempPath.C());
+
+    return false;
+  }
+
+  size_t recordCount = mRecords.size();
+
+  // The records may point into the current mapping so it must stay open
+  // until the new snapshot is written.
+  mRecords.clear();
+  Close();
+
+#ifdef _WIN32
+  // Windows will not rename over an existing file.
+  std::remove(mPath.C());
+#endif  // _WIN32
+
+  if (0 != std::rename(mTempPath.C(), mPath.C())) {
+    LogDefinitionManagerError([&]() {
+      return libcomp::String("Failed to replace definition snapshot: %1\n")
+          .Arg(mPath);
+    });
+
+    std::remove(mTempPath.C());
+
+    return false;
+  }
+
+  LogDefinitionManagerInfo([&]() {
+    return libcomp::String("Saved %1 definition files to snapshot: %2\n")
+        .Arg(recordCount)
+        .Arg(mPath);
+  });
+
+  mChanged = false;
+  mOutSize = 0;
+
+  return true;
+}
+
+bool DefinitionSnapshot::GetSource(const libcomp::String& path,
+                                   Source& source) {
+  // The data store is backed by PhysFS so the file can be checked without
+  // reading it. Anything without a size or time is always decrypted.
+  PHYSFS_Stat fileStat;
+
+  if (!PHYSFS_stat(path.C(), &fileStat) ||
+      PHYSFS_FILETYPE_REGULAR != fileStat.filetype ||
+      0 > fileStat.filesize || 0 > fileStat.modtime) {
+    return false;
+  }
+
+  source.Size = (uint64_t)fileStat.filesize;
+  source.ModTime = (int64_t)fileStat.modtime;
+
+  return true;
+}
+
+uint64_t DefinitionSnapshot::Hash(const char* pData, size_t dataSize) {
+  uint64_t hash = 14695981039346656037ULL;
+
+  for (size_t i = 0; i < dataSize; i++) {
+    hash ^= (uint8_t)pData[i];
+    hash *= 1099511628211ULL;
+  }
+
+  return hash;
+}
+
+bool DefinitionSnapshot::Open() {
+#ifdef _WIN32
+  std::ifstream in(mPath.C(), std::ios::in | std::ios::binary);
+
+  if (!in.good()) {
+    return false;
+  }
+
+  mFileData.assign(std::istreambuf_iterator<char>(in),
+                   std::istreambuf_iterator<char>());
+
+  mData = mFileData.data();
+  mSize = mFileData.size();
+#else   // _WIN32
+  int fd = open(mPath.C(), O_RDONLY);
+
+  if (0 > fd) {
+    return false;
+  }
+
+  struct stat fileStat;
+
+  if (0 != fstat(fd, &fileStat) || 0 >= fileStat.st_size) {
+    close(fd);
+
+    return false;
+  }
+
+  void* pMapping =
+      mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+
+  if (MAP_FAILED == pMapping) {
+    return false;
+  }
+
+  mData = static_cast<const char*>(pMapping);
+  mSize = (size_t)fileStat.st_size;
+#endif  // _WIN32
+
+  const char* pCursor = mData;
+  const char* pEnd = mData + mSize;
+
+  SnapshotHeader header;
+
+  if (!ReadValue(pCursor, pEnd, header) ||
+      0 != memcmp(header.Magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE) ||
+      SNAPSHOT_FORMAT_VERSION != header.FormatVersion ||
+      VERSION_MAJOR != header.ServerVersion[0] ||
+      VERSION_MINOR != header.ServerVersion[1] ||
+      VERSION_PATCH != header.ServerVersion[2] ||
+      header.TableOffset > (uint64_t)mSize ||
+      header.TableSize > (uint64_t)mSize - header.TableOffset ||
+      Hash(mData + header.TableOffset, (size_t)header.TableSize) !=
+          header.TableHash) {
+    LogDefinitionManagerInfo([&]() {
+      return libcomp::String(
+                 "Definition snapshot '%1' is out of date and will be "
+                 "rebuilt.\n")
+          .Arg(mPath);
+    });
+
+    return false;
+  }
+
+  pCursor = mData + header.TableOffset;
+
+  const char* pTableEnd = pCursor + header.TableSize;
+
+  for (uint32_t i = 0; i < header.EntryCount; i++) {
+    uint16_t pathSize = 0;
+
+    if (!ReadValue(pCursor, pTableEnd, pathSize) ||
+        (size_t)(pTableEnd - pCursor) < pathSize) {
+      return false;
+    }
+
+    std::string path(pCursor, pathSize);
+    pCursor += pathSize;
+
+    Entry entry;
+
+    if (!ReadValue(pCursor, pTableEnd, entry.SourceFile.Size) ||
+        !ReadValue(pCursor, pTableEnd, entry.SourceFile.ModTime) ||
+        !ReadValue(pCursor, pTableEnd, entry.DataHash) ||
+        !ReadValue(pCursor, pTableEnd, entry.Offset) ||
+        !ReadValue(pCursor, pTableEnd, entry.Size)) {
+      return false;
+    }
+
+    if (entry.Offset > header.TableOffset ||
+        entry.Size > header.TableOffset - entry.Offset) {
+      return false;
+    }
+
+    mEntries[path] = entry;
+  }
+
+  LogDefinitionManagerInfo([&]() {
+    return libcomp::String("Mapped %1 definition files from snapshot: %2\n")
+        .Arg(mEntries.size())
+        .Arg(mPath);
+  });
+
+  return true;
+}
+
+void DefinitionSnapshot::Close() {
+#ifdef _WIN32
+  mFileData.clear();
+  mFileData.shrink_to_fit();
+#else   // _WIN32
+  if (mData) {
+    munmap(const_cast<char*>(mData), mSize);
+  }
+#endif  // _WIN32
+
+  mData = nullptr;
+  mSize = 0;
+  mEntries.clear();
+}
+
+bool DefinitionSnapshot::StartWrite() {
+  if (mOut.is_open()) {
+    return mOut.good();
+  }
+
+  if (0 != mOutSize) {
+    // A previous write failed and the new snapshot was removed.
+    return false;
+  }
+
+  mOut.open(mTempPath.C(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+  // Reserve room for the header which is written once the table is.
+  SnapshotHeader header;
+  memset(&header, 0, sizeof(header));
+
+  mOut.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  mOutSize = (uint64_t)sizeof(header);
+
+  if (!mOut.good()) {
+    LogDefinitionManagerError([&]() {
+      return libcomp::String("Failed to write definition snapshot: %1\n")
+          .Arg(mTempPath);
+    });
+
+    AbortWrite();
+
+    return false;
+  }
+
+  return true;
+}
+
+void DefinitionSnapshot::WriteRecord(Record& record, const char* pData) {
+  record.Location.Offset = mOutSize;
+  record.pData = nullptr;
+
+  mOut.write(pData, (std::streamsize)record.Location.Size);
+  mOutSize += record.Location.Size;
+}
+
+void DefinitionSnapshot::AbortWrite() {
+  if (mOut.is_open()) {
+    mOut.close();
+    std::remove(mTempPath.C());
+  }
+}
@@ -0,0 +1,238 @@
+/**
+ * @file libhack/src/DefinitionSnapshot.h
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Memory mapped cache of decrypted binary data definitions.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHACK_SRC_DEFINITIONSNAPSHOT_H
+#define LIBHACK_SRC_DEFINITIONSNAPSHOT_H
+
+// libcomp Includes
+#include <CString.h>
+
+// Standard C++11 Includes
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace libhack {
+
+/**
+ * Versioned and checksummed snapshot of decrypted binary data files. The
+ * snapshot file is mapped read-only and the definitions are parsed
+ * straight out of the mapping, skipping decryption on restart. Each file
+ * is stored with the size and modification time of its encrypted source
+ * so a changed data store falls back to decrypting that file. Files that
+ * miss the snapshot are written to a new snapshot as soon as they are
+ * decrypted and it replaces the old one once loading is complete.
+ *
+ * Only the table of contents is checked against its hash when the
+ * snapshot is opened. The hash of each file is checked when it is copied
+ * into a new snapshot, or on every load if verification is enabled.
+ *
+ * The snapshot holds the decrypted game data in plaintext, so it should
+ * be kept somewhere only the server can read.
+ */
+class DefinitionSnapshot {
+ public:
+  /// Size and modification time of an encrypted source file
+  struct Source {
+    /// Size of the file in bytes
+    uint64_t Size;
+
+    /// Last modification time of the file
+    int64_t ModTime;
+  };
+
+  /**
+   * Create a snapshot for the given file. Any existing snapshot is
+   * opened and validated; an invalid or missing one is ignored.
+   * @param path Path to the snapshot file on disk
+   * @param verify true to check the hash of each file every time it is
+   *  read from the snapshot
+   */
+  explicit DefinitionSnapshot(const libcomp::String& path,
+                              bool verify = false);
+
+  /**
+   * Unmap the snapshot file and remove any unsaved new snapshot.
+   */
+  ~DefinitionSnapshot();
+
+  /**
+   * Get the decrypted contents of a file from the snapshot. The contents
+   * are only returned if the encrypted source is unchanged and, when
+   * verification is enabled, the stored contents pass their checksum.
+   * The file is recorded for the next save.
+   * @param binaryFile Relative path of the binary data file
+   * @param source Size and modification time of the encrypted source
+   * @param pData Output pointer to the decrypted contents
+   * @param dataSize Output size of the decrypted contents
+   * @return true if the file was found, false if it must be decrypted
+   */
+  bool GetFile(const libcomp::String& binaryFile, const Source& source,
+               const char*& pData, size_t& dataSize);
+
+  /**
+   * Record a file that was not found in the snapshot. The contents are
+   * written to the new snapshot right away so the caller can release
+   * them as soon as they are parsed.
+   * @param binaryFile Relative path of the binary data file
+   * @param source Size and modification time of the encrypted source
+   * @param data Decrypted contents of the file
+   */
+  void AddFile(const libcomp::String& binaryFile, const Source& source,
+               const std::vector<char>& data);
+
+  /**
+   * Finish the new snapshot with every file requested since it was
+   * opened and replace the current snapshot with it if any of them were
+   * missing from the current snapshot.
+   * @return true if the snapshot is current, false if it failed to save
+   */
+  bool Save();
+
+  /**
+   * Get the size and modification time of an encrypted source file in
+   * the data store. This does not read the file.
+   * @param path Path of the file in the data store
+   * @param source Output size and modification time of the file
+   * @return true if the file exists, false otherwise
+   */
+  static bool GetSource(const libcomp::String& path, Source& source);
+
+  /**
+   * Hash a block of data for use as a content checksum.
+   * @param pData Pointer to the data
+   * @param dataSize Size of the data in bytes
+   * @return 64-bit FNV-1a hash of the data
+   */
+  static uint64_t Hash(const char* pData, size_t dataSize);
+
+ private:
+  /// Location of a single file within the snapshot
+  struct Entry {
+    /// Size and modification time of the encrypted source file
+    Source SourceFile;
+
+    /// Hash of the decrypted contents
+    uint64_t DataHash;
+
+    /// Offset of the contents from the start of the snapshot
+    uint64_t Offset;
+
+    /// Size of the contents in bytes
+    uint64_t Size;
+  };
+
+  /// File recorded for the next save
+  struct Record {
+    /// Relative path of the binary data file
+    std::string Path;
+
+    /// Location of the file, with the offset in the new snapshot once
+    /// the contents have been written to it
+    Entry Location;
+
+    /// Contents in the current mapping if unchanged and not written yet
+    const char* pData;
+  };
+
+  /**
+   * Map and validate the snapshot file.
+   * @return true if the snapshot is valid, false otherwise
+   */
+  bool Open();
+
+  /**
+   * Unmap the snapshot file.
+   */
+  void Close();
+
+  /**
+   * Open the new snapshot file if it is not open yet. The lock must be
+   * held by the caller.
+   * @return true if the new snapshot is open, false on error
+   */
+  bool StartWrite();
+
+  /**
+   * Write the contents of a file to the end of the new snapshot. The
+   * lock must be held by the caller.
+   * @param record Record to write, updated with the new location
+   * @param pData Pointer to the contents
+   */
+  void WriteRecord(Record& record, const char* pData);
+
+  /**
+   * Close and delete the new snapshot file. The lock must be held by
+   * the caller.
+   */
+  void AbortWrite();
+
+  /// Path to the snapshot file on disk
+  libcomp::String mPath;
+
+  /// Start of the mapped snapshot
+  const char* mData;
+
+  /// Size of the mapped snapshot
+  size_t mSize;
+
+  /// Indicates the hash of each file is checked every time it is read
+  bool mVerify;
+
+#ifdef _WIN32
+  /// Contents of the snapshot when memory mapping is unavailable
+  std::vector<char> mFileData;
+#endif  // _WIN32
+
+  /// Files in the mapped snapshot by relative path
+  std::unordered_map<std::string, Entry> mEntries;
+
+  /// Files requested since the snapshot was opened
+  std::list<Record> mRecords;
+
+  /// Indicates a file missed the snapshot and it must be saved again
+  bool mChanged;
+
+  /// Path to the new snapshot, unique to this process so two servers
+  /// sharing a snapshot never write the same file
+  libcomp::String mTempPath;
+
+  /// New snapshot being written
+  std::ofstream mOut;
+
+  /// Size of the new snapshot written so far
+  uint64_t mOutSize;
+
+  /// Lock for the recorded files since definitions load in parallel
+  std::mutex mLock;
+};
+
+}  // namespace libhack
+
+#endif  // LIBHACK_SRC_DEFINITIONSNAPSHOT_H
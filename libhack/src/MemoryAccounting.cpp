@@ -0,0 +1,178 @@
+/**
+ * @file libhack/src/MemoryAccounting.cpp
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Lightweight per-subsystem memory accounting.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MemoryAccounting.h"
+
+// libcomp Includes
+#include <Packet.h>
+#include <ReadOnlyPacket.h>
+
+// Standard C++11 Includes
+#include <fstream>
+
+#ifndef _WIN32
+// POSIX Includes
+#include <unistd.h>
+#endif  // !_WIN32
+
+using namespace libhack;
+
+std::atomic<int64_t> MemoryAccounting::sCounts[(size_t)MemoryTag_t::COUNT];
+std::atomic<int64_t> MemoryAccounting::sBytes[(size_t)MemoryTag_t::COUNT];
+
+namespace {
+
+/// Display names of each tag in the order of MemoryTag_t
+const char* const TAG_NAMES[(size_t)MemoryTag_t::COUNT] = {
+    "Definitions", "ScriptEngines", "Zones",      "CharacterStates",
+    "DemonStates", "EnemyStates",   "AllyStates", "AIStates",
+};
+
+}  // namespace
+
+void MemoryAccounting::Add(MemoryTag_t tag, uint64_t bytes, uint64_t count) {
+  sCounts[(size_t)tag].fetch_add((int64_t)count, std::memory_order_relaxed);
+  sBytes[(size_t)tag].fetch_add((int64_t)bytes, std::memory_order_relaxed);
+}
+
+void MemoryAccounting::Remove(MemoryTag_t tag, uint64_t bytes,
+                              uint64_t count) {
+  sCounts[(size_t)tag].fetch_sub((int64_t)count, std::memory_order_relaxed);
+  sBytes[(size_t)tag].fetch_sub((int64_t)bytes, std::memory_order_relaxed);
+}
+
+std::list<MemoryAccounting::Usage> MemoryAccounting::GetUsage() {
+  std::list<Usage> usage;
+
+  for (size_t i = 0; i < (size_t)MemoryTag_t::COUNT; i++) {
+    int64_t count = sCounts[i].load(std::memory_order_relaxed);
+    int64_t bytes = sBytes[i].load(std::memory_order_relaxed);
+
+    Usage entry;
+    entry.Name = TAG_NAMES[i];
+    entry.Count = count > 0 ? (uint64_t)count : 0;
+    entry.Bytes = bytes > 0 ? (uint64_t)bytes : 0;
+
+    usage.push_back(entry);
+  }
+
+  uint64_t resident = GetResidentSize();
+  if (resident) {
+    Usage entry;
+    entry.Name = "Resident";
+    entry.Count = 1;
+    entry.Bytes = resident;
+
+    usage.push_back(entry);
+  }
+
+  return usage;
+}
+
+uint64_t MemoryAccounting::GetResidentSize() {
+#ifdef _WIN32
+  return 0;
+#else   // _WIN32
+  // The second value is the number of resident pages (Linux only)
+  std::ifstream in("/proc/self/statm");
+
+  uint64_t totalPages = 0;
+  uint64_t residentPages = 0;
+
+  if (!(in >> totalPages >> residentPages)) {
+    return 0;
+  }
+
+  long pageSize = sysconf(_SC_PAGESIZE);
+
+  return pageSize > 0 ? residentPages * (uint64_t)pageSize : 0;
+#endif  // _WIN32
+}
+
+void MemoryAccounting::SavePacket(libcomp::Packet& p,
+                                  const std::list<Usage>& usage) {
+  p.WriteU16Little((uint16_t)usage.size());
+
+  for (auto& entry : usage) {
+    p.WriteString16Little(libcomp::Convert::Encoding_t::ENCODING_UTF8,
+                          entry.Name, true);
+    p.WriteU64Little(entry.Count);
+    p.WriteU64Little(entry.Bytes);
+  }
+}
+
+bool MemoryAccounting::LoadPacket(libcomp::ReadOnlyPacket& p,
+                                  std::list<Usage>& usage) {
+  if (p.Left() < 2) {
+    return false;
+  }
+
+  uint16_t entryCount = p.ReadU16Little();
+
+  for (uint16_t i = 0; i < entryCount; i++) {
+    if (p.Left() < 2 || p.Left() < (uint32_t)(2 + p.PeekU16Little())) {
+      return false;
+    }
+
+    Usage entry;
+    entry.Name =
+        p.ReadString16Little(libcomp::Convert::Encoding_t::ENCODING_UTF8, true);
+
+    if (p.Left() < 16) {
+      return false;
+    }
+
+    entry.Count = p.ReadU64Little();
+    entry.Bytes = p.ReadU64Little();
+
+    usage.push_back(entry);
+  }
+
+  return true;
+}
+
+libcomp::String MemoryAccounting::FormatBytes(uint64_t bytes) {
+  const char* const units[] = {"KiB", "MiB", "GiB"};
+
+  if (bytes < 1024ULL) {
+    return libcomp::String("%1 B").Arg(bytes);
+  }
+
+  // Scale to the largest unit that keeps at least 1 and show one decimal
+  uint64_t scale = 1024ULL;
+  size_t unit = 0;
+  while (unit < 2 && bytes >= scale * 1024ULL) {
+    scale *= 1024ULL;
+    unit++;
+  }
+
+  uint64_t tenths = bytes * 10ULL / scale;
+
+  return libcomp::String("%1.%2 %3")
+      .Arg(tenths / 10ULL)
+      .Arg(tenths % 10ULL)
+      .Arg(units[unit]);
+}
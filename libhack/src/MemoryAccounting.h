@@ -0,0 +1,190 @@
+/**
+ * @file libhack/src/MemoryAccounting.h
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Lightweight per-subsystem memory accounting.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHACK_SRC_MEMORYACCOUNTING_H
+#define LIBHACK_SRC_MEMORYACCOUNTING_H
+
+// libcomp Includes
+#include <CString.h>
+
+// Standard C++11 Includes
+#include <atomic>
+#include <list>
+
+namespace libcomp {
+class Packet;
+class ReadOnlyPacket;
+}  // namespace libcomp
+
+namespace libhack {
+
+/**
+ * Subsystems tracked by @ref MemoryAccounting.
+ */
+enum class MemoryTag_t : uint8_t {
+  /// Binary data definition tables
+  DEFINITIONS = 0,
+  /// Squirrel script VMs
+  SCRIPT_ENGINES,
+  /// Zones (not including their entities)
+  ZONES,
+  /// Character entity states
+  CHARACTER_STATES,
+  /// Partner demon entity states
+  DEMON_STATES,
+  /// Enemy entity states
+  ENEMY_STATES,
+  /// Ally entity states
+  ALLY_STATES,
+  /// AI controller states
+  AI_STATES,
+  /// Number of tags (not a tag)
+  COUNT,
+};
+
+/**
+ * Process wide counters of live objects and their approximate size by
+ * subsystem. Counting is a pair of relaxed atomic adds per object so it
+ * is always enabled. Sizes only include the object itself and not any
+ * separately allocated members so they are a lower bound meant to show
+ * trends and leaks rather than exact usage.
+ */
+class MemoryAccounting {
+ public:
+  /// Usage of a single subsystem
+  struct Usage {
+    /// Name of the subsystem
+    libcomp::String Name;
+
+    /// Number of live objects
+    uint64_t Count;
+
+    /// Approximate size of the live objects in bytes
+    uint64_t Bytes;
+  };
+
+  /**
+   * Record objects being allocated.
+   * @param tag Subsystem the objects belong to
+   * @param bytes Size of the objects in bytes
+   * @param count Number of objects
+   */
+  static void Add(MemoryTag_t tag, uint64_t bytes, uint64_t count = 1);
+
+  /**
+   * Record objects being freed.
+   * @param tag Subsystem the objects belong to
+   * @param bytes Size of the objects in bytes
+   * @param count Number of objects
+   */
+  static void Remove(MemoryTag_t tag, uint64_t bytes, uint64_t count = 1);
+
+  /**
+   * Get the current usage of every subsystem followed by the resident
+   * size of the process if it is known.
+   * @return List of usage by subsystem
+   */
+  static std::list<Usage> GetUsage();
+
+  /**
+   * Get the resident set size of the process.
+   * @return Resident size in bytes or 0 if it is not known
+   */
+  static uint64_t GetResidentSize();
+
+  /**
+   * Write a usage list to a packet.
+   * @param p Packet to write to
+   * @param usage List of usage to write
+   */
+  static void SavePacket(libcomp::Packet& p, const std::list<Usage>& usage);
+
+  /**
+   * Read a usage list from a packet.
+   * @param p Packet to read from
+   * @param usage Output list of usage read
+   * @return true if the list was read, false if the packet is malformed
+   */
+  static bool LoadPacket(libcomp::ReadOnlyPacket& p, std::list<Usage>& usage);
+
+  /**
+   * Format a size in bytes for display.
+   * @param bytes Size in bytes
+   * @return Size formatted as B, KiB, MiB or GiB
+   */
+  static libcomp::String FormatBytes(uint64_t bytes);
+
+ private:
+  /// Number of live objects by tag
+  static std::atomic<int64_t> sCounts[(size_t)MemoryTag_t::COUNT];
+
+  /// Size of the live objects by tag
+  static std::atomic<int64_t> sBytes[(size_t)MemoryTag_t::COUNT];
+};
+
+/**
+ * Base class that counts every live instance of the derived class with
+ * @ref MemoryAccounting. Derive from it with the class itself as the
+ * second template parameter.
+ */
+template <MemoryTag_t TAG, typename T>
+class MemoryTracked {
+ protected:
+  /**
+   * Count a new instance.
+   */
+  MemoryTracked() { MemoryAccounting::Add(TAG, sizeof(T)); }
+
+  /**
+   * Count a copied instance.
+   * @param other Instance being copied
+   */
+  MemoryTracked(const MemoryTracked& other) {
+    (void)other;
+
+    MemoryAccounting::Add(TAG, sizeof(T));
+  }
+
+  /**
+   * Stop counting the instance.
+   */
+  ~MemoryTracked() { MemoryAccounting::Remove(TAG, sizeof(T)); }
+
+  /**
+   * Assignment does not change the number of instances.
+   * @param other Instance being assigned
+   * @return Reference to this instance
+   */
+  MemoryTracked& operator=(const MemoryTracked& other) {
+    (void)other;
+
+    return *this;
+  }
+};
+
+}  // namespace libhack
+
+#endif  // LIBHACK_SRC_MEMORYACCOUNTING_H
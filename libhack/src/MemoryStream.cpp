@@ -0,0 +1,83 @@
+/**
+ * @file libhack/src/MemoryStream.cpp
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Input stream that reads directly from a block of memory.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MemoryStream.h"
+
+using namespace libhack;
+
+MemoryStreamBuffer::MemoryStreamBuffer(const char* pData, size_t dataSize) {
+  // The get area is never written to so dropping the const is safe.
+  char* pBegin = const_cast<char*>(pData);
+
+  setg(pBegin, pBegin, pBegin + dataSize);
+}
+
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekoff(
+    off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) {
+  if (!(which & std::ios_base::in)) {
+    return pos_type(off_type(-1));
+  }
+
+  char* pPos = nullptr;
+
+  switch (dir) {
+    case std::ios_base::beg:
+      pPos = eback() + off;
+      break;
+    case std::ios_base::cur:
+      pPos = gptr() + off;
+      break;
+    case std::ios_base::end:
+      pPos = egptr() + off;
+      break;
+    default:
+      return pos_type(off_type(-1));
+  }
+
+  if (pPos < eback() || pPos > egptr()) {
+    return pos_type(off_type(-1));
+  }
+
+  setg(eback(), pPos, egptr());
+
+  return pos_type(off_type(pPos - eback()));
+}
+
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekpos(
+    pos_type pos, std::ios_base::openmode which) {
+  return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+MemoryInStream::MemoryInStream(const char* pData, size_t dataSize)
+    : std::istream(nullptr), mBuffer(pData, dataSize) {
+  rdbuf(&mBuffer);
+}
+
+MemoryInStream::MemoryInStream(const std::vector<char>& data)
+    : MemoryInStream(data.data(), data.size()) {}
+
+MemoryInStream::MemoryInStream(const std::string& data)
+    : MemoryInStream(data.data(), data.size()) {}
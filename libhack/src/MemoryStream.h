@@ -0,0 +1,104 @@
+/**
+ * @file libhack/src/MemoryStream.h
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Input stream that reads directly from a block of memory.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHACK_SRC_MEMORYSTREAM_H
+#define LIBHACK_SRC_MEMORYSTREAM_H
+
+// Standard C++11 Includes
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace libhack {
+
+/**
+ * Read only stream buffer over a contiguous block of memory. The memory
+ * is not copied so it must outlive the buffer.
+ */
+class MemoryStreamBuffer : public std::streambuf {
+ public:
+  /**
+   * Create a stream buffer over a block of memory.
+   * @param pData Pointer to the start of the memory
+   * @param dataSize Size of the memory in bytes
+   */
+  MemoryStreamBuffer(const char* pData, size_t dataSize);
+
+ protected:
+  /**
+   * Move the read position relative to the start, current position or
+   * end of the memory.
+   * @param off Offset to move by
+   * @param dir Position the offset is relative to
+   * @param which Sequence to move, only input is supported
+   * @return New read position or -1 on error
+   */
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override;
+
+  /**
+   * Move the read position to an absolute position.
+   * @param pos New read position
+   * @param which Sequence to move, only input is supported
+   * @return New read position or -1 on error
+   */
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+};
+
+/**
+ * Input stream that reads directly from a block of memory instead of
+ * copying it into a std::stringstream first. The memory must outlive
+ * the stream.
+ */
+class MemoryInStream : public std::istream {
+ public:
+  /**
+   * Create a stream over a block of memory.
+   * @param pData Pointer to the start of the memory
+   * @param dataSize Size of the memory in bytes
+   */
+  MemoryInStream(const char* pData, size_t dataSize);
+
+  /**
+   * Create a stream over the contents of a vector.
+   * @param data Vector to read from
+   */
+  explicit MemoryInStream(const std::vector<char>& data);
+
+  /**
+   * Create a stream over the contents of a string.
+   * @param data String to read from
+   */
+  explicit MemoryInStream(const std::string& data);
+
+ private:
+  /// Buffer the stream reads from
+  MemoryStreamBuffer mBuffer;
+};
+
+}  // namespace libhack
+
+#endif  // LIBHACK_SRC_MEMORYSTREAM_H
@@ -0,0 +1,395 @@
+/**
+ * @file libhack/src/MigrationRunner.cpp
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Batched and resumable record processing for migration scripts.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MigrationRunner.h"
+
+#ifndef EXOTIC_PLATFORM
+
+// libcomp Includes
+#include <Log.h>
+
+// objects Includes
+#include <MigrationProgress.h>
+
+// Standard C++11 Includes
+#include <chrono>
+
+using namespace libhack;
+
+/// Default number of records processed and saved together
+#define MIGRATION_DEFAULT_BATCH_SIZE (500)
+
+namespace libcomp {
+template <>
+BaseScriptEngine& BaseScriptEngine::Using<MigrationRunner>() {
+  if (!BindingExists("MigrationRunner", true)) {
+    Sqrat::Class<MigrationRunner, Sqrat::NoConstructor<MigrationRunner>>
+        binding(mVM, "MigrationRunner");
+    binding.StaticFunc("Create", &MigrationRunner::Create)
+        .Func("SetBatchSize", &MigrationRunner::SetBatchSize)
+        .Func("QueueUpdate", &MigrationRunner::QueueUpdate)
+        .Func("QueueInsert", &MigrationRunner::QueueInsert)
+        .Func<bool (MigrationRunner::*)(Sqrat::Function)>(
+            "Run", &MigrationRunner::Run)
+        .Func("GetProcessed", &MigrationRunner::GetProcessed);
+
+    Bind<MigrationRunner>("MigrationRunner", binding);
+  }
+
+  return *this;
+}
+}  // namespace libcomp
+
+MigrationRunner::MigrationRunner(const libcomp::String& name,
+                                 const std::shared_ptr<libcomp::Database>& db,
+                                 const libcomp::String& objectType)
+    : mName(name),
+      mDatabase(db),
+      mObjectType(objectType),
+      mTypeHash(0),
+      mBatchSize(MIGRATION_DEFAULT_BATCH_SIZE) {
+  bool result = false;
+  mTypeHash = libcomp::PersistentObject::GetTypeHashByName(
+      objectType.ToUtf8(), result);
+
+  if (!result) {
+    mTypeHash = 0;
+  } else {
+    auto obj = libcomp::PersistentObject::New(mTypeHash);
+
+    if (obj) {
+      mTableName = obj->GetObjectMetadata()->GetName();
+    }
+  }
+}
+
+MigrationRunner::~MigrationRunner() {}
+
+std::shared_ptr<MigrationRunner> MigrationRunner::Create(
+    const libcomp::String& name, const std::shared_ptr<libcomp::Database>& db,
+    const libcomp::String& objectType) {
+  return std::make_shared<MigrationRunner>(name, db, objectType);
+}
+
+void MigrationRunner::SetBatchSize(uint32_t batchSize) {
+  mBatchSize = batchSize ? batchSize : 1;
+}
+
+void MigrationRunner::QueueUpdate(
+    const std::shared_ptr<libcomp::PersistentObject>& obj) {
+  if (mChanges && obj) {
+    mChanges->Update(obj);
+  }
+}
+
+void MigrationRunner::QueueInsert(
+    const std::shared_ptr<libcomp::PersistentObject>& obj) {
+  if (mChanges && obj) {
+    mChanges->Insert(obj);
+  }
+}
+
+bool MigrationRunner::Run(Sqrat::Function f) {
+  if (f.IsNull()) {
+    LogGeneralErrorMsg("Migration run requested with no function.\n");
+
+    return false;
+  }
+
+  return Run([&](const std::shared_ptr<libcomp::PersistentObject>& obj) {
+    auto result = f.Evaluate<bool>(obj, this);
+
+    return result && *result;
+  });
+}
+
+bool MigrationRunner::Run(
+    const std::function<
+        bool(const std::shared_ptr<libcomp::PersistentObject>&)>& f) {
+  if (!mTypeHash) {
+    LogGeneralError([&]() {
+      return libcomp::String(
+                 "Migration '%1' cannot run for unknown object type: %2\n")
+          .Arg(mName)
+          .Arg(mObjectType);
+    });
+
+    return false;
+  }
+
+  mProgress = LoadProgress();
+
+  if (!mProgress) {
+    LogGeneralError([&]() {
+      return libcomp::String(
+                 "Migration '%1' failed to load its progress record.\n")
+          .Arg(mName);
+    });
+
+    return false;
+  } else if (mProgress->GetComplete()) {
+    LogGeneralInfo([&]() {
+      return libcomp::String("Migration '%1' has already completed.\n")
+          .Arg(mName);
+    });
+
+    return true;
+  } else if (mProgress->GetProcessed()) {
+    LogGeneralInfo([&]() {
+      return libcomp::String("Migration '%1' resuming after %2 record(s).\n")
+          .Arg(mName)
+          .Arg(mProgress->GetProcessed());
+    });
+  }
+
+  uint64_t remaining = 0;
+
+  if (!CountRemaining(mProgress->GetLastUID(), remaining)) {
+    LogGeneralError([&]() {
+      return libcomp::String("Migration '%1' failed to count the %2 "
+                             "records.\n")
+          .Arg(mName)
+          .Arg(mObjectType);
+    });
+
+    return false;
+  }
+
+  uint64_t total = mProgress->GetProcessed() + remaining;
+
+  auto start = std::chrono::steady_clock::now();
+  uint64_t processedThisRun = 0;
+
+  // Batches are processed one after another on the migration thread. The
+  // callback runs in the single script VM that loaded the migration and
+  // every batch is saved through the same database connection, so there
+  // is nothing to hand to a second thread.
+  std::list<std::shared_ptr<libcomp::PersistentObject>> records;
+
+  for (;;) {
+    records.clear();
+
+    if (!LoadBatch(mProgress->GetLastUID(), mBatchSize, records)) {
+      LogGeneralError([&]() {
+        return libcomp::String("Migration '%1' failed to load %2 records.\n")
+            .Arg(mName)
+            .Arg(mObjectType);
+      });
+
+      return false;
+    }
+
+    if (records.empty()) {
+      break;
+    }
+
+    mChanges = libcomp::DatabaseChangeSet::Create();
+
+    for (auto& record : records) {
+      if (!f(record)) {
+        LogGeneralError([&]() {
+          return libcomp::String("Migration '%1' failed on %2 record: %3\n")
+              .Arg(mName)
+              .Arg(mObjectType)
+              .Arg(record->GetUUID().ToString());
+        });
+
+        mChanges = nullptr;
+
+        return false;
+      }
+    }
+
+    mProgress->SetLastUID(records.back()->GetUUID());
+    mProgress->SetProcessed(mProgress->GetProcessed() +
+                            (uint64_t)records.size());
+
+    if (!CompleteBatch()) {
+      return false;
+    }
+
+    processedThisRun += (uint64_t)records.size();
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    double rate = elapsed > 0
+                      ? (double)processedThisRun * 1000.0 / (double)elapsed
+                      : 0.0;
+
+    // Records added while the migration runs may push it past the total
+    uint64_t processed = mProgress->GetProcessed();
+    uint64_t left = total > processed ? total - processed : 0;
+
+    LogGeneralInfo([&]() {
+      return libcomp::String(
+                 "Migration '%1': %2/%3 record(s), %4 per second, ETA %5 "
+                 "second(s)\n")
+          .Arg(mName)
+          .Arg(processed)
+          .Arg(total)
+          .Arg((int64_t)rate)
+          .Arg(rate > 0.0 ? (int64_t)((double)left / rate) : 0);
+    });
+  }
+
+  mProgress->SetComplete(true);
+  mChanges = libcomp::DatabaseChangeSet::Create();
+
+  if (!CompleteBatch()) {
+    return false;
+  }
+
+  LogGeneralInfo([&]() {
+    return libcomp::String("Migration '%1' completed after %2 record(s).\n")
+        .Arg(mName)
+        .Arg(mProgress->GetProcessed());
+  });
+
+  return true;
+}
+
+uint64_t MigrationRunner::GetProcessed() const {
+  return mProgress ? mProgress->GetProcessed() : 0;
+}
+
+std::shared_ptr<objects::MigrationProgress> MigrationRunner::LoadProgress() {
+  if (!mDatabase) {
+    return nullptr;
+  }
+
+  auto progress = objects::MigrationProgress::LoadMigrationProgressByName(
+      mDatabase, mName);
+
+  if (!progress) {
+    progress =
+        libcomp::PersistentObject::New<objects::MigrationProgress>(true);
+    progress->SetName(mName);
+
+    if (!progress->Insert(mDatabase)) {
+      return nullptr;
+    }
+  }
+
+  return progress;
+}
+
+bool MigrationRunner::CountRemaining(const libobjgen::UUID& lastUID,
+                                     uint64_t& remaining) {
+  if (!mDatabase || mTableName.IsEmpty()) {
+    return false;
+  }
+
+  bool first = lastUID.IsNull();
+
+  auto query = mDatabase->Prepare(
+      libcomp::String("SELECT COUNT(UID) AS Remaining FROM %1%2")
+          .Arg(mTableName)
+          .Arg(first ? "" : " WHERE UID > :lastUID"));
+
+  int64_t count = 0;
+
+  if (!query.IsValid() || (!first && !query.Bind("lastUID", lastUID)) ||
+      !query.Execute() || !query.Next() ||
+      !query.GetValue("Remaining", count)) {
+    return false;
+  }
+
+  remaining = (uint64_t)count;
+
+  return true;
+}
+
+bool MigrationRunner::LoadBatch(
+    const libobjgen::UUID& lastUID, uint32_t count,
+    std::list<std::shared_ptr<libcomp::PersistentObject>>& records) {
+  if (!mDatabase || mTableName.IsEmpty()) {
+    return false;
+  }
+
+  bool first = lastUID.IsNull();
+
+  // Keyset paging on the primary key so each query reads a single batch
+  // through the UID index no matter how far the migration has come.
+  auto query = mDatabase->Prepare(
+      libcomp::String("SELECT * FROM %1%2 ORDER BY UID LIMIT %3")
+          .Arg(mTableName)
+          .Arg(first ? "" : " WHERE UID > :lastUID")
+          .Arg(count));
+
+  if (!query.IsValid() || (!first && !query.Bind("lastUID", lastUID)) ||
+      !query.Execute()) {
+    return false;
+  }
+
+  while (query.Next()) {
+    libobjgen::UUID uuid;
+
+    if (!query.GetValue("UID", uuid)) {
+      return false;
+    }
+
+    // Use the record already loaded by the server if there is one
+    auto obj = libcomp::PersistentObject::GetObjectByUUID(uuid);
+
+    if (!obj) {
+      obj = libcomp::PersistentObject::New(mTypeHash);
+
+      if (!obj || !obj->LoadDatabaseValues(query) ||
+          !obj->Register(obj, uuid)) {
+        return false;
+      }
+    }
+
+    records.push_back(obj);
+  }
+
+  return true;
+}
+
+bool MigrationRunner::SaveBatch(
+    const std::shared_ptr<libcomp::DatabaseChangeSet>& changes) {
+  return mDatabase && mDatabase->ProcessChangeSet(changes);
+}
+
+bool MigrationRunner::CompleteBatch() {
+  // Save the batch and its checkpoint together
+  mChanges->Update(mProgress);
+
+  bool saved = SaveBatch(mChanges);
+  mChanges = nullptr;
+
+  if (!saved) {
+    LogGeneralError([&]() {
+      return libcomp::String("Migration '%1' failed to save a batch.\n")
+          .Arg(mName);
+    });
+  }
+
+  return saved;
+}
+
+#endif  // !EXOTIC_PLATFORM
@@ -0,0 +1,219 @@
+/**
+ * @file libhack/src/MigrationRunner.h
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Batched and resumable record processing for migration scripts.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHACK_SRC_MIGRATIONRUNNER_H
+#define LIBHACK_SRC_MIGRATIONRUNNER_H
+
+// libcomp Includes
+#include <CString.h>
+#include <Database.h>
+#include <DatabaseChangeSet.h>
+#include <ScriptEngine.h>
+
+// Standard C++11 Includes
+#include <list>
+
+#ifndef EXOTIC_PLATFORM
+
+namespace objects {
+class MigrationProgress;
+}
+
+namespace libhack {
+
+/**
+ * Helper for migration scripts that need to visit every record of one
+ * persistent object type. The records are loaded and processed in
+ * bounded size batches ordered by UID, each loaded by its own query
+ * starting after the last UID of the previous batch. All updates queued
+ * while processing a batch are saved in a single change set along with a
+ * progress checkpoint so a migration that is killed resumes after the
+ * last completed batch the next time it runs. Checkpoints are stored as
+ * MigrationProgress records which only exist in the world database.
+ *
+ * Scripts opt in like so:
+ * @code
+ * local runner = MigrationRunner.Create("20201101_example", db,
+ *     "Character");
+ * return runner.Run(function(obj, runner) {
+ *     ...
+ *     runner.QueueUpdate(obj);
+ *     return true;
+ * });
+ * @endcode
+ */
+class MigrationRunner {
+ public:
+  /**
+   * Create a new migration runner.
+   * @param name Unique name of the migration used for the checkpoint
+   * @param db Database to migrate
+   * @param objectType Name of the persistent object type to process
+   */
+  MigrationRunner(const libcomp::String& name,
+                  const std::shared_ptr<libcomp::Database>& db,
+                  const libcomp::String& objectType);
+
+  /**
+   * Clean up the migration runner.
+   */
+  virtual ~MigrationRunner();
+
+  /**
+   * Create a new migration runner. Used by scripts.
+   * @param name Unique name of the migration used for the checkpoint
+   * @param db Database to migrate
+   * @param objectType Name of the persistent object type to process
+   * @return Pointer to the new migration runner
+   */
+  static std::shared_ptr<MigrationRunner> Create(
+      const libcomp::String& name, const std::shared_ptr<libcomp::Database>& db,
+      const libcomp::String& objectType);
+
+  /**
+   * Set the number of records loaded, processed and saved together.
+   * @param batchSize Number of records per batch
+   */
+  void SetBatchSize(uint32_t batchSize);
+
+  /**
+   * Queue an update for a record changed while processing the current
+   * batch. The update is saved when the batch completes.
+   * @param obj Record to update
+   */
+  void QueueUpdate(const std::shared_ptr<libcomp::PersistentObject>& obj);
+
+  /**
+   * Queue an insert for a record created while processing the current
+   * batch. The insert is saved when the batch completes.
+   * @param obj Record to insert
+   */
+  void QueueInsert(const std::shared_ptr<libcomp::PersistentObject>& obj);
+
+  /**
+   * Process every record of the object type not already covered by the
+   * stored checkpoint.
+   * @param f Script function called with each record and this runner
+   *  that returns true on success or false to stop the migration
+   * @return true if every record was processed, false on error
+   */
+  bool Run(Sqrat::Function f);
+
+  /**
+   * Process every record of the object type not already covered by the
+   * stored checkpoint.
+   * @param f Function called with each record that returns true on
+   *  success or false to stop the migration
+   * @return true if every record was processed, false on error
+   */
+  bool Run(const std::function<bool(
+               const std::shared_ptr<libcomp::PersistentObject>&)>& f);
+
+  /**
+   * Get the number of records processed so far, including those from
+   * any previous run that was resumed.
+   * @return Number of records processed
+   */
+  uint64_t GetProcessed() const;
+
+ protected:
+  /**
+   * Load the checkpoint of the migration or create it if the migration
+   * has not run before.
+   * @return Pointer to the checkpoint or null on error
+   */
+  virtual std::shared_ptr<objects::MigrationProgress> LoadProgress();
+
+  /**
+   * Count the records left to process.
+   * @param lastUID UID of the last record processed or a null UID if
+   *  no record has been processed yet
+   * @param remaining Output number of records after lastUID
+   * @return true if the records were counted, false on error
+   */
+  virtual bool CountRemaining(const libobjgen::UUID& lastUID,
+                              uint64_t& remaining);
+
+  /**
+   * Load the next batch of records ordered by UID.
+   * @param lastUID UID of the last record processed or a null UID to
+   *  start at the first record
+   * @param count Maximum number of records to load
+   * @param records Output list the loaded records are added to
+   * @return true if the batch was loaded, false on error
+   */
+  virtual bool LoadBatch(
+      const libobjgen::UUID& lastUID, uint32_t count,
+      std::list<std::shared_ptr<libcomp::PersistentObject>>& records);
+
+  /**
+   * Save the changes queued for a batch along with the checkpoint.
+   * @param changes Changes queued for the batch which the checkpoint
+   *  update has been added to
+   * @return true if the batch was saved, false on error
+   */
+  virtual bool SaveBatch(
+      const std::shared_ptr<libcomp::DatabaseChangeSet>& changes);
+
+  /// Unique name of the migration
+  libcomp::String mName;
+
+  /// Database being migrated
+  std::shared_ptr<libcomp::Database> mDatabase;
+
+ private:
+  /**
+   * Save the current batch and its checkpoint and release the queued
+   * changes.
+   * @return true if the batch was saved, false on error
+   */
+  bool CompleteBatch();
+
+  /// Name of the persistent object type processed
+  libcomp::String mObjectType;
+
+  /// Type hash of the persistent object type processed
+  size_t mTypeHash;
+
+  /// Name of the table holding the records, taken from the registered
+  /// object definition rather than the script
+  libcomp::String mTableName;
+
+  /// Number of records loaded, processed and saved together
+  uint32_t mBatchSize;
+
+  /// Checkpoint of the migration progress
+  std::shared_ptr<objects::MigrationProgress> mProgress;
+
+  /// Changes queued while processing the current batch
+  std::shared_ptr<libcomp::DatabaseChangeSet> mChanges;
+};
+
+}  // namespace libhack
+
+#endif  // !EXOTIC_PLATFORM
+
+#endif  // LIBHACK_SRC_MIGRATIONRUNNER_H
@@ -0,0 +1,266 @@
+/**
+ * @file libhack/src/ObjectPool.h
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Pooled allocation for frequently created shared objects.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHACK_SRC_OBJECTPOOL_H
+#define LIBHACK_SRC_OBJECTPOOL_H
+
+// Standard C++11 Includes
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace libhack {
+
+/**
+ * Thread safe free list of fixed size memory blocks. The block size is
+ * taken from the first allocation. Blocks of any other size skip the
+ * pool. Freed blocks are kept for reuse up to a maximum count and the
+ * rest are returned to the system allocator.
+ */
+class BlockPool {
+ public:
+  /**
+   * Create a new empty pool.
+   * @param maxFree Maximum number of freed blocks to keep for reuse
+   */
+  explicit BlockPool(size_t maxFree)
+      : mBlockSize(0), mMaxFree(maxFree), mHits(0), mMisses(0) {}
+
+  /**
+   * Release the blocks kept for reuse.
+   */
+  ~BlockPool() {
+    for (void* pBlock : mFree) {
+      ::operator delete(pBlock);
+    }
+  }
+
+  /**
+   * Get a block from the pool or the system allocator.
+   * @param size Size of the block in bytes
+   * @return Pointer to the block
+   */
+  void* Allocate(size_t size) {
+    {
+      std::lock_guard<std::mutex> lock(mLock);
+
+      if (!mBlockSize) {
+        mBlockSize = size;
+      }
+
+      if (size == mBlockSize && !mFree.empty()) {
+        void* pBlock = mFree.back();
+        mFree.pop_back();
+        mHits++;
+
+        return pBlock;
+      }
+
+      mMisses++;
+    }
+
+    return ::operator new(size);
+  }
+
+  /**
+   * Return a block to the pool or the system allocator.
+   * @param pBlock Pointer to the block
+   * @param size Size of the block in bytes
+   */
+  void Free(void* pBlock, size_t size) {
+    {
+      std::lock_guard<std::mutex> lock(mLock);
+
+      if (size == mBlockSize && mFree.size() < mMaxFree) {
+        mFree.push_back(pBlock);
+
+        return;
+      }
+    }
+
+    ::operator delete(pBlock);
+  }
+
+  /**
+   * Get the usage statistics of the pool.
+   * @param hits Output number of allocations served by the pool
+   * @param misses Output number of allocations that were not
+   * @param pooled Output number of blocks waiting for reuse
+   */
+  void GetStats(uint64_t& hits, uint64_t& misses, size_t& pooled) {
+    std::lock_guard<std::mutex> lock(mLock);
+
+    hits = mHits;
+    misses = mMisses;
+    pooled = mFree.size();
+  }
+
+ private:
+  /// Size of each block in the pool
+  size_t mBlockSize;
+
+  /// Maximum number of freed blocks to keep for reuse
+  size_t mMaxFree;
+
+  /// Freed blocks waiting for reuse
+  std::vector<void*> mFree;
+
+  /// Number of allocations served by the pool
+  uint64_t mHits;
+
+  /// Number of allocations that went to the system allocator
+  uint64_t mMisses;
+
+  /// Lock for the free list since objects can be freed on any thread
+  std::mutex mLock;
+};
+
+/**
+ * Standard allocator that takes single objects from a @ref BlockPool.
+ * Every copy and rebind of the allocator shares the same pool which
+ * stays alive until the last object allocated from it is freed.
+ */
+template <typename T>
+class PoolAllocator {
+ public:
+  /// Type of object allocated
+  typedef T value_type;
+
+  /**
+   * Create an allocator for a pool.
+   * @param pool Pool to allocate from
+   */
+  explicit PoolAllocator(const std::shared_ptr<BlockPool>& pool)
+      : mPool(pool) {}
+
+  /**
+   * Create an allocator sharing the pool of another allocator.
+   * @param other Allocator to share the pool of
+   */
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>& other) : mPool(other.mPool) {}
+
+  /**
+   * Allocate memory for one or more objects.
+   * @param n Number of objects
+   * @return Pointer to the memory
+   */
+  T* allocate(size_t n) {
+    if (1 == n) {
+      return static_cast<T*>(mPool->Allocate(sizeof(T)));
+    }
+
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  /**
+   * Free memory allocated by @ref allocate.
+   * @param p Pointer to the memory
+   * @param n Number of objects
+   */
+  void deallocate(T* p, size_t n) {
+    if (1 == n) {
+      mPool->Free(p, sizeof(T));
+    } else {
+      ::operator delete(p);
+    }
+  }
+
+  /**
+   * Check if two allocators share a pool.
+   * @param other Allocator to compare to
+   * @return true if memory from one can be freed by the other
+   */
+  template <typename U>
+  bool operator==(const PoolAllocator<U>& other) const {
+    return mPool == other.mPool;
+  }
+
+  /**
+   * Check if two allocators do not share a pool.
+   * @param other Allocator to compare to
+   * @return true if memory from one can not be freed by the other
+   */
+  template <typename U>
+  bool operator!=(const PoolAllocator<U>& other) const {
+    return mPool != other.mPool;
+  }
+
+ private:
+  template <typename U>
+  friend class PoolAllocator;
+
+  /// Pool to allocate from
+  std::shared_ptr<BlockPool> mPool;
+};
+
+/**
+ * Pool of shared objects of a single type. Objects are created with
+ * std::allocate_shared so the object and its reference count share one
+ * pooled block which is reused once the last reference is released.
+ * Objects may outlive the pool they were created from.
+ */
+template <typename T>
+class ObjectPool {
+ public:
+  /**
+   * Create a new empty pool.
+   * @param maxFree Maximum number of freed objects to keep for reuse
+   */
+  explicit ObjectPool(size_t maxFree = 256)
+      : mBlocks(std::make_shared<BlockPool>(maxFree)) {}
+
+  /**
+   * Create a new object from the pool.
+   * @param args Arguments to pass to the constructor of the object
+   * @return Pointer to the new object
+   */
+  template <typename... Args>
+  std::shared_ptr<T> Create(Args&&... args) const {
+    return std::allocate_shared<T>(PoolAllocator<T>(mBlocks),
+                                   std::forward<Args>(args)...);
+  }
+
+  /**
+   * Get the usage statistics of the pool.
+   * @param hits Output number of objects created from reused memory
+   * @param misses Output number of objects that needed new memory
+   * @param pooled Output number of freed objects waiting for reuse
+   */
+  void GetStats(uint64_t& hits, uint64_t& misses, size_t& pooled) const {
+    mBlocks->GetStats(hits, misses, pooled);
+  }
+
+ private:
+  /// Memory blocks the objects are created in
+  std::shared_ptr<BlockPool> mBlocks;
+};
+
+}  // namespace libhack
+
+#endif  // LIBHACK_SRC_OBJECTPOOL_H
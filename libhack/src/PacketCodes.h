@@ -1733,6 +1733,10 @@ enum class InternalPacketCode_t : uint16_t {
   PACKET_WEB_GAME = 0x100C,
   /// Pass team information between the servers.
   PACKET_TEAM_UPDATE = 0x100D,
+  /// Request that the channels reload their server data.
+  PACKET_SERVER_DATA_RELOAD = 0x100E,
+  /// Request or reply with the memory usage of the channels.
+  PACKET_MEMORY_REPORT = 0x100F,
 };
 
 /**
@@ -47,6 +47,7 @@
 #include "InheritedSkill.h"
 #include "Item.h"
 #include "ItemBox.h"
+#include "MigrationProgress.h"
 #include "PentalphaEntry.h"
 #include "PentalphaMatch.h"
 #include "PostItem.h"
@@ -150,6 +151,12 @@ bool libhack::PersistentObjectInitialize() {
       typeid(objects::ItemBox), objects::ItemBox::GetMetadata(),
       []() { return (libcomp::PersistentObject*)new objects::ItemBox(); });
 
+  libcomp::PersistentObject::RegisterType(
+      typeid(objects::MigrationProgress),
+      objects::MigrationProgress::GetMetadata(), []() {
+        return (libcomp::PersistentObject*)new objects::MigrationProgress();
+      });
+
   libcomp::PersistentObject::RegisterType(
       typeid(objects::PentalphaEntry), objects::PentalphaEntry::GetMetadata(),
       []() {
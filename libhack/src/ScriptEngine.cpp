@@ -30,6 +30,7 @@
 
 // libcomp Includes
 #include "DefinitionManager.h"
+#include "MigrationRunner.h"
 #include "ServerDataManager.h"
 
 // objects Includes
@@ -39,6 +40,7 @@
 #include <BazaarItem.h>
 #include <Character.h>
 #include <Demon.h>
+#include <MigrationProgress.h>
 #include <RegisteredChannel.h>
 #include <RegisteredWorld.h>
 
@@ -81,6 +83,7 @@ void ScriptEngine::InitializeServerBuiltins() {
   // Now register the common objects you might want to access
   // from the server.
   Using<DefinitionManager>();
+  Using<MigrationRunner>();
   Using<ServerDataManager>();
 }
 
@@ -93,6 +96,7 @@ void ScriptEngine::InitializeDatabaseBuiltins() {
   Using<objects::BazaarItem>();
   Using<objects::Character>();
   Using<objects::Demon>();
+  Using<objects::MigrationProgress>();
   Using<objects::RegisteredChannel>();
   Using<objects::RegisteredWorld>();
 }
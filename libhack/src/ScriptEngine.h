@@ -30,6 +30,9 @@
 // libcomp Includes
 #include <BaseScriptEngine.h>
 
+// libhack Includes
+#include "MemoryAccounting.h"
+
 #ifndef EXOTIC_PLATFORM
 
 namespace libhack {
@@ -38,7 +41,9 @@ namespace libhack {
  * Represents a Sqrat based Squirrel virtual machine handler to facilitate
  * script execution and bind @ref Object instances to the VM.
  */
-class ScriptEngine : public libcomp::BaseScriptEngine {
+class ScriptEngine
+    : public libcomp::BaseScriptEngine,
+      private MemoryTracked<MemoryTag_t::SCRIPT_ENGINES, ScriptEngine> {
  public:
   /**
    * Create the VM.
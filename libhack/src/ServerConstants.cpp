@@ -1695,12 +1695,16 @@ bool ServerConstants::Initialize(const String& filePath) {
                          sConstants.API_ADMIN_LVL_GET_PROMOS);
   success &= LoadInteger(constants["API_ADMIN_LVL_KICK_PLAYER"],
                          sConstants.API_ADMIN_LVL_KICK_PLAYER);
+  success &= LoadInteger(constants["API_ADMIN_LVL_MEMORY_REPORT"],
+                         sConstants.API_ADMIN_LVL_MEMORY_REPORT);
   success &= LoadInteger(constants["API_ADMIN_LVL_MESSAGE_WORLD"],
                          sConstants.API_ADMIN_LVL_MESSAGE_WORLD);
   success &= LoadInteger(constants["API_ADMIN_LVL_ONLINE"],
                          sConstants.API_ADMIN_LVL_ONLINE);
   success &= LoadInteger(constants["API_ADMIN_LVL_POST_ITEMS"],
                          sConstants.API_ADMIN_LVL_POST_ITEMS);
+  success &= LoadInteger(constants["API_ADMIN_LVL_RELOAD_DATA"],
+                         sConstants.API_ADMIN_LVL_RELOAD_DATA);
   success &= LoadInteger(constants["API_ADMIN_LVL_UPDATE_ACCOUNT"],
                          sConstants.API_ADMIN_LVL_UPDATE_ACCOUNT);
 
@@ -1767,6 +1771,8 @@ bool ServerConstants::Initialize(const String& filePath) {
       LoadInteger(constants["GM_CMD_LVL_LNC"], sConstants.GM_CMD_LVL_LNC);
   success &=
       LoadInteger(constants["GM_CMD_LVL_MAP"], sConstants.GM_CMD_LVL_MAP);
+  success &= LoadInteger(constants["GM_CMD_LVL_MEMORY"],
+                         sConstants.GM_CMD_LVL_MEMORY);
   success &=
       LoadInteger(constants["GM_CMD_LVL_ONLINE"], sConstants.GM_CMD_LVL_ONLINE);
   success &= LoadInteger(constants["GM_CMD_LVL_PENALTY_RESET"],
@@ -1777,6 +1783,8 @@ bool ServerConstants::Initialize(const String& filePath) {
                          sConstants.GM_CMD_LVL_POSITION);
   success &=
       LoadInteger(constants["GM_CMD_LVL_POST"], sConstants.GM_CMD_LVL_POST);
+  success &= LoadInteger(constants["GM_CMD_LVL_RELOAD_DATA"],
+                         sConstants.GM_CMD_LVL_RELOAD_DATA);
   success &= LoadInteger(constants["GM_CMD_LVL_REPORTED"],
                          sConstants.GM_CMD_LVL_REPORTED);
   success &= LoadInteger(constants["GM_CMD_LVL_RESOLVE"],
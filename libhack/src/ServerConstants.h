@@ -655,6 +655,9 @@ class ServerConstants {
     uint32_t API_ADMIN_LVL_GET_PROMOS;
     /// Required user level for kicking an online player via the API.
     uint32_t API_ADMIN_LVL_KICK_PLAYER;
+    /// Required user level for reading the memory usage of a world's
+    /// channels via the API.
+    uint32_t API_ADMIN_LVL_MEMORY_REPORT;
     /// Required user level for messaging all players on a world via the API.
     uint32_t API_ADMIN_LVL_MESSAGE_WORLD;
     /// Required user level for checking the online count or status of a player
@@ -662,6 +665,9 @@ class ServerConstants {
     uint32_t API_ADMIN_LVL_ONLINE;
     /// Required user level for adding items to an account's post via the API.
     uint32_t API_ADMIN_LVL_POST_ITEMS;
+    /// Required user level for reloading the server data of a world via the
+    /// API.
+    uint32_t API_ADMIN_LVL_RELOAD_DATA;
     /// Required user level for updating an account via the API.
     uint32_t API_ADMIN_LVL_UPDATE_ACCOUNT;
 
@@ -729,6 +735,8 @@ class ServerConstants {
     uint32_t GM_CMD_LVL_LNC;
     /// Required user level for the @map GM command.
     uint32_t GM_CMD_LVL_MAP;
+    /// Required user level for the @memory GM command.
+    uint32_t GM_CMD_LVL_MEMORY;
     /// Required user level for the @online GM command.
     uint32_t GM_CMD_LVL_ONLINE;
     /// Required user level for the @penalty GM command.
@@ -739,6 +747,8 @@ class ServerConstants {
     uint32_t GM_CMD_LVL_POSITION;
     /// Required user level for the @post GM command.
     uint32_t GM_CMD_LVL_POST;
+    /// Required user level for the @reloaddata GM command.
+    uint32_t GM_CMD_LVL_RELOAD_DATA;
     /// Required user level for the @reported GM command.
     uint32_t GM_CMD_LVL_REPORTED;
     /// Required user level for the @resolve GM command.
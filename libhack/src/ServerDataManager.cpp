@@ -83,6 +83,12 @@
 // Standard C Includes
 #include <cmath>
 
+// Standard C++11 Includes
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 using namespace libcomp;
 using namespace libhack;
 
@@ -373,6 +379,17 @@ const std::shared_ptr<ServerScript> ServerDataManager::GetAIScript(
 
 bool ServerDataManager::LoadData(DataStore* pDataStore,
                                  DefinitionManager* definitionManager) {
+  return LoadServerData(pDataStore, definitionManager, true);
+}
+
+bool ServerDataManager::ReloadData(DataStore* pDataStore,
+                                   DefinitionManager* definitionManager) {
+  return LoadServerData(pDataStore, definitionManager, false);
+}
+
+bool ServerDataManager::LoadServerData(DataStore* pDataStore,
+                                       DefinitionManager* definitionManager,
+                                       bool registerDefinitions) {
   bool failure = false;
 
   if (definitionManager) {
@@ -420,7 +437,7 @@ bool ServerDataManager::LoadData(DataStore* pDataStore,
       }
     }
 
-    if (!failure) {
+    if (!failure && registerDefinitions) {
       LogServerDataManagerDebugMsg(
           "Loading enchant set server definitions...\n");
 
@@ -428,7 +445,7 @@ bool ServerDataManager::LoadData(DataStore* pDataStore,
           pDataStore, "/data/enchantset", definitionManager, true, true);
     }
 
-    if (!failure) {
+    if (!failure && registerDefinitions) {
       LogServerDataManagerDebugMsg(
           "Loading enchant special server definitions...\n");
 
@@ -444,21 +461,21 @@ bool ServerDataManager::LoadData(DataStore* pDataStore,
           pDataStore, "/data/fusionmistake", definitionManager, true, true);
     }
 
-    if (!failure) {
+    if (!failure && registerDefinitions) {
       LogServerDataManagerDebugMsg("Loading s-item server definitions...\n");
 
       failure = !LoadObjects<objects::MiSItemData>(
           pDataStore, "/data/sitemextended", definitionManager, true, true);
     }
 
-    if (!failure) {
+    if (!failure && registerDefinitions) {
       LogServerDataManagerDebugMsg("Loading s-status server definitions...\n");
 
       failure = !LoadObjects<objects::MiSStatusData>(
           pDataStore, "/data/sstatus", definitionManager, true, true);
     }
 
-    if (!failure) {
+    if (!failure && registerDefinitions) {
       LogServerDataManagerDebugMsg("Loading tokusei server definitions...\n");
 
       failure = !LoadObjects<objects::Tokusei>(pDataStore, "/data/tokusei",
@@ -1340,6 +1357,147 @@ ServerDataManager::GetAllZonePartialActions(
   return allActions;
 }
 
+bool ServerDataManager::ParseXmlFiles(
+    gsl::not_null<DataStore*> pDataStore,
+    const std::list<libcomp::String>& filePaths,
+    const std::function<bool(const libcomp::String&, tinyxml2::XMLDocument&)>&
+        handler) {
+  // State of a single file being parsed
+  struct ParsedFile {
+    libcomp::String Path;
+    std::shared_ptr<tinyxml2::XMLDocument> Doc;
+    bool Empty = false;
+    bool Failed = false;
+    bool Done = false;
+  };
+
+  std::vector<ParsedFile> parsed(filePaths.size());
+
+  size_t idx = 0;
+  for (auto& path : filePaths) {
+    parsed[idx++].Path = path;
+  }
+
+  size_t threadCount = std::max<size_t>(
+      1, std::min<size_t>(std::thread::hardware_concurrency(), parsed.size()));
+
+  // Limit how far ahead of the merge the workers may get.
+  size_t parseAhead = threadCount * 4;
+
+  std::mutex parseLock;
+  std::condition_variable parseCondition;
+  size_t nextParse = 0;
+  size_t nextMerge = 0;
+  bool stop = false;
+
+  auto parseNext = [&]() {
+    while (true) {
+      size_t i;
+
+      {
+        std::unique_lock<std::mutex> lock(parseLock);
+        parseCondition.wait(lock, [&]() {
+          return stop || nextParse >= parsed.size() ||
+                 nextParse < nextMerge + parseAhead;
+        });
+
+        if (stop || nextParse >= parsed.size()) {
+          return;
+        }
+
+        i = nextParse++;
+      }
+
+      auto& file = parsed[i];
+      auto doc = std::make_shared<tinyxml2::XMLDocument>();
+      bool empty = false;
+      bool failed = false;
+
+      std::vector<char> data = pDataStore->ReadFile(file.Path);
+
+      if (data.empty()) {
+        empty = true;
+      } else if (tinyxml2::XML_SUCCESS != doc->Parse(&data[0], data.size()) ||
+                 nullptr == doc->RootElement()) {
+        failed = true;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(parseLock);
+        file.Doc = doc;
+        file.Empty = empty;
+        file.Failed = failed;
+        file.Done = true;
+      }
+
+      parseCondition.notify_all();
+    }
+  };
+
+  std::list<std::thread> threads;
+
+  for (size_t i = 0; i < threadCount; i++) {
+    threads.push_back(std::thread(parseNext));
+  }
+
+  bool success = true;
+
+  // Merge on this thread in the original file order.
+  for (size_t i = 0; i < parsed.size(); i++) {
+    std::shared_ptr<tinyxml2::XMLDocument> doc;
+    bool empty, failed;
+
+    {
+      std::unique_lock<std::mutex> lock(parseLock);
+      parseCondition.wait(lock, [&]() { return parsed[i].Done; });
+
+      doc = parsed[i].Doc;
+      empty = parsed[i].Empty;
+      failed = parsed[i].Failed;
+
+      // Free the document once it has been handled.
+      parsed[i].Doc = nullptr;
+      nextMerge = i + 1;
+    }
+
+    parseCondition.notify_all();
+
+    const libcomp::String& path = parsed[i].Path;
+
+    if (empty) {
+      LogServerDataManagerWarning([&]() {
+        return libcomp::String("File does not exist or is empty: %1\n")
+            .Arg(path);
+      });
+    } else if (failed) {
+      LogServerDataManagerError([&]() {
+        return libcomp::String("Failed to parse XML file: %1\n").Arg(path);
+      });
+
+      success = false;
+    } else if (!handler(path, *doc)) {
+      success = false;
+    }
+
+    if (!success) {
+      break;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(parseLock);
+    stop = true;
+  }
+
+  parseCondition.notify_all();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return success;
+}
+
 bool ServerDataManager::LoadScripts(
     gsl::not_null<DataStore*> pDataStore, const libcomp::String& datastorePath,
     std::function<bool(ServerDataManager&, const libcomp::String&,
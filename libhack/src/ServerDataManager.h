@@ -289,6 +289,20 @@ class ServerDataManager {
   bool LoadData(libcomp::DataStore* pDataStore,
                 DefinitionManager* definitionManager);
 
+  /**
+   * Load all server data definitions in the data store into a new
+   * ServerDataManager that will replace one already in use. Server side
+   * definitions registered with the definition manager are not loaded
+   * again as the definition manager is shared by every copy of the
+   * server data and cannot be changed while it is being read.
+   * @param pDataStore Pointer to the datastore to load binary files from
+   * @param definitionManager Pointer to the definition manager that
+   *  was loaded with the server side definitions
+   * @return true on success, false on failure
+   */
+  bool ReloadData(libcomp::DataStore* pDataStore,
+                  DefinitionManager* definitionManager);
+
   /**
    * Verify all loaded server data definitions for non-critical errors.
    * Checks include invalid event ID and item/shop product type references.
@@ -398,6 +412,20 @@ class ServerDataManager {
       bool includeNested);
 
  private:
+  /**
+   * Load all server data definitions in the data store
+   * @param pDataStore Pointer to the datastore to load binary files from
+   * @param definitionManager Pointer to the definition manager to load
+   *  server side definitions with
+   * @param registerDefinitions true if server side definitions should
+   *  be registered with the definition manager, false if they are
+   *  already registered and should be skipped
+   * @return true on success, false on failure
+   */
+  bool LoadServerData(libcomp::DataStore* pDataStore,
+                      DefinitionManager* definitionManager,
+                      bool registerDefinitions);
+
   /**
    * Get a server object by ID from the supplied map of the specified
    * key and value type
@@ -417,7 +445,9 @@ class ServerDataManager {
   }
 
   /**
-   * Load all objects from files in a datastore path
+   * Load all objects from files in a datastore path. The files are read
+   * and parsed in parallel but the objects are loaded one file at a time
+   * in listing order so overrides apply exactly as they would serially.
    * @param pDataStore Pointer to the datastore to use
    * @param datastorePath Path within the data store to load files from
    * @param definitionManager Pointer to the definition manager which
@@ -439,24 +469,24 @@ class ServerDataManager {
     (void)pDataStore->GetListing(datastorePath, files, dirs, symLinks,
                                  recursive, true);
 
-    bool loaded = false;
+    std::list<libcomp::String> xmlFiles;
     for (auto path : files) {
       if (path.Matches("^.*\\.xml$")) {
-        if (LoadObjectsFromFile<T>(pDataStore, path, definitionManager)) {
-          loaded = true;
-        } else {
-          return false;
-        }
+        xmlFiles.push_back(path);
       }
     }
 
-    if (!loaded && fileOrPath) {
+    if (xmlFiles.empty() && fileOrPath) {
       // Attempt to load single file from modified path
       return LoadObjectsFromFile<T>(pDataStore, datastorePath + ".xml",
                                     definitionManager);
-    } else {
-      return true;
     }
+
+    return ParseXmlFiles(
+        pDataStore, xmlFiles,
+        [&](const libcomp::String& path, tinyxml2::XMLDocument& doc) {
+          return LoadObjectsFromDocument<T>(doc, path, definitionManager);
+        });
   }
 
   /**
@@ -471,23 +501,26 @@ class ServerDataManager {
   bool LoadObjectsFromFile(gsl::not_null<libcomp::DataStore*> pDataStore,
                            const libcomp::String& filePath,
                            DefinitionManager* definitionManager = nullptr) {
-    tinyxml2::XMLDocument objsDoc;
-
-    std::vector<char> data = pDataStore->ReadFile(filePath);
-
-    if (data.empty()) {
-      LogServerDataManagerWarning([&]() {
-        return libcomp::String("File does not exist or is empty: %1\n")
-            .Arg(filePath);
-      });
-
-      return true;
-    }
-
-    if (tinyxml2::XML_SUCCESS != objsDoc.Parse(&data[0], data.size())) {
-      return false;
-    }
+    return ParseXmlFiles(
+        pDataStore, std::list<libcomp::String>{filePath},
+        [&](const libcomp::String& path, tinyxml2::XMLDocument& doc) {
+          return LoadObjectsFromDocument<T>(doc, path, definitionManager);
+        });
+  }
 
+  /**
+   * Load all objects from a parsed XML file
+   * @param objsDoc Parsed XML document to load from
+   * @param filePath File path within the data store the document was
+   *  parsed from
+   * @param definitionManager Pointer to the definition manager which
+   *  will be loaded with any server side definitions
+   * @return true on success, false on failure
+   */
+  template <class T>
+  bool LoadObjectsFromDocument(const tinyxml2::XMLDocument& objsDoc,
+                               const libcomp::String& filePath,
+                               DefinitionManager* definitionManager) {
     const tinyxml2::XMLElement* rootNode = objsDoc.RootElement();
     const tinyxml2::XMLElement* objNode = rootNode->FirstChildElement("object");
 
@@ -510,6 +543,24 @@ class ServerDataManager {
     return true;
   }
 
+  /**
+   * Read and parse XML files on worker threads and pass each parsed
+   * document to the handler on the calling thread in the order the
+   * files were supplied. Only a limited number of documents are parsed
+   * ahead of the handler to bound memory use. Missing or empty files
+   * are skipped with a warning.
+   * @param pDataStore Pointer to the datastore to use
+   * @param filePaths File paths within the data store to parse
+   * @param handler Function to call with each parsed document that
+   *  returns true on success or false to stop
+   * @return true if every file was parsed and handled, false otherwise
+   */
+  bool ParseXmlFiles(
+      gsl::not_null<libcomp::DataStore*> pDataStore,
+      const std::list<libcomp::String>& filePaths,
+      const std::function<bool(const libcomp::String&,
+                               tinyxml2::XMLDocument&)>& handler);
+
   /**
    * Load an object of the templated type from an XML node
    * @param doc XML document being loaded from
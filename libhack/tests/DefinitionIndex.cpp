@@ -0,0 +1,175 @@
+/**
+ * @file libhack/tests/DefinitionIndex.cpp
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Test the flat definition lookup tables.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Ignore warnings
+#include <PushIgnore.h>
+
+#include <gtest/gtest.h>
+
+// Stop ignoring warnings
+#include <PopIgnore.h>
+
+// libhack Includes
+#include <DefinitionIndex.h>
+
+// Standard C++11 Includes
+#include <cstdint>
+#include <random>
+
+using namespace libhack;
+
+namespace {
+
+/// Stand-in for a definition object
+struct Definition {
+  uint32_t ID;
+};
+
+typedef std::unordered_map<uint32_t, std::shared_ptr<Definition>> DefinitionMap;
+
+void Add(DefinitionMap& data, uint32_t id) {
+  auto def = std::make_shared<Definition>();
+  def->ID = id;
+
+  data[id] = def;
+}
+
+/// Check every ID up to the given maximum against the map
+void CheckAgainstMap(const DefinitionMap& data,
+                     const DefinitionIndex<Definition>& index,
+                     uint32_t maxID) {
+  for (uint32_t id = 0; id <= maxID; id++) {
+    auto it = data.find(id);
+
+    if (it == data.end()) {
+      EXPECT_EQ(nullptr, index.Get(id)) << "ID " << id;
+    } else {
+      EXPECT_EQ(it->second.get(), index.Get(id)) << "ID " << id;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(DefinitionIndex, Empty) {
+  DefinitionMap data;
+  DefinitionIndex<Definition> index;
+
+  EXPECT_FALSE(index.IsBuilt());
+  EXPECT_EQ(nullptr, index.Get(0));
+
+  index.Build(data);
+
+  EXPECT_TRUE(index.IsBuilt());
+  EXPECT_EQ(nullptr, index.Get(0));
+  EXPECT_EQ(nullptr, index.Get(1));
+  EXPECT_EQ(nullptr, index.Get(UINT32_MAX));
+}
+
+TEST(DefinitionIndex, Dense) {
+  DefinitionMap data;
+
+  // Close together IDs with a few gaps, like skill or status IDs.
+  for (uint32_t id = 0; id < 2000; id++) {
+    if (id % 7) {
+      Add(data, id);
+    }
+  }
+
+  DefinitionIndex<Definition> index;
+  index.Build(data);
+
+  CheckAgainstMap(data, index, 2100);
+  EXPECT_EQ(nullptr, index.Get(UINT32_MAX));
+}
+
+TEST(DefinitionIndex, Sparse) {
+  DefinitionMap data;
+
+  // Spread out IDs, like item IDs.
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<uint32_t> dist(0, UINT32_MAX);
+
+  for (int i = 0; i < 5000; i++) {
+    Add(data, dist(rng));
+  }
+
+  Add(data, 0);
+  Add(data, UINT32_MAX);
+
+  DefinitionIndex<Definition> index;
+  index.Build(data);
+
+  for (auto& pair : data) {
+    EXPECT_EQ(pair.second.get(), index.Get(pair.first))
+        << "ID " << pair.first;
+  }
+
+  for (int i = 0; i < 5000; i++) {
+    uint32_t id = dist(rng);
+
+    auto it = data.find(id);
+    EXPECT_EQ(it == data.end() ? nullptr : it->second.get(), index.Get(id))
+        << "ID " << id;
+  }
+
+  CheckAgainstMap(data, index, 1000);
+}
+
+TEST(DefinitionIndex, Rebuild) {
+  DefinitionMap data;
+
+  for (uint32_t id = 1; id <= 100; id++) {
+    Add(data, id);
+  }
+
+  DefinitionIndex<Definition> index;
+  index.Build(data);
+  CheckAgainstMap(data, index, 200);
+
+  // Switching from a dense to a sparse table drops the old entries.
+  data.clear();
+  Add(data, 50);
+  Add(data, 100000000);
+
+  index.Build(data);
+  CheckAgainstMap(data, index, 200);
+  EXPECT_EQ(data[100000000].get(), index.Get(100000000));
+
+  // And back again.
+  data.clear();
+  Add(data, 3);
+
+  index.Build(data);
+  CheckAgainstMap(data, index, 200);
+  EXPECT_EQ(nullptr, index.Get(100000000));
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,179 @@
+/**
+ * @file libhack/tests/MemoryStream.cpp
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Test the memory input stream against std::stringstream.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Ignore warnings
+#include <PushIgnore.h>
+
+#include <gtest/gtest.h>
+
+// Stop ignoring warnings
+#include <PopIgnore.h>
+
+// libhack Includes
+#include <MemoryStream.h>
+
+// Standard C++11 Includes
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace libhack;
+
+namespace {
+
+/// Data with every byte value so nothing is treated as a terminator
+std::string CreateData() {
+  std::string data;
+
+  for (int i = 0; i < 1024; i++) {
+    data.push_back((char)(i & 0xFF));
+  }
+
+  return data;
+}
+
+}  // namespace
+
+TEST(MemoryStream, ReadAll) {
+  std::string data = CreateData();
+  MemoryInStream in(data);
+
+  std::vector<char> out(data.size());
+  ASSERT_TRUE(in.read(out.data(), (std::streamsize)out.size()));
+  EXPECT_EQ(data, std::string(out.begin(), out.end()));
+
+  // Reading past the end fails like any other stream.
+  char c;
+  EXPECT_FALSE(in.read(&c, 1));
+  EXPECT_TRUE(in.eof());
+}
+
+TEST(MemoryStream, NoCopy) {
+  std::vector<char> data(16, 'x');
+  MemoryInStream in(data);
+
+  // The stream reads the memory in place so changes are visible.
+  data[0] = 'y';
+
+  char c = 0;
+  ASSERT_TRUE(in.read(&c, 1));
+  EXPECT_EQ('y', c);
+}
+
+TEST(MemoryStream, Empty) {
+  MemoryInStream in(nullptr, 0);
+
+  char c;
+  EXPECT_FALSE(in.read(&c, 1));
+  EXPECT_EQ(0, in.gcount());
+}
+
+TEST(MemoryStream, ShortRead) {
+  std::string data = CreateData();
+  MemoryInStream in(data.data(), 10);
+
+  char out[16];
+  EXPECT_FALSE(in.read(out, sizeof(out)));
+  EXPECT_EQ(10, in.gcount());
+}
+
+TEST(MemoryStream, MatchStringStream) {
+  std::string data = CreateData();
+
+  MemoryInStream in(data);
+  std::stringstream ss(data);
+
+  // Seek and read the same way through both streams.
+  struct Step {
+    std::streamoff Offset;
+    std::ios_base::seekdir Dir;
+    size_t ReadSize;
+  };
+
+  Step steps[] = {
+      {0, std::ios_base::beg, 4},    {100, std::ios_base::beg, 8},
+      {16, std::ios_base::cur, 2},   {-50, std::ios_base::cur, 32},
+      {-8, std::ios_base::end, 8},   {0, std::ios_base::beg, 1024},
+      {512, std::ios_base::beg, 0},  {-1024, std::ios_base::end, 3},
+  };
+
+  for (auto& step : steps) {
+    in.clear();
+    ss.clear();
+
+    in.seekg(step.Offset, step.Dir);
+    ss.seekg(step.Offset, step.Dir);
+
+    ASSERT_EQ(ss.tellg(), in.tellg());
+
+    std::vector<char> a(step.ReadSize);
+    std::vector<char> b(step.ReadSize);
+
+    in.read(a.data(), (std::streamsize)a.size());
+    ss.read(b.data(), (std::streamsize)b.size());
+
+    EXPECT_EQ(ss.gcount(), in.gcount());
+    EXPECT_EQ(b, a);
+    EXPECT_EQ(ss.tellg(), in.tellg());
+  }
+
+  // Absolute seeks work too.
+  in.clear();
+  in.seekg(std::streampos(300));
+  EXPECT_EQ(std::streampos(300), in.tellg());
+  EXPECT_EQ((char)(300 & 0xFF), (char)in.get());
+}
+
+TEST(MemoryStream, SeekOutOfRange) {
+  std::string data = CreateData();
+  MemoryInStream in(data);
+
+  in.seekg(10);
+  ASSERT_TRUE(in.good());
+
+  in.seekg(-1, std::ios_base::beg);
+  EXPECT_TRUE(in.fail());
+
+  in.clear();
+  in.seekg(1, std::ios_base::end);
+  EXPECT_TRUE(in.fail());
+
+  // A failed seek leaves the read position alone.
+  in.clear();
+  EXPECT_EQ(std::streampos(10), in.tellg());
+
+  // Seeking to the very end is allowed.
+  in.seekg(0, std::ios_base::end);
+  EXPECT_TRUE(in.good());
+  EXPECT_EQ(std::streampos((std::streamoff)data.size()), in.tellg());
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,276 @@
+/**
+ * @file libhack/tests/MigrationRunner.cpp
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Test batching and resuming in the migration runner.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Ignore warnings
+#include <PushIgnore.h>
+
+#include <gtest/gtest.h>
+
+// Stop ignoring warnings
+#include <PopIgnore.h>
+
+// libhack Includes
+#include <MigrationRunner.h>
+#include <PersistentObjectInitialize.h>
+
+// objects Includes
+#include <MigrationProgress.h>
+
+// Standard C++11 Includes
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace libhack;
+
+namespace {
+
+/// In memory stand in for the table and checkpoint a runner migrates
+struct TestTable {
+  /// Records to migrate ordered by UID
+  std::map<std::string, std::shared_ptr<libcomp::PersistentObject>> Records;
+
+  /// Last saved checkpoint or null if nothing has been saved
+  std::shared_ptr<objects::MigrationProgress> Progress;
+
+  /// Number of records returned by each batch load
+  std::vector<size_t> Loads;
+
+  /// Number of change sets saved
+  size_t Saves = 0;
+};
+
+/// Migration runner reading and writing a TestTable instead of a database
+class TestRunner : public MigrationRunner {
+ public:
+  explicit TestRunner(TestTable& table)
+      : MigrationRunner("test", nullptr, "MigrationProgress"),
+        mTable(table) {}
+
+ protected:
+  virtual std::shared_ptr<objects::MigrationProgress> LoadProgress() {
+    if (mTable.Progress) {
+      mLive = std::make_shared<objects::MigrationProgress>(*mTable.Progress);
+    } else {
+      mLive = std::make_shared<objects::MigrationProgress>();
+      mLive->SetName(mName);
+    }
+
+    return mLive;
+  }
+
+  virtual bool CountRemaining(const libobjgen::UUID& lastUID,
+                              uint64_t& remaining) {
+    remaining = 0;
+
+    for (auto it = After(lastUID); it != mTable.Records.end(); it++) {
+      remaining++;
+    }
+
+    return true;
+  }
+
+  virtual bool LoadBatch(
+      const libobjgen::UUID& lastUID, uint32_t count,
+      std::list<std::shared_ptr<libcomp::PersistentObject>>& records) {
+    for (auto it = After(lastUID);
+         it != mTable.Records.end() && records.size() < count; it++) {
+      records.push_back(it->second);
+    }
+
+    mTable.Loads.push_back(records.size());
+
+    return true;
+  }
+
+  virtual bool SaveBatch(
+      const std::shared_ptr<libcomp::DatabaseChangeSet>& changes) {
+    (void)changes;
+
+    mTable.Progress = std::make_shared<objects::MigrationProgress>(*mLive);
+    mTable.Saves++;
+
+    return true;
+  }
+
+ private:
+  std::map<std::string,
+           std::shared_ptr<libcomp::PersistentObject>>::const_iterator
+  After(const libobjgen::UUID& lastUID) const {
+    if (lastUID.IsNull()) {
+      return mTable.Records.begin();
+    }
+
+    return mTable.Records.upper_bound(lastUID.ToString().ToUtf8());
+  }
+
+  TestTable& mTable;
+
+  std::shared_ptr<objects::MigrationProgress> mLive;
+};
+
+void AddRecords(TestTable& table, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    auto record =
+        libcomp::PersistentObject::New<objects::MigrationProgress>(true);
+
+    table.Records[record->GetUUID().ToString().ToUtf8()] = record;
+  }
+}
+
+std::vector<std::shared_ptr<libcomp::PersistentObject>> OrderedRecords(
+    const TestTable& table) {
+  std::vector<std::shared_ptr<libcomp::PersistentObject>> records;
+
+  for (auto& pair : table.Records) {
+    records.push_back(pair.second);
+  }
+
+  return records;
+}
+
+}  // namespace
+
+TEST(MigrationRunner, RunInBatches) {
+  TestTable table;
+  AddRecords(table, 1050);
+
+  std::vector<std::shared_ptr<libcomp::PersistentObject>> visited;
+
+  TestRunner runner(table);
+  runner.SetBatchSize(100);
+
+  EXPECT_TRUE(
+      runner.Run([&](const std::shared_ptr<libcomp::PersistentObject>& obj) {
+        visited.push_back(obj);
+
+        return true;
+      }));
+
+  // Every record once in UID order
+  EXPECT_EQ(OrderedRecords(table), visited);
+
+  // Ten full batches, the rest and an empty load to find the end
+  std::vector<size_t> loads(10, 100);
+  loads.push_back(50);
+  loads.push_back(0);
+  EXPECT_EQ(loads, table.Loads);
+
+  // One save per batch and one to mark the migration complete
+  EXPECT_EQ((size_t)12, table.Saves);
+
+  ASSERT_TRUE(table.Progress);
+  EXPECT_TRUE(table.Progress->GetComplete());
+  EXPECT_EQ((uint64_t)1050, table.Progress->GetProcessed());
+  EXPECT_EQ((uint64_t)1050, runner.GetProcessed());
+}
+
+TEST(MigrationRunner, ResumeAfterFailure) {
+  TestTable table;
+  AddRecords(table, 1000);
+
+  auto ordered = OrderedRecords(table);
+
+  // Fail in the middle of the third batch as if the run was killed there
+  size_t calls = 0;
+
+  {
+    TestRunner runner(table);
+    runner.SetBatchSize(100);
+
+    EXPECT_FALSE(
+        runner.Run([&](const std::shared_ptr<libcomp::PersistentObject>&) {
+          return ++calls < 250;
+        }));
+  }
+
+  ASSERT_TRUE(table.Progress);
+  EXPECT_FALSE(table.Progress->GetComplete());
+  EXPECT_EQ((uint64_t)200, table.Progress->GetProcessed());
+  EXPECT_EQ(ordered[199]->GetUUID(), table.Progress->GetLastUID());
+
+  // The next run starts at the first record of the unsaved batch
+  std::vector<std::shared_ptr<libcomp::PersistentObject>> visited;
+
+  {
+    TestRunner runner(table);
+    runner.SetBatchSize(100);
+
+    EXPECT_TRUE(
+        runner.Run([&](const std::shared_ptr<libcomp::PersistentObject>& obj) {
+          visited.push_back(obj);
+
+          return true;
+        }));
+  }
+
+  EXPECT_EQ(std::vector<std::shared_ptr<libcomp::PersistentObject>>(
+                ordered.begin() + 200, ordered.end()),
+            visited);
+
+  EXPECT_TRUE(table.Progress->GetComplete());
+  EXPECT_EQ((uint64_t)1000, table.Progress->GetProcessed());
+}
+
+TEST(MigrationRunner, ResumeComplete) {
+  TestTable table;
+  AddRecords(table, 10);
+
+  size_t calls = 0;
+  auto count = [&](const std::shared_ptr<libcomp::PersistentObject>&) {
+    calls++;
+
+    return true;
+  };
+
+  EXPECT_TRUE(TestRunner(table).Run(count));
+  EXPECT_EQ((size_t)10, calls);
+
+  size_t saves = table.Saves;
+
+  // A completed migration does not load or save anything again
+  EXPECT_TRUE(TestRunner(table).Run(count));
+  EXPECT_EQ((size_t)10, calls);
+  EXPECT_EQ(saves, table.Saves);
+}
+
+TEST(MigrationRunner, UnknownType) {
+  MigrationRunner runner("test", nullptr, "NotAnObjectType");
+
+  EXPECT_FALSE(
+      runner.Run([](const std::shared_ptr<libcomp::PersistentObject>&) {
+        return true;
+      }));
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  libhack::PersistentObjectInitialize();
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,225 @@
+/**
+ * @file libhack/tests/ObjectPool.cpp
+ * @ingroup libhack
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Test the pooled object and memory block allocators.
+ *
+ * This file is part of the COMP_hack Library (libhack).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Ignore warnings
+#include <PushIgnore.h>
+
+#include <gtest/gtest.h>
+
+// Stop ignoring warnings
+#include <PopIgnore.h>
+
+// libhack Includes
+#include <ObjectPool.h>
+
+// Standard C++11 Includes
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <thread>
+
+using namespace libhack;
+
+namespace {
+
+/// Number of live test objects
+std::atomic<int> gLiveObjects(0);
+
+/// Object that tracks construction and destruction
+class TestObject {
+ public:
+  TestObject(int32_t value, const std::string& name)
+      : mValue(value), mName(name) {
+    gLiveObjects++;
+  }
+
+  ~TestObject() { gLiveObjects--; }
+
+  int32_t GetValue() const { return mValue; }
+
+  std::string GetName() const { return mName; }
+
+ private:
+  int32_t mValue;
+  std::string mName;
+};
+
+}  // namespace
+
+TEST(BlockPool, Reuse) {
+  BlockPool pool(2);
+
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  size_t pooled = 0;
+
+  void* pFirst = pool.Allocate(32);
+  void* pSecond = pool.Allocate(32);
+  void* pThird = pool.Allocate(32);
+
+  pool.GetStats(hits, misses, pooled);
+  EXPECT_EQ(0u, hits);
+  EXPECT_EQ(3u, misses);
+  EXPECT_EQ(0u, pooled);
+
+  // Only two blocks are kept, the third goes back to the system.
+  pool.Free(pFirst, 32);
+  pool.Free(pSecond, 32);
+  pool.Free(pThird, 32);
+
+  pool.GetStats(hits, misses, pooled);
+  EXPECT_EQ(2u, pooled);
+
+  // Freed blocks are reused last in, first out.
+  EXPECT_EQ(pSecond, pool.Allocate(32));
+  EXPECT_EQ(pFirst, pool.Allocate(32));
+
+  pool.GetStats(hits, misses, pooled);
+  EXPECT_EQ(2u, hits);
+  EXPECT_EQ(3u, misses);
+  EXPECT_EQ(0u, pooled);
+
+  pool.Free(pFirst, 32);
+  pool.Free(pSecond, 32);
+}
+
+TEST(BlockPool, OtherSize) {
+  BlockPool pool(4);
+
+  void* pBlock = pool.Allocate(16);
+  pool.Free(pBlock, 16);
+
+  // Blocks of another size never come from or go to the pool.
+  void* pLarge = pool.Allocate(64);
+  pool.Free(pLarge, 64);
+
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  size_t pooled = 0;
+
+  pool.GetStats(hits, misses, pooled);
+  EXPECT_EQ(0u, hits);
+  EXPECT_EQ(2u, misses);
+  EXPECT_EQ(1u, pooled);
+
+  EXPECT_EQ(pBlock, pool.Allocate(16));
+  pool.Free(pBlock, 16);
+}
+
+TEST(ObjectPool, Create) {
+  ObjectPool<TestObject> pool;
+
+  {
+    auto obj = pool.Create(42, "test");
+
+    ASSERT_NE(nullptr, obj);
+    EXPECT_EQ(42, obj->GetValue());
+    EXPECT_EQ("test", obj->GetName());
+    EXPECT_EQ(1, gLiveObjects);
+  }
+
+  EXPECT_EQ(0, gLiveObjects);
+
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  size_t pooled = 0;
+
+  pool.GetStats(hits, misses, pooled);
+  EXPECT_EQ(0u, hits);
+  EXPECT_EQ(1u, misses);
+  EXPECT_EQ(1u, pooled);
+
+  // The next object reuses the block of the first.
+  auto obj = pool.Create(7, "again");
+  EXPECT_EQ(7, obj->GetValue());
+
+  pool.GetStats(hits, misses, pooled);
+  EXPECT_EQ(1u, hits);
+  EXPECT_EQ(1u, misses);
+  EXPECT_EQ(0u, pooled);
+}
+
+TEST(ObjectPool, OutlivePool) {
+  std::shared_ptr<TestObject> obj;
+
+  {
+    ObjectPool<TestObject> pool;
+    obj = pool.Create(1, "outlive");
+  }
+
+  // The blocks stay alive until the last object is freed.
+  EXPECT_EQ(1, obj->GetValue());
+  EXPECT_EQ("outlive", obj->GetName());
+
+  obj.reset();
+  EXPECT_EQ(0, gLiveObjects);
+}
+
+TEST(ObjectPool, Threads) {
+  ObjectPool<TestObject> pool(64);
+
+  const int kThreads = 4;
+  const int kObjects = 10000;
+
+  std::list<std::thread> threads;
+
+  for (int t = 0; t < kThreads; t++) {
+    threads.push_back(std::thread([&pool, t]() {
+      std::list<std::shared_ptr<TestObject>> objs;
+
+      for (int i = 0; i < kObjects; i++) {
+        objs.push_back(pool.Create(t * kObjects + i, "thread"));
+
+        // Free on the way so blocks move between threads.
+        if (objs.size() > 32) {
+          objs.pop_front();
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(0, gLiveObjects);
+
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  size_t pooled = 0;
+
+  pool.GetStats(hits, misses, pooled);
+  EXPECT_EQ((uint64_t)(kThreads * kObjects), hits + misses);
+  EXPECT_GT(hits, misses);
+  EXPECT_LE(pooled, 64u);
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
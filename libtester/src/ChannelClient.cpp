@@ -32,6 +32,9 @@
 // Google Test Includes
 #include <gtest/gtest.h>
 
+// tinyxml2 Includes
+#include <tinyxml2.h>
+
 // Stop ignoring warnings
 #include <PopIgnore.h>
 
@@ -41,15 +44,22 @@
 #include <TestConfig.h>
 
 // libhack Includes
+#include <AccountDump.h>
 #include <Constants.h>
+#include <MemoryStream.h>
 
 // libcomp Includes
 #include <ChannelConnection.h>
 #include <ScriptEngine.h>
 
 // object Includes
+#include <FriendSettings.h>
 #include <PacketLogin.h>
 
+// Standard C++11 Includes
+#include <list>
+#include <sstream>
+
 #include "ServerTest.h"
 
 using namespace libtester;
@@ -217,6 +227,122 @@ bool ChannelClient::AmalaRequestAccountDump() {
   return true;
 }
 
+bool ChannelClient::VerifyAccountDump() {
+  ASSERT_FALSE_OR_RETURN(mAccountDumpData.empty());
+
+  // Binary serialization of each object in the binary dump
+  std::list<std::pair<libcomp::String, std::string>> objects;
+
+  {
+    libhack::MemoryInStream in(mAccountDumpData);
+    libhack::AccountDumpReader reader(in);
+
+    libcomp::String objectType;
+    libobjgen::UUID uuid;
+    std::shared_ptr<libcomp::PersistentObject> obj;
+
+    while (reader.ReadObject(objectType, uuid, obj)) {
+      // References to other players and server managed data are not
+      // dumped.
+      auto character = std::dynamic_pointer_cast<objects::Character>(obj);
+
+      if (character) {
+        ASSERT_TRUE_OR_RETURN(character->GetClan().IsNull());
+        ASSERT_TRUE_OR_RETURN(character->GetDemonQuest().IsNull());
+        ASSERT_TRUE_OR_RETURN(character->GetCultureData().IsNull());
+        ASSERT_TRUE_OR_RETURN(character->GetPvPData().IsNull());
+      }
+
+      auto friendSettings =
+          std::dynamic_pointer_cast<objects::FriendSettings>(obj);
+
+      if (friendSettings) {
+        ASSERT_TRUE_OR_RETURN(friendSettings->GetFriends().empty());
+      }
+
+      std::stringstream ss;
+      ASSERT_TRUE_OR_RETURN(obj->Save(ss));
+
+      objects.push_back(std::make_pair(uuid.ToString(), ss.str()));
+    }
+
+    ASSERT_TRUE_OR_RETURN_MSG(reader.GetError().IsEmpty(),
+                              reader.GetError().ToUtf8());
+  }
+
+  ASSERT_FALSE_OR_RETURN(objects.empty());
+
+  // The account being dumped is still in the database so the lobby must
+  // read the first object and then reject it as a duplicate.
+  auto duplicateError =
+      libcomp::String("Object with UUID '%1' already exists in database.")
+          .Arg(objects.front().first);
+
+  libcomp::String importError;
+  ASSERT_TRUE_OR_RETURN(Login::ImportAccount(
+      std::string(mAccountDumpData.begin(), mAccountDumpData.end()),
+      importError));
+  ASSERT_EQ_OR_RETURN(duplicateError.ToUtf8(), importError.ToUtf8());
+
+  // Convert the dump to XML and make sure every object loads back the
+  // same as it was in the binary dump.
+  std::stringstream xml;
+
+  {
+    libhack::MemoryInStream in(mAccountDumpData);
+    libcomp::String error = libhack::AccountDumpReader::ConvertToXml(in, xml);
+
+    ASSERT_TRUE_OR_RETURN_MSG(error.IsEmpty(), error.ToUtf8());
+  }
+
+  std::string xmlData = xml.str();
+
+  // The converted dump must be accepted by the same lobby import path.
+  libcomp::String xmlImportError;
+  ASSERT_TRUE_OR_RETURN(Login::ImportAccount(xmlData, xmlImportError));
+  ASSERT_EQ_OR_RETURN(duplicateError.ToUtf8(), xmlImportError.ToUtf8());
+
+  tinyxml2::XMLDocument doc;
+  ASSERT_EQ_OR_RETURN(tinyxml2::XML_SUCCESS,
+                      doc.Parse(xmlData.c_str(), xmlData.size()));
+  ASSERT_TRUE_OR_RETURN(doc.RootElement());
+
+  const tinyxml2::XMLElement* pObject =
+      doc.RootElement()->FirstChildElement("object");
+
+  for (auto& binaryObject : objects) {
+    ASSERT_TRUE_OR_RETURN(pObject);
+
+    auto typeExists = false;
+    auto typeHash = libcomp::PersistentObject::GetTypeHashByName(
+        pObject->Attribute("name"), typeExists);
+    ASSERT_TRUE_OR_RETURN(typeExists);
+
+    const tinyxml2::XMLElement* pMember = pObject->FirstChildElement("member");
+    ASSERT_TRUE_OR_RETURN(pMember && pMember->GetText());
+    ASSERT_EQ_OR_RETURN(std::string("UUID"),
+                        std::string(pMember->Attribute("name")));
+    ASSERT_EQ_OR_RETURN(binaryObject.first.ToUtf8(),
+                        std::string(pMember->GetText()));
+
+    auto obj = libcomp::PersistentObject::New(typeHash);
+    ASSERT_TRUE_OR_RETURN(obj);
+    ASSERT_TRUE_OR_RETURN(obj->Load(doc, *pObject));
+
+    std::stringstream ss;
+    ASSERT_TRUE_OR_RETURN(obj->Save(ss));
+    ASSERT_TRUE_OR_RETURN_MSG(binaryObject.second == ss.str(),
+                              "Object " << binaryObject.first.ToUtf8()
+                                        << " changed in the XML dump.");
+
+    pObject = pObject->NextSiblingElement("object");
+  }
+
+  ASSERT_FALSE_OR_RETURN(pObject);
+
+  return true;
+}
+
 bool ChannelClient::Say(const libcomp::String& msg) {
   libcomp::Packet p;
   p.WritePacketCode(ClientToChannelPacketCode_t::PACKET_CHAT);
@@ -401,6 +527,7 @@ BaseScriptEngine& BaseScriptEngine::Using<ChannelClient>() {
     binding.Func("SendPopulateZone", &ChannelClient::SendPopulateZone);
     binding.Func("AmalaRequestAccountDump",
                  &ChannelClient::AmalaRequestAccountDump);
+    binding.Func("VerifyAccountDump", &ChannelClient::VerifyAccountDump);
     binding.Func("GetEntityID", &ChannelClient::GetEntityID);
     binding.Func("GetActivationID", &ChannelClient::GetActivationID);
     binding.Func("GetDemonID", &ChannelClient::GetDemonID);
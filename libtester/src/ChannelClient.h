@@ -60,6 +60,7 @@ class ChannelClient : public TestClient {
   bool SendPopulateZone();
 
   bool AmalaRequestAccountDump();
+  bool VerifyAccountDump();
 
   bool Say(const libcomp::String& msg);
 
@@ -23,14 +23,14 @@ void ChannelClient::HandleAmalaAccountDumpPart(libcomp::ReadOnlyPacket &p) {
 
     if (checksum == mAccountDumpChecksum) {
       FILE *out = fopen(
-          libcomp::String("%1.xml").Arg(mAccountDumpAccountName).C(), "wb");
+          libcomp::String("%1.dump").Arg(mAccountDumpAccountName).C(), "wb");
 
       if (!out ||
           1 != fwrite(&mAccountDumpData[0], mAccountDumpData.size(), 1, out)) {
         LogGeneralErrorMsg("Failed to write account dump to disk.\n");
       } else {
         LogGeneralInfo([&]() {
-          return libcomp::String("Wrote backup of account '%1' to '%2.xml'\n")
+          return libcomp::String("Wrote backup of account '%1' to '%2.dump'\n")
               .Arg(mAccountDumpAccountName)
               .Arg(mAccountDumpAccountName);
         });
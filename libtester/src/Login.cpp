@@ -36,46 +36,18 @@
 
 using namespace libtester;
 
-bool Login::WebLogin(const libcomp::String& username,
-                     const libcomp::String& password,
-                     const libcomp::String& clientVersion,
-                     libcomp::String& sid1, libcomp::String& sid2) {
-  bool result = false;
+namespace {
 
-  asio::io_service service;
-
-  libcomp::String httpRequest =
-      libcomp::String(
-          "POST /index.nut HTTP/1.1\r\n"
-          "Accept: image/gif, image/jpeg, image/pjpeg, "
-          "application/x-ms-application, application/xaml+xml, "
-          "application/x-ms-xbap, */*\r\n"
-          "Referer: http://127.0.0.1:10999/\r\n"
-          "Accept-Language: en-US\r\n"
-          "Content-Type: application/x-www-form-urlencoded\r\n"
-          "Accept-Encoding: gzip, deflate\r\n"
-          "User-Agent: imagilla/1.0\r\n"
-          "Host: 127.0.0.1:10999\r\n"
-          "Content-Length: %1\r\n"
-          "Connection: Keep-Alive\r\n"
-          "Cache-Control: no-cache\r\n"
-          "\r\n"
-          "login=&ID=%2&PASS=%3&IDSAVE=on&cv=%4")
-          .Arg(30 + username.Length() + password.Length() +
-               clientVersion.Length())
-          .Arg(username)
-          .Arg(password)
-          .Arg(clientVersion);
+/**
+ * Send a request to the lobby web server and wait for the reply.
+ * @param httpRequest Full HTTP request to send
+ * @param reply Output full HTTP reply
+ * @return true if a reply was received, false on timeout
+ */
+bool SendWebRequest(const std::string& httpRequest, std::string& reply) {
+  bool haveReply = false;
 
-  static const std::regex replyRegEx(
-      "^HTTP\\/1.1 200 OK\\r\\n"
-      "Content-Type: text\\/html; charset=UTF-8\\r\\n"
-      "Content-Length: ([0-9]+)\\r\\nConnection: close\\r\\n\\r\\n"
-      "<html><head><meta http-equiv=\"content-type\" "
-      "content=\"text\\/html; charset=UTF-8\"><\\/head><body>"
-      "login...<!-- ID:\"([^\"]+)\" 1stSID:\"([a-f0-9]{300})\" "
-      "2ndSID:\"([a-f0-9]{300})\" isIdSave:\"([01])\" "
-      "existBirthday:\"([01])\" --><\\/body><\\/html>\n$");
+  asio::io_service service;
 
   std::shared_ptr<libtester::HttpConnection> connection(
       new libtester::HttpConnection(service));
@@ -93,7 +65,8 @@ bool Login::WebLogin(const libcomp::String& username,
   timer.async_wait([&service](asio::error_code) { service.stop(); });
 
   libcomp::Packet p;
-  p.WriteArray(httpRequest.C(), static_cast<uint32_t>(httpRequest.Size()));
+  p.WriteArray(httpRequest.c_str(),
+               static_cast<uint32_t>(httpRequest.size()));
 
   connection->RequestPacket(9999);  // Over 9000!
   connection->SendPacket(p);
@@ -101,8 +74,6 @@ bool Login::WebLogin(const libcomp::String& username,
   std::thread worker(
       [&](std::shared_ptr<libcomp::MessageQueue<libcomp::Message::Message*>>
               queue) {
-        bool haveReply = false;
-
         while (!haveReply) {
           std::list<libcomp::Message::Message*> msgs;
 
@@ -113,26 +84,13 @@ bool Login::WebLogin(const libcomp::String& username,
                 dynamic_cast<libcomp::Message::Packet*>(msg);
 
             if (nullptr != pMessage) {
-              libcomp::ReadOnlyPacket reply(pMessage->GetPacket());
-              std::smatch match;
+              libcomp::ReadOnlyPacket packet(pMessage->GetPacket());
 
-              std::string source(&reply.ReadArray(reply.Size())[0],
-                                 reply.Size());
+              reply = std::string(&packet.ReadArray(packet.Size())[0],
+                                  packet.Size());
 
               haveReply = true;
 
-              if (std::regex_match(source, match, replyRegEx)) {
-                libcomp::String contentLength = match.str(1);
-                libcomp::String replyUsername = match.str(2);
-
-                sid1 = match.str(3);
-                sid2 = match.str(4);
-
-                if ("788" == contentLength && username == replyUsername) {
-                  result = true;
-                }
-              }
-
               connection.reset();
               service.stop();
             }
@@ -146,5 +104,102 @@ bool Login::WebLogin(const libcomp::String& username,
   serviceThread.join();
   worker.join();
 
-  return result;
+  return haveReply;
+}
+
+}  // namespace
+
+bool Login::WebLogin(const libcomp::String& username,
+                     const libcomp::String& password,
+                     const libcomp::String& clientVersion,
+                     libcomp::String& sid1, libcomp::String& sid2) {
+  libcomp::String httpRequest =
+      libcomp::String(
+          "POST /index.nut HTTP/1.1\r\n"
+          "Accept: image/gif, image/jpeg, image/pjpeg, "
+          "application/x-ms-application, application/xaml+xml, "
+          "application/x-ms-xbap, */*\r\n"
+          "Referer: http://127.0.0.1:10999/\r\n"
+          "Accept-Language: en-US\r\n"
+          "Content-Type: application/x-www-form-urlencoded\r\n"
+          "Accept-Encoding: gzip, deflate\r\n"
+          "User-Agent: imagilla/1.0\r\n"
+          "Host: 127.0.0.1:10999\r\n"
+          "Content-Length: %1\r\n"
+          "Connection: Keep-Alive\r\n"
+          "Cache-Control: no-cache\r\n"
+          "\r\n"
+          "login=&ID=%2&PASS=%3&IDSAVE=on&cv=%4")
+          .Arg(30 + username.Length() + password.Length() +
+               clientVersion.Length())
+          .Arg(username)
+          .Arg(password)
+          .Arg(clientVersion);
+
+  static const std::regex replyRegEx(
+      "^HTTP\\/1.1 200 OK\\r\\n"
+      "Content-Type: text\\/html; charset=UTF-8\\r\\n"
+      "Content-Length: ([0-9]+)\\r\\nConnection: close\\r\\n\\r\\n"
+      "<html><head><meta http-equiv=\"content-type\" "
+      "content=\"text\\/html; charset=UTF-8\"><\\/head><body>"
+      "login...<!-- ID:\"([^\"]+)\" 1stSID:\"([a-f0-9]{300})\" "
+      "2ndSID:\"([a-f0-9]{300})\" isIdSave:\"([01])\" "
+      "existBirthday:\"([01])\" --><\\/body><\\/html>\n$");
+
+  std::string source;
+  std::smatch match;
+
+  if (!SendWebRequest(httpRequest.ToUtf8(), source) ||
+      !std::regex_match(source, match, replyRegEx)) {
+    return false;
+  }
+
+  libcomp::String contentLength = match.str(1);
+  libcomp::String replyUsername = match.str(2);
+
+  sid1 = match.str(3);
+  sid2 = match.str(4);
+
+  return "788" == contentLength && username == replyUsername;
+}
+
+bool Login::ImportAccount(const std::string& data, libcomp::String& error) {
+  static const std::string boundary = "libtesterImportBoundary";
+
+  std::string body = "--" + boundary +
+                     "\r\n"
+                     "Content-Disposition: form-data; name=\"file\"; "
+                     "filename=\"account.dump\"\r\n"
+                     "Content-Type: application/octet-stream\r\n"
+                     "\r\n" +
+                     data + "\r\n--" + boundary + "--\r\n";
+
+  std::string httpRequest =
+      libcomp::String(
+          "POST /import HTTP/1.1\r\n"
+          "Host: 127.0.0.1:10999\r\n"
+          "Content-Type: multipart/form-data; boundary=%1\r\n"
+          "Content-Length: %2\r\n"
+          "Connection: close\r\n"
+          "\r\n")
+          .Arg(boundary)
+          .Arg(body.size())
+          .ToUtf8() +
+      body;
+
+  static const std::regex replyRegEx(
+      "^HTTP\\/1.1 200 OK\\r\\n[\\s\\S]*\\r\\n\\r\\n"
+      "[\\s\\S]*\"error\"\\s*:\\s*\"([^\"]*)\"[\\s\\S]*$");
+
+  std::string source;
+  std::smatch match;
+
+  if (!SendWebRequest(httpRequest, source) ||
+      !std::regex_match(source, match, replyRegEx)) {
+    return false;
+  }
+
+  error = match.str(1);
+
+  return true;
 }
@@ -38,6 +38,8 @@ bool WebLogin(const libcomp::String& username, const libcomp::String& password,
               const libcomp::String& clientVersion, libcomp::String& sid1,
               libcomp::String& sid2);
 
+bool ImportAccount(const std::string& data, libcomp::String& error);
+
 }  // namespace Login
 
 }  // namespace libtester
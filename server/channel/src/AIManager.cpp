@@ -79,6 +79,8 @@ using namespace channel;
 std::unordered_map<std::string, std::shared_ptr<libhack::ScriptEngine>>
     AIManager::sPreparedScripts;
 
+std::mutex AIManager::sPreparedScriptsLock;
+
 namespace libcomp {
 template <>
 BaseScriptEngine& BaseScriptEngine::Using<AIManager>() {
@@ -127,7 +129,8 @@ bool AIManager::Prepare(const std::shared_ptr<ActiveEntityState>& eState,
     return true;
   }
 
-  auto aiState = std::make_shared<AIState>();
+  auto zone = eState->GetZone();
+  auto aiState = zone ? zone->NewAIState() : std::make_shared<AIState>();
   eState->SetAIState(aiState);
 
   auto eBase = eState->GetEnemyBase();
@@ -210,8 +213,15 @@ bool AIManager::Prepare(const std::shared_ptr<ActiveEntityState>& eState,
 
   std::shared_ptr<libhack::ScriptEngine> aiEngine;
   if (!finalAIType.IsEmpty()) {
-    auto it = sPreparedScripts.find(finalAIType.C());
-    if (it == sPreparedScripts.end()) {
+    {
+      std::lock_guard<std::mutex> lock(sPreparedScriptsLock);
+      auto it = sPreparedScripts.find(finalAIType.C());
+      if (it != sPreparedScripts.end()) {
+        aiEngine = it->second;
+      }
+    }
+
+    if (!aiEngine) {
       auto script = serverDataManager->GetAIScript(finalAIType);
       if (!script) {
         LogAIManagerError([finalAIType]() {
@@ -235,10 +245,9 @@ bool AIManager::Prepare(const std::shared_ptr<ActiveEntityState>& eState,
       }
 
       if (!script->Instantiated) {
+        std::lock_guard<std::mutex> lock(sPreparedScriptsLock);
         sPreparedScripts[finalAIType.C()] = aiEngine;
       }
-    } else {
-      aiEngine = it->second;
     }
 
     Sqrat::Function f(Sqrat::RootTable(aiEngine->GetVM()), "prepare");
@@ -267,6 +276,11 @@ bool AIManager::Prepare(const std::shared_ptr<ActiveEntityState>& eState,
   return true;
 }
 
+void AIManager::ClearPreparedScripts() {
+  std::lock_guard<std::mutex> lock(sPreparedScriptsLock);
+  sPreparedScripts.clear();
+}
+
 void AIManager::UpdateActiveStates(const std::shared_ptr<Zone>& zone,
                                    uint64_t now, bool isNight) {
   std::list<std::shared_ptr<ActiveEntityState>> updated;
@@ -827,7 +841,7 @@ bool AIManager::Retreat(const std::shared_ptr<ActiveEntityState>& eState,
     std::list<Point> pathing;
     pathing.push_back(retreatPoint);
 
-    auto cmd = std::make_shared<AIMoveCommand>();
+    auto cmd = mMoveCommandPool.Create();
     cmd->SetPathing(pathing);
     aiState->QueueCommand(cmd, interrupt);
 
@@ -892,7 +906,7 @@ bool AIManager::Circle(const std::shared_ptr<ActiveEntityState>& eState,
   }
 
   if (pathing.size() > 0) {
-    auto cmd = std::make_shared<AIMoveCommand>();
+    auto cmd = mMoveCommandPool.Create();
     cmd->SetPathing(pathing);
     aiState->QueueCommand(cmd, interrupt);
 
@@ -2539,7 +2553,7 @@ std::shared_ptr<AIMoveCommand> AIManager::GetMoveCommand(
     return nullptr;
   }
 
-  auto cmd = std::make_shared<AIMoveCommand>();
+  auto cmd = mMoveCommandPool.Create();
   if (reduce > 0.f) {
     auto it = pathing.rbegin();
     Point& last = *it;
@@ -2599,7 +2613,7 @@ std::shared_ptr<AIMoveCommand> AIManager::GetMoveCommand(
 }
 
 std::shared_ptr<AICommand> AIManager::GetWaitCommand(uint32_t waitTime) const {
-  auto cmd = std::make_shared<AICommand>();
+  auto cmd = mWaitCommandPool.Create();
   cmd->SetDelay((uint64_t)waitTime * 1000);
 
   return cmd;
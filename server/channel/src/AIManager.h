@@ -27,6 +27,12 @@
 #ifndef SERVER_CHANNEL_SRC_AIMANAGER_H
 #define SERVER_CHANNEL_SRC_AIMANAGER_H
 
+// Standard C++11 Includes
+#include <mutex>
+
+// libcomp Includes
+#include <ObjectPool.h>
+
 // channel Includes
 #include "AIState.h"
 #include "ActiveEntityState.h"
@@ -84,6 +90,12 @@ class AIManager {
   bool Prepare(const std::shared_ptr<ActiveEntityState>& eState,
                const libcomp::String& aiType, uint16_t baseAIType = 0);
 
+  /**
+   * Clear all prepared AI scripts so they are compiled again from the
+   * current server data. Entities already using a script keep it.
+   */
+  void ClearPreparedScripts();
+
   /**
    * Update the AI state of all active AI controlled entities in the
    * specified zone
@@ -493,8 +505,17 @@ class AIManager {
   static std::unordered_map<std::string, std::shared_ptr<libhack::ScriptEngine>>
       sPreparedScripts;
 
+  /// Static lock for sPreparedScripts which is used from every worker
+  static std::mutex sPreparedScriptsLock;
+
   /// Pointer to the channel server.
   std::weak_ptr<ChannelServer> mServer;
+
+  /// Pool of move commands which are queued by nearly every AI update
+  libhack::ObjectPool<AIMoveCommand> mMoveCommandPool;
+
+  /// Pool of wait commands
+  libhack::ObjectPool<AICommand> mWaitCommandPool;
 };
 
 }  // namespace channel
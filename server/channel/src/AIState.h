@@ -29,6 +29,7 @@
 
 // libcomp Includes
 #include <Constants.h>
+#include <MemoryAccounting.h>
 #include <ScriptEngine.h>
 
 // object Includes
@@ -76,7 +77,9 @@ enum AIStatus_t : uint8_t {
  * Contains the state of an entity's AI information when controlled
  * by the channel.
  */
-class AIState : public objects::AIStateObject {
+class AIState
+    : public objects::AIStateObject,
+      private libhack::MemoryTracked<libhack::MemoryTag_t::AI_STATES, AIState> {
  public:
   /**
    * Create a new AI state.
@@ -27,6 +27,7 @@
 #include "AccountManager.h"
 
 // libcomp Includes
+#include <AccountDump.h>
 #include <DefinitionManager.h>
 #include <Log.h>
 #include <PacketCodes.h>
@@ -38,6 +39,7 @@
 #include <AccountWorldData.h>
 #include <BazaarData.h>
 #include <BazaarItem.h>
+#include <ChannelConfig.h>
 #include <ChannelLogin.h>
 #include <CharacterLogin.h>
 #include <CharacterProgress.h>
@@ -527,6 +529,55 @@ bool AccountManager::IncreaseCP(
   return false;
 }
 
+void AccountManager::QueueDeferredUpdate(
+    channel::ClientState* state,
+    const std::shared_ptr<libcomp::PersistentObject>& obj) {
+  auto server = mServer.lock();
+  auto conf = std::dynamic_pointer_cast<objects::ChannelConfig>(
+      server->GetConfig());
+
+  if (conf->GetDeferredSaveInterval() > 0 && state->GetLogoutSave()) {
+    state->DeferUpdate(obj);
+  } else {
+    server->GetWorldDatabase()->QueueUpdate(obj, state->GetAccountUID());
+  }
+}
+
+void AccountManager::FlushDeferredUpdates(channel::ClientState* state) {
+  auto updates = state->PopDeferredUpdates();
+  if (updates.size() > 0) {
+    auto dbChanges = libcomp::DatabaseChangeSet::Create(state->GetAccountUID());
+    for (auto& obj : updates) {
+      dbChanges->Update(obj);
+    }
+
+    mServer.lock()->GetWorldDatabase()->QueueChangeSet(dbChanges);
+  }
+}
+
+void AccountManager::FlushAllDeferredUpdates() {
+  auto server = mServer.lock();
+  for (auto& client : server->GetManagerConnection()->GetAllConnections()) {
+    FlushDeferredUpdates(client->GetClientState());
+  }
+}
+
+bool AccountManager::ScheduleDeferredUpdateHandler(uint16_t interval) {
+  auto server = mServer.lock();
+
+  ServerTime nextTime =
+      server->GetServerTime() + (ServerTime)(interval * 1000000ULL);
+  return server->ScheduleWork(
+      nextTime,
+      [](ChannelServer* svr, uint16_t i) {
+        auto accountManager = svr->GetAccountManager();
+
+        accountManager->FlushAllDeferredUpdates();
+        accountManager->ScheduleDeferredUpdateHandler(i);
+      },
+      server.get(), interval);
+}
+
 void AccountManager::SendCPBalance(
     const std::shared_ptr<channel::ChannelClientConnection>& client) {
   auto state = client->GetClientState();
@@ -1684,51 +1735,33 @@ bool AccountManager::LogoutCharacter(channel::ClientState* state) {
     dbChanges->Update(character);
   }
 
-  // Save all records at once
-  return mServer.lock()->GetWorldDatabase()->ProcessChangeSet(dbChanges);
-}
-
-void AccountManager::WipeMember(tinyxml2::XMLElement* pElement,
-                                const std::string& field) {
-  if (!pElement) {
-    return;
+  // Include anything still deferred (most will be covered above already)
+  for (auto& obj : state->PopDeferredUpdates()) {
+    dbChanges->Update(obj);
   }
 
-  tinyxml2::XMLElement* pChild = pElement->FirstChildElement("member");
-
-  while (pChild) {
-    auto childField = pChild->Attribute("name");
-
-    if (childField && childField == field) {
-      pElement->DeleteChild(pChild);
-
-      return;
-    }
-
-    // Move to the next child.
-    pChild = pChild->NextSiblingElement("member");
-  }
+  // Save all records at once
+  return mServer.lock()->GetWorldDatabase()->ProcessChangeSet(dbChanges);
 }
 
-libcomp::String AccountManager::DumpAccount(channel::ClientState* state) {
+bool AccountManager::DumpAccount(channel::ClientState* state,
+                                 std::ostream& out) {
   auto db = mServer.lock()->GetWorldDatabase();
 
   if (!state) {
-    return {};
+    return false;
   }
 
-  // DOM for the dump XML.
-  tinyxml2::XMLDocument doc;
-
-  tinyxml2::XMLElement* pRoot = doc.NewElement("objects");
-  doc.InsertEndChild(pRoot);
+  // Objects are written to the dump as they are visited so only one is
+  // ever serialized in memory at a time.
+  libhack::AccountDumpWriter writer(out);
 
   // First load and dump some account information.
   auto account = libcomp::PersistentObject::LoadObjectByUUID<objects::Account>(
       mServer.lock()->GetLobbyDatabase(), state->GetAccountUID(), true);
 
-  if (!account || !account->SaveWithUUID(doc, *pRoot)) {
-    return {};
+  if (!account || !writer.WriteObject(account)) {
+    return false;
   }
 
   for (auto character : account->GetCharacters()) {
@@ -1742,34 +1775,42 @@ libcomp::String AccountManager::DumpAccount(channel::ClientState* state) {
     cstate->SetAccountLogin(state->GetAccountLogin());
 
     if (!InitializeCharacter(character, cstate)) {
-      return {};
-    }
-
-    if (!character->SaveWithUUID(doc, *pRoot)) {
-      return {};
+      return false;
     }
 
-    auto pCharacterElement = pRoot->LastChildElement();
+    // Server managed references (clan, demon quest, culture and PvP data)
+    // are not part of the dump. They are cleared on a copy so the live
+    // character is left alone.
+    auto dumpCharacter = std::make_shared<objects::Character>(*character.Get());
+    dumpCharacter->SetClan(NULLUUID);
+    dumpCharacter->SetDemonQuest(NULLUUID);
+    dumpCharacter->SetCultureData(NULLUUID);
+    dumpCharacter->SetPvPData(NULLUUID);
 
-    WipeMember(pCharacterElement, "Clan");
-    WipeMember(pCharacterElement, "DemonQuest");
-    WipeMember(pCharacterElement, "CultureData");
-    WipeMember(pCharacterElement, "PvPData");
+    if (!writer.WriteObject(dumpCharacter, character->GetUUID())) {
+      return false;
+    }
 
-    if (!character->GetCoreStats()->SaveWithUUID(doc, *pRoot)) {
-      return {};
+    if (!writer.WriteObject(character->GetCoreStats().Get())) {
+      return false;
     }
 
     if (!character->GetProgress().IsNull() &&
-        !character->GetProgress()->SaveWithUUID(doc, *pRoot)) {
-      return {};
+        !writer.WriteObject(character->GetProgress().Get())) {
+      return false;
     }
 
-    if (!character->GetFriendSettings().IsNull() &&
-        !character->GetFriendSettings()->SaveWithUUID(doc, *pRoot)) {
-      return {};
-    } else if (!character->GetFriendSettings().IsNull()) {
-      WipeMember(pRoot->LastChildElement(), "Friends");
+    // Friends are other players on this server so they are not dumped.
+    auto friendSettings = character->GetFriendSettings().Get();
+
+    if (friendSettings) {
+      auto dumpFriendSettings =
+          std::make_shared<objects::FriendSettings>(*friendSettings);
+      dumpFriendSettings->ClearFriends();
+
+      if (!writer.WriteObject(dumpFriendSettings, friendSettings->GetUUID())) {
+        return false;
+      }
     }
 
     std::list<libcomp::ObjectReference<objects::ItemBox>> allBoxes;
@@ -1779,49 +1820,49 @@ libcomp::String AccountManager::DumpAccount(channel::ClientState* state) {
         continue;
       }
 
-      if (!itemBox->SaveWithUUID(doc, *pRoot)) {
-        return {};
+      if (!writer.WriteObject(itemBox.Get())) {
+        return false;
       }
 
       for (size_t i = 0; i < 50; i++) {
         auto item = itemBox->GetItems(i);
 
-        if (!item.IsNull() && !item->SaveWithUUID(doc, *pRoot)) {
-          return {};
+        if (!item.IsNull() && !writer.WriteObject(item.Get())) {
+          return false;
         }
       }
     }
 
     for (auto expertise : character->GetExpertises()) {
-      if (!expertise.IsNull() && !expertise->SaveWithUUID(doc, *pRoot)) {
-        return {};
+      if (!expertise.IsNull() && !writer.WriteObject(expertise.Get())) {
+        return false;
       }
     }
 
     auto box = character->GetCOMP();
 
-    if (!box.IsNull() && !box->SaveWithUUID(doc, *pRoot)) {
-      return {};
+    if (!box.IsNull() && !writer.WriteObject(box.Get())) {
+      return false;
     } else if (!box.IsNull()) {
       for (auto demon : box->GetDemons()) {
-        if (!demon.IsNull() && !demon->SaveWithUUID(doc, *pRoot)) {
-          return {};
+        if (!demon.IsNull() && !writer.WriteObject(demon.Get())) {
+          return false;
         } else if (!demon.IsNull()) {
-          if (!demon->GetCoreStats()->SaveWithUUID(doc, *pRoot)) {
-            return {};
+          if (!writer.WriteObject(demon->GetCoreStats().Get())) {
+            return false;
           }
 
           for (auto iSkill : demon->GetInheritedSkills()) {
-            if (!iSkill.IsNull() && !iSkill->SaveWithUUID(doc, *pRoot)) {
-              return {};
+            if (!iSkill.IsNull() && !writer.WriteObject(iSkill.Get())) {
+              return false;
             }
           }
 
           for (size_t i = 0; i < 4; i++) {
             auto equipment = demon->GetEquippedItems(i);
 
-            if (!equipment.IsNull() && !equipment->SaveWithUUID(doc, *pRoot)) {
-              return {};
+            if (!equipment.IsNull() && !writer.WriteObject(equipment.Get())) {
+              return false;
             }
           }
         }
@@ -1829,16 +1870,16 @@ libcomp::String AccountManager::DumpAccount(channel::ClientState* state) {
     }
 
     for (auto hotbar : character->GetHotbars()) {
-      if (!hotbar.IsNull() && !hotbar->SaveWithUUID(doc, *pRoot)) {
-        return {};
+      if (!hotbar.IsNull() && !writer.WriteObject(hotbar.Get())) {
+        return false;
       }
     }
 
     for (auto qPair : character->GetQuests()) {
       auto quest = qPair.second;
 
-      if (!quest.IsNull() && !quest->SaveWithUUID(doc, *pRoot)) {
-        return {};
+      if (!quest.IsNull() && !writer.WriteObject(quest.Get())) {
+        return false;
       }
     }
 
@@ -1853,42 +1894,42 @@ libcomp::String AccountManager::DumpAccount(channel::ClientState* state) {
       continue;
     }
 
-    if (!itemBox->SaveWithUUID(doc, *pRoot)) {
-      return {};
+    if (!writer.WriteObject(itemBox.Get())) {
+      return false;
     }
 
     for (size_t i = 0; i < 50; i++) {
       auto item = itemBox->GetItems(i);
 
-      if (!item.IsNull() && !item->SaveWithUUID(doc, *pRoot)) {
-        return {};
+      if (!item.IsNull() && !writer.WriteObject(item.Get())) {
+        return false;
       }
     }
   }
 
   for (auto box : worldData->GetDemonBoxes()) {
-    if (!box.IsNull() && !box->SaveWithUUID(doc, *pRoot)) {
-      return {};
+    if (!box.IsNull() && !writer.WriteObject(box.Get())) {
+      return false;
     } else if (!box.IsNull()) {
       for (auto demon : box->GetDemons()) {
-        if (!demon.IsNull() && !demon->SaveWithUUID(doc, *pRoot)) {
-          return {};
+        if (!demon.IsNull() && !writer.WriteObject(demon.Get())) {
+          return false;
         } else if (!demon.IsNull()) {
-          if (!demon->GetCoreStats()->SaveWithUUID(doc, *pRoot)) {
-            return {};
+          if (!writer.WriteObject(demon->GetCoreStats().Get())) {
+            return false;
           }
 
           for (auto iSkill : demon->GetInheritedSkills()) {
-            if (!iSkill.IsNull() && !iSkill->SaveWithUUID(doc, *pRoot)) {
-              return {};
+            if (!iSkill.IsNull() && !writer.WriteObject(iSkill.Get())) {
+              return false;
             }
           }
 
           for (size_t i = 0; i < 4; i++) {
             auto equipment = demon->GetEquippedItems(i);
 
-            if (!equipment.IsNull() && !equipment->SaveWithUUID(doc, *pRoot)) {
-              return {};
+            if (!equipment.IsNull() && !writer.WriteObject(equipment.Get())) {
+              return false;
             }
           }
         }
@@ -1896,8 +1937,5 @@ libcomp::String AccountManager::DumpAccount(channel::ClientState* state) {
     }
   }
 
-  tinyxml2::XMLPrinter printer;
-  doc.Print(&printer);
-
-  return printer.CStr();
+  return writer.Finish();
 }
@@ -32,7 +32,8 @@
 
 namespace libcomp {
 class Database;
-}
+class PersistentObject;
+}  // namespace libcomp
 
 namespace objects {
 class Account;
@@ -187,21 +188,48 @@ class AccountManager {
       std::list<std::shared_ptr<objects::CharacterLogin>> removes);
 
   /**
-   * Dump the account and return it. This account data can then be
-   * imported into another server.
+   * Dump the account as a binary account dump. This account data can
+   * then be imported into another server.
    * @param state ClientState object for the account to dump.
-   * @returns Dump of the account or an empty string on error.
+   * @param out Stream to write the dump to.
+   * @returns true if the account was dumped, false on error.
    */
-  libcomp::String DumpAccount(channel::ClientState* state);
+  bool DumpAccount(channel::ClientState* state, std::ostream& out);
+
+  /**
+   * Queue a world database update for a frequently changing record such
+   * as a quest kill count or expertise. If deferred saves are enabled the
+   * record is held on the client state instead so repeated updates within
+   * the save interval are written once.
+   * @param state Pointer to the client state the record belongs to
+   * @param obj Record that has been updated
+   */
+  void QueueDeferredUpdate(
+      channel::ClientState* state,
+      const std::shared_ptr<libcomp::PersistentObject>& obj);
 
- private:
   /**
-   * Delete a <member> from an object in the XML DOM.
-   * @param pElement Object element to delete the <member> from.
-   * @param field Name of the member field to delete.
+   * Queue all deferred updates held for the supplied client state to
+   * the world database.
+   * @param state Pointer to the client state to flush
    */
-  void WipeMember(tinyxml2::XMLElement* pElement, const std::string& field);
+  void FlushDeferredUpdates(channel::ClientState* state);
 
+  /**
+   * Queue all deferred updates held for every connected client to the
+   * world database.
+   */
+  void FlushAllDeferredUpdates();
+
+  /**
+   * Schedule future server work to flush all deferred updates every
+   * interval.
+   * @param interval Time in seconds between each flush
+   * @return true if the work was scheduled, false if it was not
+   */
+  bool ScheduleDeferredUpdateHandler(uint16_t interval);
+
+ private:
   /**
    * Create/load character data for use upon logging in.
    * @param character Character to initialize
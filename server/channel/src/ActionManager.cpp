@@ -178,6 +178,7 @@ void ActionManager::PerformActions(
   ctx.Client = client;
   ctx.SourceEntityID = sourceEntityID;
   ctx.Options = options;
+  ctx.ServerData = mServer.lock()->GetServerDataManager();
 
   if (zone) {
     ctx.CurrentZone = zone;
@@ -734,8 +735,7 @@ bool ActionManager::ZoneChange(ActionContext& ctx) {
       zoneID = zoneDef->GetID();
       dynamicMapID = zoneDef->GetDynamicMapID();
     } else {
-      auto serverDataManager = server->GetServerDataManager();
-      zoneDef = serverDataManager->GetZoneData(zoneID, dynamicMapID);
+      zoneDef = ctx.ServerData->GetZoneData(zoneID, dynamicMapID);
     }
 
     if (zoneDef) {
@@ -817,7 +817,7 @@ bool ActionManager::SetHomepoint(ActionContext& ctx) {
   uint32_t zoneID = act->GetZoneID();
   uint32_t spotID = act->GetSpotID();
 
-  auto zoneDef = mServer.lock()->GetServerDataManager()->GetZoneData(zoneID, 0);
+  auto zoneDef = ctx.ServerData->GetZoneData(zoneID, 0);
   if (zoneID == 0 || !zoneDef) {
     LogActionManagerErrorMsg(
         "Attempted to execute a set homepoint action with an invalid zone ID "
@@ -889,7 +889,7 @@ bool ActionManager::AddRemoveItems(ActionContext& ctx) {
       return false;
     }
 
-    auto serverDataManager = server->GetServerDataManager();
+    auto serverDataManager = ctx.ServerData;
 
     std::unordered_map<uint32_t, uint32_t> dropItems;
     for (auto& pair : adds) {
@@ -2544,7 +2544,7 @@ bool ActionManager::UpdateZoneInstance(ActionContext& ctx) {
 
         return false;
       } else {
-        auto serverDataManager = server->GetServerDataManager();
+        auto serverDataManager = ctx.ServerData;
         auto instDef =
             serverDataManager->GetZoneInstanceData(act->GetInstanceID());
         if (!instDef) {
@@ -3058,7 +3058,7 @@ bool ActionManager::RunScript(ActionContext& ctx) {
   }
 
   auto server = mServer.lock();
-  auto serverDataManager = server->GetServerDataManager();
+  auto serverDataManager = ctx.ServerData;
 
   auto script = serverDataManager->GetScript(act->GetScriptID());
   if (script && script->Type.ToLower() == "actioncustom") {
@@ -3219,7 +3219,7 @@ bool ActionManager::VerifyZone(ActionContext& ctx,
 
 bool ActionManager::PrepareTransformScript(
     ActionContext& ctx, std::shared_ptr<libhack::ScriptEngine> engine) {
-  auto serverDataManager = mServer.lock()->GetServerDataManager();
+  auto serverDataManager = ctx.ServerData;
   auto act = ctx.Action;
   auto script =
       act ? serverDataManager->GetScript(act->GetTransformScriptID()) : nullptr;
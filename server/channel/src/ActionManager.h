@@ -40,7 +40,8 @@
 
 namespace libhack {
 class ScriptEngine;
-}
+class ServerDataManager;
+}  // namespace libhack
 
 namespace channel {
 
@@ -142,6 +143,7 @@ class ActionManager {
     ActionOptions Options;
     int32_t SourceEntityID = 0;
     std::shared_ptr<Zone> CurrentZone;
+    std::shared_ptr<libhack::ServerDataManager> ServerData;
     bool ChannelChanged = false;
   };
 
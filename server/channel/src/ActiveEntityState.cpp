@@ -71,6 +71,7 @@
 #include "AIState.h"
 #include "ChannelServer.h"
 #include "CharacterManager.h"
+#include "StatVector.h"
 #include "TokuseiManager.h"
 #include "Zone.h"
 #include "ZoneInstance.h"
@@ -522,6 +523,18 @@ void ActiveEntityState::SetAIState(const std::shared_ptr<AIState>& aiState) {
   mAIState = aiState;
 }
 
+std::shared_ptr<const TokuseiSourceEffects>
+ActiveEntityState::GetTokuseiSourceEffects() {
+  std::lock_guard<std::mutex> lock(mLock);
+  return mTokuseiSourceEffects;
+}
+
+void ActiveEntityState::SetTokuseiSourceEffects(
+    const std::shared_ptr<const TokuseiSourceEffects>& effects) {
+  std::lock_guard<std::mutex> lock(mLock);
+  mTokuseiSourceEffects = effects;
+}
+
 float ActiveEntityState::RefreshKnockback(uint64_t time, float recoveryBoost,
                                           bool setValue) {
   std::lock_guard<std::mutex> lock(mLock);
@@ -664,13 +677,16 @@ bool ActiveEntityState::SetHPMP(int32_t hp, int32_t mp, bool adjust,
   if (hp >= 0) {
     auto newHP = hp > maxHP ? maxHP : hp;
 
-    // Update if the entity is alive or not
+    // Update if the entity is alive or not. Tokusei can be disabled
+    // while dead so the effects kept for the entity are cleared too.
     if (startingHP > 0 && newHP == 0) {
       mAlive = false;
+      mTokuseiSourceEffects = nullptr;
       Stop(ChannelServer::GetServerTime());
       result = true;
     } else if (startingHP == 0 && newHP > 0) {
       mAlive = true;
+      mTokuseiSourceEffects = nullptr;
       result = true;
     }
 
@@ -774,7 +790,7 @@ std::set<uint32_t> ActiveEntityState::AddStatusEffects(
     uint32_t effectType = ePair.second.Type;
     int8_t stack = ePair.second.Stack;
 
-    auto def = definitionManager->GetStatusData(effectType);
+    auto def = definitionManager->GetStatusDataPtr(effectType);
     auto basic = def->GetBasic();
     auto cancel = def->GetCancel();
     auto maxStack = basic->GetMaxStack();
@@ -868,7 +884,7 @@ std::set<uint32_t> ActiveEntityState::AddStatusEffects(
 
       std::set<uint32_t> inverseEffects;
       for (auto pair : mStatusEffects) {
-        auto exDef = definitionManager->GetStatusData(pair.first);
+        auto exDef = definitionManager->GetStatusDataPtr(pair.first);
         auto exBasic = exDef->GetBasic();
         if (exBasic->GetGroupID() == basic->GetGroupID()) {
           if (basic->GetGroupRank() >= exBasic->GetGroupRank()) {
@@ -955,7 +971,8 @@ std::set<uint32_t> ActiveEntityState::AddStatusEffects(
 
           // Application logic 2 effects have their expirations reset
           // any time they are re-applied (barring "set" durations)
-          auto exDef = definitionManager->GetStatusData(exEffect->GetEffect());
+          auto exDef =
+              definitionManager->GetStatusDataPtr(exEffect->GetEffect());
           if (exDef->GetBasic()->GetApplicationLogic() == 2) {
             resetTime = true;
           }
@@ -1594,6 +1611,7 @@ void ActiveEntityState::RemoveStatusEffects(
 
     mStatusEffects.erase(effectType);
     mStatusEffectDefs.erase(effectType);
+    mTokuseiSourceEffects = nullptr;
     mNRAShields.erase(effectType);
     mTimeDamageEffects.erase(effectType);
 
@@ -1853,6 +1871,9 @@ void ActiveEntityState::RegisterStatusEffect(
   uint32_t effectType = effect->GetEffect();
   mStatusEffects[effectType] = effect;
 
+  // Status effects can be tokusei sources
+  mTokuseiSourceEffects = nullptr;
+
   // Mark the cancel conditions
   auto se = definitionManager->GetStatusData(effectType);
   auto cancel = se->GetCancel();
@@ -2208,112 +2229,112 @@ void ActiveEntityStateImp<objects::Ally>::SetEntity(
 
 }  // namespace channel
 
-const std::set<CorrectTbl> BASE_STATS = {CorrectTbl::STR,   CorrectTbl::MAGIC,
-                                         CorrectTbl::VIT,   CorrectTbl::INT,
-                                         CorrectTbl::SPEED, CorrectTbl::LUCK};
+const StatFlags BASE_STATS = {CorrectTbl::STR,   CorrectTbl::MAGIC,
+                              CorrectTbl::VIT,   CorrectTbl::INT,
+                              CorrectTbl::SPEED, CorrectTbl::LUCK};
 
 // The following are all percentage representations that always apply values
 // as a numeric increase or decrease when represented as a normal percentage
-const std::set<CorrectTbl> FORCE_NUMERIC = {CorrectTbl::RES_DEFAULT,
-                                            CorrectTbl::RES_WEAPON,
-                                            CorrectTbl::RES_SLASH,
-                                            CorrectTbl::RES_THRUST,
-                                            CorrectTbl::RES_STRIKE,
-                                            CorrectTbl::RES_LNGR,
-                                            CorrectTbl::RES_PIERCE,
-                                            CorrectTbl::RES_SPREAD,
-                                            CorrectTbl::RES_FIRE,
-                                            CorrectTbl::RES_ICE,
-                                            CorrectTbl::RES_ELEC,
-                                            CorrectTbl::RES_ALMIGHTY,
-                                            CorrectTbl::RES_FORCE,
-                                            CorrectTbl::RES_EXPEL,
-                                            CorrectTbl::RES_CURSE,
-                                            CorrectTbl::RES_HEAL,
-                                            CorrectTbl::RES_SUPPORT,
-                                            CorrectTbl::RES_MAGICFORCE,
-                                            CorrectTbl::RES_NERVE,
-                                            CorrectTbl::RES_MIND,
-                                            CorrectTbl::RES_WORD,
-                                            CorrectTbl::RES_SPECIAL,
-                                            CorrectTbl::RES_SUICIDE,
-                                            CorrectTbl::COOLDOWN_TIME,
-                                            CorrectTbl::RATE_XP,
-                                            CorrectTbl::RATE_MAG,
-                                            CorrectTbl::RATE_MACCA,
-                                            CorrectTbl::RATE_EXPERTISE,
-                                            CorrectTbl::RATE_CLSR,
-                                            CorrectTbl::RATE_LNGR,
-                                            CorrectTbl::RATE_SPELL,
-                                            CorrectTbl::RATE_SUPPORT,
-                                            CorrectTbl::RATE_HEAL,
-                                            CorrectTbl::RATE_CLSR_TAKEN,
-                                            CorrectTbl::RATE_LNGR_TAKEN,
-                                            CorrectTbl::RATE_SPELL_TAKEN,
-                                            CorrectTbl::RATE_SUPPORT_TAKEN,
-                                            CorrectTbl::RATE_HEAL_TAKEN,
-                                            CorrectTbl::BOOST_DEFAULT,
-                                            CorrectTbl::BOOST_WEAPON,
-                                            CorrectTbl::BOOST_SLASH,
-                                            CorrectTbl::BOOST_THRUST,
-                                            CorrectTbl::BOOST_STRIKE,
-                                            CorrectTbl::BOOST_LNGR,
-                                            CorrectTbl::BOOST_PIERCE,
-                                            CorrectTbl::BOOST_SPREAD,
-                                            CorrectTbl::BOOST_FIRE,
-                                            CorrectTbl::BOOST_ICE,
-                                            CorrectTbl::BOOST_ELEC,
-                                            CorrectTbl::BOOST_ALMIGHTY,
-                                            CorrectTbl::BOOST_FORCE,
-                                            CorrectTbl::BOOST_EXPEL,
-                                            CorrectTbl::BOOST_CURSE,
-                                            CorrectTbl::BOOST_HEAL,
-                                            CorrectTbl::BOOST_SUPPORT,
-                                            CorrectTbl::BOOST_MAGICFORCE,
-                                            CorrectTbl::BOOST_NERVE,
-                                            CorrectTbl::BOOST_MIND,
-                                            CorrectTbl::BOOST_WORD,
-                                            CorrectTbl::BOOST_SPECIAL,
-                                            CorrectTbl::BOOST_SUICIDE,
-                                            CorrectTbl::LB_CHANCE,
-                                            CorrectTbl::RATE_PC,
-                                            CorrectTbl::RATE_DEMON,
-                                            CorrectTbl::RATE_PC_TAKEN,
-                                            CorrectTbl::RATE_DEMON_TAKEN,
-                                            CorrectTbl::CHANT_TIME};
+const StatFlags FORCE_NUMERIC = {CorrectTbl::RES_DEFAULT,
+                                 CorrectTbl::RES_WEAPON,
+                                 CorrectTbl::RES_SLASH,
+                                 CorrectTbl::RES_THRUST,
+                                 CorrectTbl::RES_STRIKE,
+                                 CorrectTbl::RES_LNGR,
+                                 CorrectTbl::RES_PIERCE,
+                                 CorrectTbl::RES_SPREAD,
+                                 CorrectTbl::RES_FIRE,
+                                 CorrectTbl::RES_ICE,
+                                 CorrectTbl::RES_ELEC,
+                                 CorrectTbl::RES_ALMIGHTY,
+                                 CorrectTbl::RES_FORCE,
+                                 CorrectTbl::RES_EXPEL,
+                                 CorrectTbl::RES_CURSE,
+                                 CorrectTbl::RES_HEAL,
+                                 CorrectTbl::RES_SUPPORT,
+                                 CorrectTbl::RES_MAGICFORCE,
+                                 CorrectTbl::RES_NERVE,
+                                 CorrectTbl::RES_MIND,
+                                 CorrectTbl::RES_WORD,
+                                 CorrectTbl::RES_SPECIAL,
+                                 CorrectTbl::RES_SUICIDE,
+                                 CorrectTbl::COOLDOWN_TIME,
+                                 CorrectTbl::RATE_XP,
+                                 CorrectTbl::RATE_MAG,
+                                 CorrectTbl::RATE_MACCA,
+                                 CorrectTbl::RATE_EXPERTISE,
+                                 CorrectTbl::RATE_CLSR,
+                                 CorrectTbl::RATE_LNGR,
+                                 CorrectTbl::RATE_SPELL,
+                                 CorrectTbl::RATE_SUPPORT,
+                                 CorrectTbl::RATE_HEAL,
+                                 CorrectTbl::RATE_CLSR_TAKEN,
+                                 CorrectTbl::RATE_LNGR_TAKEN,
+                                 CorrectTbl::RATE_SPELL_TAKEN,
+                                 CorrectTbl::RATE_SUPPORT_TAKEN,
+                                 CorrectTbl::RATE_HEAL_TAKEN,
+                                 CorrectTbl::BOOST_DEFAULT,
+                                 CorrectTbl::BOOST_WEAPON,
+                                 CorrectTbl::BOOST_SLASH,
+                                 CorrectTbl::BOOST_THRUST,
+                                 CorrectTbl::BOOST_STRIKE,
+                                 CorrectTbl::BOOST_LNGR,
+                                 CorrectTbl::BOOST_PIERCE,
+                                 CorrectTbl::BOOST_SPREAD,
+                                 CorrectTbl::BOOST_FIRE,
+                                 CorrectTbl::BOOST_ICE,
+                                 CorrectTbl::BOOST_ELEC,
+                                 CorrectTbl::BOOST_ALMIGHTY,
+                                 CorrectTbl::BOOST_FORCE,
+                                 CorrectTbl::BOOST_EXPEL,
+                                 CorrectTbl::BOOST_CURSE,
+                                 CorrectTbl::BOOST_HEAL,
+                                 CorrectTbl::BOOST_SUPPORT,
+                                 CorrectTbl::BOOST_MAGICFORCE,
+                                 CorrectTbl::BOOST_NERVE,
+                                 CorrectTbl::BOOST_MIND,
+                                 CorrectTbl::BOOST_WORD,
+                                 CorrectTbl::BOOST_SPECIAL,
+                                 CorrectTbl::BOOST_SUICIDE,
+                                 CorrectTbl::LB_CHANCE,
+                                 CorrectTbl::RATE_PC,
+                                 CorrectTbl::RATE_DEMON,
+                                 CorrectTbl::RATE_PC_TAKEN,
+                                 CorrectTbl::RATE_DEMON_TAKEN,
+                                 CorrectTbl::CHANT_TIME};
 
 void ActiveEntityState::AdjustStats(
     const std::list<std::shared_ptr<objects::MiCorrectTbl>>& adjustments,
     libcomp::EnumMap<CorrectTbl, int32_t>& stats,
     std::shared_ptr<objects::CalculatedEntityState> calcState, bool baseMode) {
-  std::set<CorrectTbl> removed;
-  libcomp::EnumMap<CorrectTbl, int32_t> maxPercents;
+  StatFlags removed;
+  StatVector<int32_t> maxPercents;
 
   if (!baseMode) {
     // If regen starts negative, lock at 0%
     if (stats[CorrectTbl::HP_REGEN] < 0) {
       stats[CorrectTbl::HP_REGEN] = 0;
-      removed.insert(CorrectTbl::HP_REGEN);
+      removed.Set(CorrectTbl::HP_REGEN);
     }
 
     if (stats[CorrectTbl::MP_REGEN] < 0) {
       stats[CorrectTbl::MP_REGEN] = 0;
-      removed.insert(CorrectTbl::MP_REGEN);
+      removed.Set(CorrectTbl::MP_REGEN);
     }
   }
 
   // Keep track of each increase to sum up and boost at the end. Percentages
   // are applied in 2 layers though most are typically in the first group.
-  libcomp::EnumMap<CorrectTbl, int32_t> numericSums;
-  std::array<libcomp::EnumMap<CorrectTbl, int32_t>, 2> percentSums;
+  StatVector<int32_t> numericSums;
+  std::array<StatVector<int32_t>, 2> percentSums;
   for (auto ct : adjustments) {
     auto tblID = ct->GetID();
 
     // Only adjust base or calculated stats depending on mode
-    if (baseMode != (BASE_STATS.find(tblID) != BASE_STATS.end())) continue;
+    if (baseMode != BASE_STATS.Has(tblID)) continue;
 
     // If a value is reduced to 0%, leave it
-    if (removed.find(tblID) != removed.end()) continue;
+    if (removed.Has(tblID)) continue;
 
     bool calcAdjust = false;
     uint8_t effectiveType = ct->GetType();
@@ -2363,8 +2384,7 @@ void ActiveEntityState::AdjustStats(
       calcAdjust = true;
     }
 
-    if (effectiveType == 1 &&
-        FORCE_NUMERIC.find(tblID) != FORCE_NUMERIC.end()) {
+    if (effectiveType == 1 && FORCE_NUMERIC.Has(tblID)) {
       effectiveType = 0;
     }
 
@@ -2377,15 +2397,15 @@ void ActiveEntityState::AdjustStats(
         // For type 0, the NRA value becomes 100% and CANNOT be reduced.
         switch (effectiveValue) {
           case NRA_NULL:
-            removed.insert(tblID);
+            removed.Set(tblID);
             calcState->SetNullChances((int16_t)tblID, 100);
             break;
           case NRA_REFLECT:
-            removed.insert(tblID);
+            removed.Set(tblID);
             calcState->SetReflectChances((int16_t)tblID, 100);
             break;
           case NRA_ABSORB:
-            removed.insert(tblID);
+            removed.Set(tblID);
             calcState->SetAbsorbChances((int16_t)tblID, 100);
             break;
           default:
@@ -2418,7 +2438,7 @@ void ActiveEntityState::AdjustStats(
         }
       }
     } else {
-      libcomp::EnumMap<CorrectTbl, int32_t>* map = 0;
+      StatVector<int32_t>* map = 0;
 
       switch (effectiveType) {
         case 1:
@@ -2428,22 +2448,18 @@ void ActiveEntityState::AdjustStats(
           if (effectiveValue == 0) {
             // Ignore calculated values that set to 0%
             if (!calcAdjust) {
-              removed.insert(tblID);
+              removed.Set(tblID);
               stats[tblID] = 0;
-              numericSums.erase(tblID);
-              percentSums[0].erase(tblID);
-              percentSums[1].erase(tblID);
-              maxPercents.erase(tblID);
+              numericSums.Erase(tblID);
+              percentSums[0].Erase(tblID);
+              percentSums[1].Erase(tblID);
+              maxPercents.Erase(tblID);
             }
           } else {
             size_t pIdx = (size_t)(effectiveType - 1);
 
             // Store max percents separately
-            if (maxPercents.find(tblID) == maxPercents.end()) {
-              maxPercents[tblID] = effectiveValue;
-            } else if (maxPercents[tblID] < effectiveValue) {
-              maxPercents[tblID] = effectiveValue;
-            }
+            maxPercents.Max(tblID, effectiveValue);
 
             map = &percentSums[pIdx];
           }
@@ -2456,20 +2472,16 @@ void ActiveEntityState::AdjustStats(
       }
 
       if (map) {
-        if (map->find(tblID) == map->end()) {
-          (*map)[tblID] = effectiveValue;
-        } else {
-          (*map)[tblID] += effectiveValue;
-        }
+        map->Add(tblID, effectiveValue);
       }
     }
   }
 
   // Now that we have all the sums, calculate stats in order
-  for (size_t i = 0; i < 126; i++) {
+  for (size_t i = 0; i < CORRECT_TBL_COUNT; i++) {
     CorrectTbl tblID = (CorrectTbl)i;
 
-    if (baseMode != (BASE_STATS.find(tblID) != BASE_STATS.end())) continue;
+    if (baseMode != BASE_STATS.Has(tblID)) continue;
 
     // Stats are applied in a specific order. Starting with the base
     // value it is as follows:
@@ -2481,15 +2493,14 @@ void ActiveEntityState::AdjustStats(
     for (size_t layer = 0; layer < 3; layer++) {
       if (layer == 1) {
         // Numeric adjust
-        auto it = numericSums.find(tblID);
-        if (it != numericSums.end()) {
-          stats[tblID] = (int32_t)(stats[tblID] + it->second);
+        if (numericSums.Has(tblID)) {
+          stats[tblID] = (int32_t)(stats[tblID] + numericSums.Get(tblID));
         }
 
         switch (tblID) {
           case CorrectTbl::HP_MAX:
             // Determine base HP regen (if not 0%)
-            if (removed.find(CorrectTbl::HP_REGEN) == removed.end()) {
+            if (!removed.Has(CorrectTbl::HP_REGEN)) {
               int32_t hpMax = stats[CorrectTbl::HP_MAX];
               int32_t vit = stats[CorrectTbl::VIT];
               stats[CorrectTbl::HP_REGEN] =
@@ -2511,7 +2522,7 @@ void ActiveEntityState::AdjustStats(
             break;
           case CorrectTbl::MP_MAX:
             // Determine base MP regen (if not 0%)
-            if (removed.find(CorrectTbl::MP_REGEN) == removed.end()) {
+            if (!removed.Has(CorrectTbl::MP_REGEN)) {
               int32_t mpMax = stats[CorrectTbl::MP_MAX];
               int32_t intel = stats[CorrectTbl::INT];
               stats[CorrectTbl::MP_REGEN] =
@@ -2525,9 +2536,8 @@ void ActiveEntityState::AdjustStats(
       } else {
         // Percentage adjust
         size_t idx = layer == 0 ? 0 : 1;
-        auto it = percentSums[idx].find(tblID);
-        if (it != percentSums[idx].end()) {
-          int32_t sum = it->second;
+        if (percentSums[idx].Has(tblID)) {
+          int32_t sum = percentSums[idx].Get(tblID);
 
           int32_t adjusted = stats[tblID];
           if (sum <= -100) {
@@ -2550,11 +2560,7 @@ void ActiveEntityState::AdjustStats(
   if (!baseMode && (GetEntityType() == EntityType_t::CHARACTER ||
                     GetEntityType() == EntityType_t::PARTNER_DEMON)) {
     for (CorrectTbl tblID : {CorrectTbl::MOVE1, CorrectTbl::MOVE2}) {
-      int16_t maxSpeed = 0;
-      auto moveIter = maxPercents.find(tblID);
-      if (moveIter != maxPercents.end()) {
-        maxSpeed = (int16_t)moveIter->second;
-      }
+      int16_t maxSpeed = (int16_t)maxPercents.Get(tblID);
 
       // Floor at max increase from default run speed
       const static int16_t MAX_SUM = (int16_t)SVR_CONST.MAX_MOVE_INCREASE_SUM;
@@ -2642,7 +2648,7 @@ void ActiveEntityState::GetAdditionalCorrectTbls(
 
   // 2) Gather status effect adjustments
   for (auto ePair : GetStatusEffects()) {
-    auto statusData = definitionManager->GetStatusData(ePair.first);
+    auto statusData = definitionManager->GetStatusDataPtr(ePair.first);
     for (auto ct : statusData->GetCommon()->GetCorrectTbl()) {
       uint8_t multiplier = (statusData->GetBasic()->GetStackType() == 2)
                                ? ePair.second->GetStack()
@@ -2692,7 +2698,7 @@ void ActiveEntityState::ApplySkillCorrectTbls(
     libhack::DefinitionManager* definitionManager,
     std::list<std::shared_ptr<objects::MiCorrectTbl>>& adjustments) {
   for (auto skillID : skillIDs) {
-    auto skillData = definitionManager->GetSkillData(skillID);
+    auto skillData = definitionManager->GetSkillDataPtr(skillID);
     auto common = skillData->GetCommon();
 
     bool include = false;
@@ -29,6 +29,7 @@
 
 // libcomp Includes
 #include <EnumMap.h>
+#include <MemoryAccounting.h>
 
 // objects Includes
 #include <ActiveEntityStateObject.h>
@@ -115,6 +116,7 @@ namespace channel {
 
 class AIState;
 class Zone;
+struct TokuseiSourceEffects;
 
 /**
  * Represents a request to add or remove a status effect with any applicable
@@ -475,6 +477,21 @@ class ActiveEntityState : public objects::ActiveEntityStateObject {
    */
   void SetAIState(const std::shared_ptr<channel::AIState>& aiState);
 
+  /**
+   * Get the tokusei effects last calculated as originating from the
+   * entity. Cleared whenever the entity's status effects change.
+   * @return Pointer to the tokusei effects or null if they need to be
+   *  calculated again
+   */
+  std::shared_ptr<const TokuseiSourceEffects> GetTokuseiSourceEffects();
+
+  /**
+   * Set the tokusei effects calculated as originating from the entity.
+   * @param effects Pointer to the tokusei effects
+   */
+  void SetTokuseiSourceEffects(
+      const std::shared_ptr<const TokuseiSourceEffects>& effects);
+
   /**
    * Get or update the entity's current knockback value based on the last
    * ticks associated to the value and the supplied time. If the value
@@ -1122,6 +1139,9 @@ class ActiveEntityState : public objects::ActiveEntityStateObject {
   /// Pointer to the AI state information bound to the entity
   std::shared_ptr<AIState> mAIState;
 
+  /// Tokusei effects last calculated as originating from the entity
+  std::shared_ptr<const TokuseiSourceEffects> mTokuseiSourceEffects;
+
   /// Server lock for shared resources
   std::mutex mLock;
 };
@@ -37,7 +37,10 @@ namespace channel {
  * Contains the state of an ally entity related to a channel as well
  * as functionality to be used by the scripting engine for AI.
  */
-class AllyState : public ActiveEntityStateImp<objects::Ally> {
+class AllyState
+    : public ActiveEntityStateImp<objects::Ally>,
+      private libhack::MemoryTracked<libhack::MemoryTag_t::ALLY_STATES,
+                                     AllyState> {
  public:
   /**
    * Create a new ally state.
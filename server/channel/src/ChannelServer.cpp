@@ -115,7 +115,9 @@ ChannelServer::ChannelServer(
       mSkillManager(0),
       mZoneManager(0),
       mDefinitionManager(0),
-      mServerDataManager(0),
+      mServerDataVersion(1),
+      mServerDataReloading(false),
+      mServerDataReloadPending(false),
       mRecalcTimeDependents(false),
       mMaxEntityID(0),
       mMaxObjectID(0),
@@ -143,11 +145,16 @@ bool ChannelServer::Initialize() {
   auto conf = std::dynamic_pointer_cast<objects::ChannelConfig>(mConfig);
 
   mDefinitionManager = new libhack::DefinitionManager();
+  if (!conf->GetDefinitionSnapshot().IsEmpty()) {
+    mDefinitionManager->SetSnapshotPath(conf->GetDefinitionSnapshot(),
+                                        conf->GetVerifyServerData());
+  }
+
   if (!mDefinitionManager->LoadAllData(GetDataStore())) {
     return false;
   }
 
-  mServerDataManager = new libhack::ServerDataManager();
+  mServerDataManager = std::make_shared<libhack::ServerDataManager>();
   if (!mServerDataManager->LoadData(GetDataStore(), mDefinitionManager)) {
     return false;
   }
@@ -186,6 +193,10 @@ bool ChannelServer::Initialize() {
       to_underlying(InternalPacketCode_t::PACKET_WEB_GAME));
   internalPacketManager->AddParser<Parsers::TeamUpdate>(
       to_underlying(InternalPacketCode_t::PACKET_TEAM_UPDATE));
+  internalPacketManager->AddParser<Parsers::ServerDataReload>(
+      to_underlying(InternalPacketCode_t::PACKET_SERVER_DATA_RELOAD));
+  internalPacketManager->AddParser<Parsers::MemoryReport>(
+      to_underlying(InternalPacketCode_t::PACKET_MEMORY_REPORT));
 
   // Add the managers to the main worker.
   mMainWorker.AddManager(internalPacketManager);
@@ -770,6 +781,12 @@ bool ChannelServer::Initialize() {
 void ChannelServer::Shutdown() {
   mTickRunning = false;
 
+  // Make sure no deferred record updates are lost
+  if (mAccountManager && mManagerConnection && mWorldDatabase) {
+    mAccountManager->FlushAllDeferredUpdates();
+    mWorldDatabase->ProcessTransactionQueue();
+  }
+
   BaseServer::Shutdown();
 }
 
@@ -801,7 +818,6 @@ ChannelServer::~ChannelServer() {
   delete mTokuseiManager;
   delete mZoneManager;
   delete mDefinitionManager;
-  delete mServerDataManager;
 }
 
 ServerTime ChannelServer::GetServerTime() { return sGetServerTime(); }
@@ -996,8 +1012,111 @@ libhack::DefinitionManager* ChannelServer::GetDefinitionManager() const {
   return mDefinitionManager;
 }
 
-libhack::ServerDataManager* ChannelServer::GetServerDataManager() const {
-  return mServerDataManager;
+std::shared_ptr<libhack::ServerDataManager>
+ChannelServer::GetServerDataManager() const {
+  return std::atomic_load(&mServerDataManager);
+}
+
+bool ChannelServer::ReloadServerData(
+    const std::function<void(bool)>& callback, bool queue) {
+  bool reloading = false;
+  while (!mServerDataReloading.compare_exchange_strong(reloading, true)) {
+    if (!queue) {
+      LogGeneralWarningMsg("Server data is already being reloaded.\n");
+
+      return false;
+    }
+
+    // The reload in progress checks this once it finishes. If it already
+    // has, try to start the reload here instead.
+    mServerDataReloadPending = true;
+    if (mServerDataReloading) {
+      LogGeneralInfoMsg(
+          "Server data is already being reloaded and will be reloaded "
+          "again once it finishes.\n");
+
+      return true;
+    }
+
+    reloading = false;
+  }
+
+  // This reload picks up any changes a pending one was queued for
+  mServerDataReloadPending = false;
+
+  LogGeneralInfoMsg("Reloading server data...\n");
+
+  auto self = std::dynamic_pointer_cast<ChannelServer>(shared_from_this());
+
+  // Load and verify the new server data away from the workers so players
+  // are not held up. The current server data stays in use until the new
+  // copy is ready.
+  std::thread([self, callback]() {
+#if !defined(_WIN32) && !defined(__APPLE__)
+    pthread_setname_np(pthread_self(), "serverdata");
+#endif  // !defined(_WIN32) && !defined(__APPLE__)
+
+    auto definitionManager = self->GetDefinitionManager();
+    auto serverDataManager = std::make_shared<libhack::ServerDataManager>();
+
+    bool success =
+        serverDataManager->ReloadData(self->GetDataStore(), definitionManager);
+    if (success) {
+      LogGeneralDebugMsg("Verifying reloaded server data integrity...\n");
+
+      success = serverDataManager->VerifyDataIntegrity(definitionManager);
+    }
+
+    // Swap on the queue worker so the swap is ordered with the rest of the
+    // queued work.
+    self->QueueWork(
+        [](const std::shared_ptr<ChannelServer>& pServer,
+           const std::shared_ptr<libhack::ServerDataManager>& pData,
+           bool pSuccess, const std::function<void(bool)>& pCallback) {
+          pServer->SwapServerData(pSuccess ? pData : nullptr);
+
+          if (pCallback) {
+            pCallback(pSuccess);
+          }
+        },
+        self, serverDataManager, success, callback);
+  }).detach();
+
+  return true;
+}
+
+void ChannelServer::SwapServerData(
+    const std::shared_ptr<libhack::ServerDataManager>& serverDataManager) {
+  if (serverDataManager) {
+    std::atomic_store(&mServerDataManager, serverDataManager);
+
+    // Prepared AI scripts and compiled event conditions came from the
+    // previous server data.
+    mAIManager->ClearPreparedScripts();
+    mEventManager->ClearConditionPrograms();
+
+    // Prewarmed instances were built from the previous definitions too.
+    mZoneManager->ClearInstancePool();
+
+    mServerDataVersion++;
+
+    LogGeneralInfo([&]() {
+      return libcomp::String("Server data version %1 is now active.\n")
+          .Arg(mServerDataVersion);
+    });
+
+    mZoneManager->PrewarmInstances();
+  } else {
+    LogGeneralErrorMsg(
+        "Failed to reload server data. The current server data will "
+        "remain active.\n");
+  }
+
+  mServerDataReloading = false;
+
+  if (mServerDataReloadPending.exchange(false)) {
+    ReloadServerData(nullptr, true);
+  }
 }
 
 ChannelSyncManager* ChannelServer::GetChannelSyncManager() const {
@@ -1044,6 +1163,20 @@ void ChannelServer::Tick() {
   mZoneManager->UpdateActiveZoneStates();
   perf.Stop("UpdateActiveZoneStates");
 
+  // Recalculate the stats of entities changed since the last tick
+  perf.Start();
+  mCharacterManager->FlushQueuedRecalculations();
+  perf.Stop("QueuedStatRecalculations");
+
+  {
+    uint64_t queued, avoided;
+    mCharacterManager->TakeRecalculationCounts(queued, avoided);
+    if (queued) {
+      perf.Count("QueuedStatRecalculations", queued);
+      perf.Count("AvoidedStatRecalculations", avoided);
+    }
+  }
+
   // Process queued world database changes
   perf.Start();
   auto worldFailures = mWorldDatabase->ProcessTransactionQueue();
@@ -1242,6 +1375,15 @@ void ChannelServer::ScheduleRecurringActions() {
   if (conf->GetTimeout() > 0) {
     mManagerConnection->ScheduleClientTimeoutHandler(conf->GetTimeout());
   }
+
+  if (conf->GetDeferredSaveInterval() > 0) {
+    mAccountManager->ScheduleDeferredUpdateHandler(
+        conf->GetDeferredSaveInterval());
+  }
+
+  if (conf->GetLazyZones() && conf->GetLazyZoneIdleTimeout() > 0) {
+    mZoneManager->ScheduleIdleZoneEviction(conf->GetLazyZoneIdleTimeout());
+  }
 }
 
 bool ChannelServer::RegisterClockEvent(WorldClockTime time, uint8_t type,
@@ -42,6 +42,10 @@
 // channel Includes
 #include "WorldClock.h"
 
+// Standard C++11 Includes
+#include <atomic>
+#include <functional>
+
 namespace libhack {
 class DefinitionManager;
 class ServerDataManager;
@@ -283,10 +287,29 @@ class ChannelServer : public libhack::Server {
   libhack::DefinitionManager* GetDefinitionManager() const;
 
   /**
-   * Get a pointer to the server data manager.
+   * Get a pointer to the current server data manager. The server data is
+   * never modified once loaded and is replaced as a whole when reloaded so
+   * the returned pointer should be held for the duration of an operation
+   * to work with one consistent set of data.
    * @return Pointer to the ServerDataManager
    */
-  libhack::ServerDataManager* GetServerDataManager() const;
+  std::shared_ptr<libhack::ServerDataManager> GetServerDataManager() const;
+
+  /**
+   * Load a new copy of the server data in the background and replace the
+   * current server data with it if it loads and passes the integrity
+   * checks. Operations already holding the current server data are not
+   * affected.
+   * @param callback Optional function to call on the queue worker once
+   *  the reload finishes, passed true if the new data is now active
+   * @param queue true if the reload should run again once the one
+   *  already in progress finishes, as that one may have read the data
+   *  before it changed. The callback is not used when queued.
+   * @return true if the reload was started or queued, false if one is
+   *  already in progress and the reload was not queued
+   */
+  bool ReloadServerData(const std::function<void(bool)>& callback = nullptr,
+                        bool queue = false);
 
   /**
    * Get a pointer to the data sync manager.
@@ -432,6 +455,14 @@ class ChannelServer : public libhack::Server {
    */
   uint32_t GetTimeUntilMidnight();
 
+  /**
+   * Replace the current server data after a reload.
+   * @param serverDataManager Pointer to the reloaded server data or null
+   *  if the reload failed
+   */
+  void SwapServerData(
+      const std::shared_ptr<libhack::ServerDataManager>& serverDataManager);
+
   /**
    * Create a connection to a newly active socket.
    * @param socket A new socket connection.
@@ -530,8 +561,19 @@ class ChannelServer : public libhack::Server {
   /// Pointer to the Definition Manager.
   libhack::DefinitionManager* mDefinitionManager;
 
-  /// Pointer to the Server Data Manager.
-  libhack::ServerDataManager* mServerDataManager;
+  /// Pointer to the Server Data Manager. Only accessed atomically as it
+  /// is replaced when the server data is reloaded.
+  std::shared_ptr<libhack::ServerDataManager> mServerDataManager;
+
+  /// Version of the active server data, incremented on each reload
+  uint32_t mServerDataVersion;
+
+  /// Indicates that server data is being reloaded in the background
+  std::atomic<bool> mServerDataReloading;
+
+  /// Indicates that the server data should be reloaded again once the
+  /// current reload finishes
+  std::atomic<bool> mServerDataReloadPending;
 
   /// Data sync manager for the server.
   ChannelSyncManager* mSyncManager;
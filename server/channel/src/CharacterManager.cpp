@@ -113,6 +113,7 @@
 
 // channel Includes
 #include "AIState.h"
+#include "AccountManager.h"
 #include "ActionManager.h"
 #include "ChannelServer.h"
 #include "ChannelSyncManager.h"
@@ -122,13 +123,14 @@
 #include "ManagerConnection.h"
 #include "MatchManager.h"
 #include "SkillManager.h"
+#include "StatVector.h"
 #include "TokuseiManager.h"
 #include "ZoneManager.h"
 
 using namespace channel;
 
 CharacterManager::CharacterManager(const std::weak_ptr<ChannelServer>& server)
-    : mServer(server) {}
+    : mServer(server), mRecalculationsQueued(0), mRecalculationsAvoided(0) {}
 
 CharacterManager::~CharacterManager() {}
 
@@ -733,6 +735,14 @@ uint8_t CharacterManager::RecalculateStats(
     return 0;
   }
 
+  {
+    // A queued recalculation is no longer needed
+    std::lock_guard<std::mutex> lock(mRecalculationLock);
+    if (mQueuedRecalculations.erase(eState->GetEntityID())) {
+      mRecalculationsAvoided++;
+    }
+  }
+
   auto server = mServer.lock();
   auto definitionManager = server->GetDefinitionManager();
   uint8_t result = eState->RecalculateStats(definitionManager);
@@ -800,11 +810,72 @@ uint8_t CharacterManager::RecalculateTokuseiAndStats(
     primaryEntity = client->GetClientState()->GetCharacterState();
   }
 
+  // Only the stats of the supplied entity are needed right away
   mServer.lock()->GetTokuseiManager()->Recalculate(
-      primaryEntity, true, std::set<int32_t>{eState->GetEntityID()});
+      primaryEntity, true, std::set<int32_t>{eState->GetEntityID()}, true);
   return RecalculateStats(eState, client);
 }
 
+void CharacterManager::QueueRecalculateStats(
+    const std::shared_ptr<ActiveEntityState>& eState) {
+  if (!eState) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mRecalculationLock);
+  mRecalculationsQueued++;
+
+  auto& queued = mQueuedRecalculations[eState->GetEntityID()];
+  if (queued.lock() == eState) {
+    mRecalculationsAvoided++;
+  } else {
+    queued = eState;
+  }
+}
+
+void CharacterManager::FlushRecalculateStats(
+    const std::shared_ptr<ActiveEntityState>& eState) {
+  if (!eState) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mRecalculationLock);
+    if (mQueuedRecalculations.find(eState->GetEntityID()) ==
+        mQueuedRecalculations.end()) {
+      return;
+    }
+  }
+
+  // Removes the entity from the queue
+  RecalculateStats(eState);
+}
+
+void CharacterManager::FlushQueuedRecalculations() {
+  std::unordered_map<int32_t, std::weak_ptr<ActiveEntityState>> queued;
+  {
+    std::lock_guard<std::mutex> lock(mRecalculationLock);
+    queued.swap(mQueuedRecalculations);
+  }
+
+  for (auto& pair : queued) {
+    auto eState = pair.second.lock();
+    if (eState) {
+      RecalculateStats(eState);
+    }
+  }
+}
+
+void CharacterManager::TakeRecalculationCounts(uint64_t& queued,
+                                               uint64_t& avoided) {
+  std::lock_guard<std::mutex> lock(mRecalculationLock);
+  queued = mRecalculationsQueued;
+  avoided = mRecalculationsAvoided;
+
+  mRecalculationsQueued = 0;
+  mRecalculationsAvoided = 0;
+}
+
 void CharacterManager::SendEntityStats(
     std::shared_ptr<ChannelClientConnection> client, int32_t entityID,
     bool includeSelf) {
@@ -4687,7 +4758,12 @@ void CharacterManager::UpdateExpertisePoints(
       server->GetZoneManager()->BroadcastPacket(client, notify);
     }
 
-    dbChanges->Update(expertise);
+    if (force) {
+      dbChanges->Update(expertise);
+    } else {
+      // Normal gains happen on nearly every skill use so defer the save
+      server->GetAccountManager()->QueueDeferredUpdate(state, expertise);
+    }
   }
 
   if (raised.size() > 0) {
@@ -6930,10 +7006,40 @@ std::set<uint32_t> CharacterManager::GetTraitSkills(
 
 libcomp::EnumMap<CorrectTbl, int32_t> CharacterManager::GetCharacterBaseStats(
     const std::shared_ptr<objects::EntityStats>& cs) {
+  // Every stat other than the core stats starts at the same value so
+  // build them once
+  static const StatVector<int32_t> defaults = []() {
+    StatVector<int32_t> d;
+    d.Add(CorrectTbl::HP_MAX, 70);
+    d.Add(CorrectTbl::MP_MAX, 10);
+    d.Add(CorrectTbl::HP_REGEN, 1);
+    d.Add(CorrectTbl::MP_REGEN, 1);
+    d.Add(CorrectTbl::MOVE1, (int32_t)(STAT_DEFAULT_SPEED / 2));
+    d.Add(CorrectTbl::MOVE2, STAT_DEFAULT_SPEED);
+    d.Add(CorrectTbl::KNOCKBACK_RESIST, 61);
+    d.Add(CorrectTbl::COOLDOWN_TIME, 100);
+    d.Add(CorrectTbl::RES_STATUS, 100);
+    d.Add(CorrectTbl::LB_DAMAGE, 100);
+    d.Add(CorrectTbl::CHANT_TIME, 100);
+
+    // Default all the rates to 100%
+    for (uint8_t i = (uint8_t)CorrectTbl::RATE_XP;
+         i <= (uint8_t)CorrectTbl::RATE_HEAL_TAKEN; i++) {
+      d.Add((CorrectTbl)i, 100);
+    }
+
+    d.Add(CorrectTbl::RATE_PC, 100);
+    d.Add(CorrectTbl::RATE_DEMON, 100);
+    d.Add(CorrectTbl::RATE_PC_TAKEN, 100);
+    d.Add(CorrectTbl::RATE_DEMON_TAKEN, 100);
+
+    return d;
+  }();
+
   libcomp::EnumMap<CorrectTbl, int32_t> stats;
-  for (size_t i = 0; i < 126; i++) {
+  for (size_t i = 0; i < CORRECT_TBL_COUNT; i++) {
     CorrectTbl tblID = (CorrectTbl)i;
-    stats[tblID] = 0;
+    stats[tblID] = defaults.Get(tblID);
   }
 
   stats[CorrectTbl::STR] = cs->GetSTR();
@@ -6942,29 +7048,6 @@ libcomp::EnumMap<CorrectTbl, int32_t> CharacterManager::GetCharacterBaseStats(
   stats[CorrectTbl::INT] = cs->GetINTEL();
   stats[CorrectTbl::SPEED] = cs->GetSPEED();
   stats[CorrectTbl::LUCK] = cs->GetLUCK();
-  stats[CorrectTbl::HP_MAX] = 70;
-  stats[CorrectTbl::MP_MAX] = 10;
-  stats[CorrectTbl::HP_REGEN] = 1;
-  stats[CorrectTbl::MP_REGEN] = 1;
-  stats[CorrectTbl::MOVE1] = (int32_t)(STAT_DEFAULT_SPEED / 2);
-  stats[CorrectTbl::MOVE2] = STAT_DEFAULT_SPEED;
-  stats[CorrectTbl::SUMMON_SPEED] = 0;
-  stats[CorrectTbl::KNOCKBACK_RESIST] = 61;
-  stats[CorrectTbl::COOLDOWN_TIME] = 100;
-  stats[CorrectTbl::RES_STATUS] = 100;
-  stats[CorrectTbl::LB_DAMAGE] = 100;
-  stats[CorrectTbl::CHANT_TIME] = 100;
-
-  // Default all the rates to 100%
-  for (uint8_t i = (uint8_t)CorrectTbl::RATE_XP;
-       i <= (uint8_t)CorrectTbl::RATE_HEAL_TAKEN; i++) {
-    stats[(CorrectTbl)i] = 100;
-  }
-
-  stats[CorrectTbl::RATE_PC] = 100;
-  stats[CorrectTbl::RATE_DEMON] = 100;
-  stats[CorrectTbl::RATE_PC_TAKEN] = 100;
-  stats[CorrectTbl::RATE_DEMON_TAKEN] = 100;
 
   return stats;
 }
@@ -6972,99 +7055,106 @@ libcomp::EnumMap<CorrectTbl, int32_t> CharacterManager::GetCharacterBaseStats(
 void CharacterManager::CalculateDependentStats(
     libcomp::EnumMap<CorrectTbl, int32_t>& stats, int8_t level, bool isDemon,
     uint8_t mode) {
+  // Read each input once instead of looking it up for every formula
+  int32_t str = stats[CorrectTbl::STR];
+  int32_t magic = stats[CorrectTbl::MAGIC];
+  int32_t vit = stats[CorrectTbl::VIT];
+  int32_t intel = stats[CorrectTbl::INT];
+  int32_t speed = stats[CorrectTbl::SPEED];
+
   /// @todo: fix: close but not quite right
-  libcomp::EnumMap<CorrectTbl, int32_t> adjusted;
+  StatVector<int32_t> adjusted;
 
   if (mode & 0x01) {
+    int32_t hp = stats[CorrectTbl::HP_MAX];
+    int32_t mp = stats[CorrectTbl::MP_MAX];
     if (isDemon) {
       // Round up each part
-      adjusted[CorrectTbl::HP_MAX] =
-          (int32_t)(stats[CorrectTbl::HP_MAX] +
-                    (int32_t)ceill(stats[CorrectTbl::HP_MAX] * 0.03 * level) +
-                    (int32_t)ceill(stats[CorrectTbl::STR] * 0.3) +
-                    (int32_t)ceill(((stats[CorrectTbl::HP_MAX] * 0.01) + 0.5) *
-                                   stats[CorrectTbl::VIT]));
-      adjusted[CorrectTbl::MP_MAX] =
-          (int32_t)(stats[CorrectTbl::MP_MAX] +
-                    (int32_t)ceill(stats[CorrectTbl::MP_MAX] * 0.03 * level) +
-                    (int32_t)ceill(stats[CorrectTbl::MAGIC] * 0.3) +
-                    (int32_t)ceill(((stats[CorrectTbl::MP_MAX] * 0.01) + 0.5) *
-                                   stats[CorrectTbl::INT]));
+      adjusted.Add(CorrectTbl::HP_MAX,
+                   (int32_t)(hp + (int32_t)ceill(hp * 0.03 * level) +
+                             (int32_t)ceill(str * 0.3) +
+                             (int32_t)ceill(((hp * 0.01) + 0.5) * vit)));
+      adjusted.Add(CorrectTbl::MP_MAX,
+                   (int32_t)(mp + (int32_t)ceill(mp * 0.03 * level) +
+                             (int32_t)ceill(magic * 0.3) +
+                             (int32_t)ceill(((mp * 0.01) + 0.5) * intel)));
     } else {
       // Round each part
-      adjusted[CorrectTbl::HP_MAX] =
-          (int32_t)(stats[CorrectTbl::HP_MAX] +
-                    (int32_t)roundl(stats[CorrectTbl::HP_MAX] * 0.03 * level) +
-                    (int32_t)roundl(stats[CorrectTbl::STR] * 0.3) +
-                    (int32_t)roundl(((stats[CorrectTbl::HP_MAX] * 0.01) + 0.5) *
-                                    stats[CorrectTbl::VIT]));
-      adjusted[CorrectTbl::MP_MAX] =
-          (int32_t)(stats[CorrectTbl::MP_MAX] +
-                    (int32_t)roundl(stats[CorrectTbl::MP_MAX] * 0.03 * level) +
-                    (int32_t)roundl(stats[CorrectTbl::MAGIC] * 0.3) +
-                    (int32_t)roundl(((stats[CorrectTbl::MP_MAX] * 0.01) + 0.5) *
-                                    stats[CorrectTbl::INT]));
+      adjusted.Add(CorrectTbl::HP_MAX,
+                   (int32_t)(hp + (int32_t)roundl(hp * 0.03 * level) +
+                             (int32_t)roundl(str * 0.3) +
+                             (int32_t)roundl(((hp * 0.01) + 0.5) * vit)));
+      adjusted.Add(CorrectTbl::MP_MAX,
+                   (int32_t)(mp + (int32_t)roundl(mp * 0.03 * level) +
+                             (int32_t)roundl(magic * 0.3) +
+                             (int32_t)roundl(((mp * 0.01) + 0.5) * intel)));
     }
   }
 
   if (mode & 0x02) {
     if (isDemon) {
       // Round the result, adjusting by 0.5
-      adjusted[CorrectTbl::CLSR] =
-          (int32_t)(stats[CorrectTbl::CLSR] +
-                    (int32_t)roundl((stats[CorrectTbl::STR] * 0.5) + 0.5 +
-                                    (level * 0.1)));
-      adjusted[CorrectTbl::LNGR] =
-          (int32_t)(stats[CorrectTbl::LNGR] +
-                    (int32_t)roundl((stats[CorrectTbl::SPEED] * 0.5) + 0.5 +
-                                    (level * 0.1)));
-      adjusted[CorrectTbl::SPELL] =
-          (int32_t)(stats[CorrectTbl::SPELL] +
-                    (int32_t)roundl((stats[CorrectTbl::MAGIC] * 0.5) + 0.5 +
-                                    (level * 0.1)));
-      adjusted[CorrectTbl::SUPPORT] =
-          (int32_t)(stats[CorrectTbl::SUPPORT] +
-                    (int32_t)roundl((stats[CorrectTbl::INT] * 0.5) + 0.5 +
-                                    (level * 0.1)));
-      adjusted[CorrectTbl::PDEF] =
-          (int32_t)(stats[CorrectTbl::PDEF] +
-                    (int32_t)roundl((stats[CorrectTbl::VIT] * 0.1) + 0.5 +
-                                    (level * 0.1)));
-      adjusted[CorrectTbl::MDEF] =
-          (int32_t)(stats[CorrectTbl::MDEF] +
-                    (int32_t)roundl((stats[CorrectTbl::INT] * 0.1) + 0.5 +
-                                    (level * 0.1)));
+      adjusted.Add(CorrectTbl::CLSR,
+                   (int32_t)(stats[CorrectTbl::CLSR] +
+                             (int32_t)roundl((str * 0.5) + 0.5 +
+                                             (level * 0.1))));
+      adjusted.Add(CorrectTbl::LNGR,
+                   (int32_t)(stats[CorrectTbl::LNGR] +
+                             (int32_t)roundl((speed * 0.5) + 0.5 +
+                                             (level * 0.1))));
+      adjusted.Add(CorrectTbl::SPELL,
+                   (int32_t)(stats[CorrectTbl::SPELL] +
+                             (int32_t)roundl((magic * 0.5) + 0.5 +
+                                             (level * 0.1))));
+      adjusted.Add(CorrectTbl::SUPPORT,
+                   (int32_t)(stats[CorrectTbl::SUPPORT] +
+                             (int32_t)roundl((intel * 0.5) + 0.5 +
+                                             (level * 0.1))));
+      adjusted.Add(CorrectTbl::PDEF,
+                   (int32_t)(stats[CorrectTbl::PDEF] +
+                             (int32_t)roundl((vit * 0.1) + 0.5 +
+                                             (level * 0.1))));
+      adjusted.Add(CorrectTbl::MDEF,
+                   (int32_t)(stats[CorrectTbl::MDEF] +
+                             (int32_t)roundl((intel * 0.1) + 0.5 +
+                                             (level * 0.1))));
     } else {
       // Round the results down
-      adjusted[CorrectTbl::CLSR] = (int32_t)(
-          stats[CorrectTbl::CLSR] +
-          (int32_t)floorl((stats[CorrectTbl::STR] * 0.5) + (level * 0.1)));
-      adjusted[CorrectTbl::LNGR] = (int32_t)(
-          stats[CorrectTbl::LNGR] +
-          (int32_t)floorl((stats[CorrectTbl::SPEED] * 0.5) + (level * 0.1)));
-      adjusted[CorrectTbl::SPELL] = (int32_t)(
-          stats[CorrectTbl::SPELL] +
-          (int32_t)floorl((stats[CorrectTbl::MAGIC] * 0.5) + (level * 0.1)));
-      adjusted[CorrectTbl::SUPPORT] = (int32_t)(
-          stats[CorrectTbl::SUPPORT] +
-          (int32_t)floorl((stats[CorrectTbl::INT] * 0.5) + (level * 0.1)));
-      adjusted[CorrectTbl::PDEF] = (int32_t)(
-          stats[CorrectTbl::PDEF] +
-          (int32_t)floorl((stats[CorrectTbl::VIT] * 0.1) + (level * 0.1)));
-      adjusted[CorrectTbl::MDEF] = (int32_t)(
-          stats[CorrectTbl::MDEF] +
-          (int32_t)floorl((stats[CorrectTbl::INT] * 0.1) + (level * 0.1)));
-    }
-  }
-
-  for (auto pair : adjusted) {
+      adjusted.Add(CorrectTbl::CLSR,
+                   (int32_t)(stats[CorrectTbl::CLSR] +
+                             (int32_t)floorl((str * 0.5) + (level * 0.1))));
+      adjusted.Add(CorrectTbl::LNGR,
+                   (int32_t)(stats[CorrectTbl::LNGR] +
+                             (int32_t)floorl((speed * 0.5) + (level * 0.1))));
+      adjusted.Add(CorrectTbl::SPELL,
+                   (int32_t)(stats[CorrectTbl::SPELL] +
+                             (int32_t)floorl((magic * 0.5) + (level * 0.1))));
+      adjusted.Add(CorrectTbl::SUPPORT,
+                   (int32_t)(stats[CorrectTbl::SUPPORT] +
+                             (int32_t)floorl((intel * 0.5) + (level * 0.1))));
+      adjusted.Add(CorrectTbl::PDEF,
+                   (int32_t)(stats[CorrectTbl::PDEF] +
+                             (int32_t)floorl((vit * 0.1) + (level * 0.1))));
+      adjusted.Add(CorrectTbl::MDEF,
+                   (int32_t)(stats[CorrectTbl::MDEF] +
+                             (int32_t)floorl((intel * 0.1) + (level * 0.1))));
+    }
+  }
+
+  for (size_t i = 0; i < CORRECT_TBL_COUNT; i++) {
+    CorrectTbl tblID = (CorrectTbl)i;
+    if (!adjusted.Has(tblID)) {
+      continue;
+    }
+
     // Since any negative value used for a calculation here is not valid,
     // any result in a negative value should be treated as an overflow and
     // be set to max
-    if (pair.second < 0) {
-      stats[pair.first] = std::numeric_limits<int32_t>::max();
+    int32_t value = adjusted.Get(tblID);
+    if (value < 0) {
+      stats[tblID] = std::numeric_limits<int32_t>::max();
     } else {
-      stats[pair.first] = pair.second;
+      stats[tblID] = value;
     }
   }
 
@@ -7072,12 +7162,12 @@ void CharacterManager::CalculateDependentStats(
     // Calculate incant/cooldown time decrease adjustments
     int32_t chantAdjust =
         (int32_t)(stats[CorrectTbl::CHANT_TIME] -
-                  (int32_t)floor(2.5 * floor(stats[CorrectTbl::INT] * 0.1) +
-                                 1.5 * floor(stats[CorrectTbl::SPEED] * 0.1)));
+                  (int32_t)floor(2.5 * floor(intel * 0.1) +
+                                 1.5 * floor(speed * 0.1)));
     int32_t coolAdjust =
         (int32_t)(stats[CorrectTbl::COOLDOWN_TIME] -
-                  (int32_t)floor(2.5 * floor(stats[CorrectTbl::VIT] * 0.1) +
-                                 1.5 * floor(stats[CorrectTbl::SPEED] * 0.1)));
+                  (int32_t)floor(2.5 * floor(vit * 0.1) +
+                                 1.5 * floor(speed * 0.1)));
     stats[CorrectTbl::CHANT_TIME] =
         (int32_t)(chantAdjust < 0 ? 0 : chantAdjust);
     stats[CorrectTbl::COOLDOWN_TIME] =
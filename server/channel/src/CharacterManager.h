@@ -27,6 +27,9 @@
 #ifndef SERVER_CHANNEL_SRC_CHARACTERMANAGER_H
 #define SERVER_CHANNEL_SRC_CHARACTERMANAGER_H
 
+// Standard C++11 Includes
+#include <mutex>
+
 // libcomp Includes
 #include <EnumMap.h>
 
@@ -158,6 +161,39 @@ class CharacterManager {
       const std::shared_ptr<ActiveEntityState>& eState,
       std::shared_ptr<ChannelClientConnection> client);
 
+  /**
+   * Mark the stats of an entity as needing to be recalculated. The stats
+   * are recalculated once at the end of the current tick regardless of
+   * how many times the entity is marked, or sooner if they are flushed or
+   * recalculated directly first. Use this when nothing reads the stats
+   * of the entity right after the change.
+   * @param eState Pointer to the state of the entity to recalculate
+   */
+  void QueueRecalculateStats(const std::shared_ptr<ActiveEntityState>& eState);
+
+  /**
+   * Recalculate the stats of an entity right away if they were queued
+   * by @ref QueueRecalculateStats. Call this before reading stats that
+   * may have been queued for recalculation.
+   * @param eState Pointer to the state of the entity to flush
+   */
+  void FlushRecalculateStats(const std::shared_ptr<ActiveEntityState>& eState);
+
+  /**
+   * Recalculate the stats of every entity queued by
+   * @ref QueueRecalculateStats. Called once per server tick.
+   */
+  void FlushQueuedRecalculations();
+
+  /**
+   * Get and reset the number of stat recalculations queued and the number
+   * of them avoided because the entity was already queued or recalculated
+   * directly before the queue was flushed.
+   * @param queued Output number of recalculations queued
+   * @param avoided Output number of recalculations avoided
+   */
+  void TakeRecalculationCounts(uint64_t& queued, uint64_t& avoided);
+
   /**
    * Send the stats of an entity that has been recalculated to the
    * zone (and world if applicable).
@@ -1584,6 +1620,20 @@ class CharacterManager {
 
   /// Pointer to the channel server
   std::weak_ptr<ChannelServer> mServer;
+
+  /// Entities with stats waiting to be recalculated by entity ID
+  std::unordered_map<int32_t, std::weak_ptr<ActiveEntityState>>
+      mQueuedRecalculations;
+
+  /// Number of stat recalculations queued since the counts were taken
+  uint64_t mRecalculationsQueued;
+
+  /// Number of queued stat recalculations avoided since the counts were
+  /// taken
+  uint64_t mRecalculationsAvoided;
+
+  /// Lock for the queued stat recalculations
+  std::mutex mRecalculationLock;
 };
 
 }  // namespace channel
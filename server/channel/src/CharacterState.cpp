@@ -119,7 +119,10 @@ BaseScriptEngine& BaseScriptEngine::Using<CharacterState>() {
 CharacterState::CharacterState()
     : mNextEquipmentExpiration(0),
       mQuestBonusCount(0),
-      mMaxFusionGaugeStocks(0) {}
+      mMaxFusionGaugeStocks(0),
+      mEquipStateKey(0),
+      mEquipFusionGaugeStocks(0),
+      mEquipStatsKey(0) {}
 
 std::list<int32_t> CharacterState::GetEquipmentTokuseiIDs() const {
   return mEquipmentTokuseiIDs;
@@ -402,6 +405,23 @@ bool CharacterState::GetEquipmentStats(
   // Keep track of the current system time for expired equipment
   uint32_t now = (uint32_t)std::time(0);
 
+  // Equipment rarely changes so reuse the last adjustments gathered if
+  // nothing they depend on has changed
+  uint64_t key = GetEquipmentKey(definitionManager, now);
+
+  std::lock_guard<std::mutex> lock(mEquipStatsLock);
+  if (key == mEquipStatsKey) {
+    adjustments.insert(adjustments.end(), mEquipAdjustments.begin(),
+                       mEquipAdjustments.end());
+    nraAdjustments.insert(nraAdjustments.end(),
+                          mEquipNRAAdjustments.begin(),
+                          mEquipNRAAdjustments.end());
+    return true;
+  }
+
+  mEquipAdjustments.clear();
+  mEquipNRAAdjustments.clear();
+
   for (size_t i = 0; i < 15; i++) {
     bool bullets =
         i == (size_t)objects::MiItemBasicData::EquipType_t::EQUIP_TYPE_BULLETS;
@@ -410,19 +430,26 @@ bool CharacterState::GetEquipmentStats(
     if (equip && (equip->GetDurability() > 0 || bullets) &&
         (!equip->GetRentalExpiration() || now < equip->GetRentalExpiration())) {
       uint32_t basicEffect = equip->GetBasicEffect();
-      auto itemData = definitionManager->GetItemData(
+      auto itemData = definitionManager->GetItemDataPtr(
           basicEffect ? basicEffect : equip->GetType());
       for (auto ct : itemData->GetCommon()->GetCorrectTbl()) {
         if ((uint8_t)ct->GetID() >= (uint8_t)CorrectTbl::NRA_WEAPON &&
             (uint8_t)ct->GetID() <= (uint8_t)CorrectTbl::NRA_MAGIC) {
-          nraAdjustments.push_back(ct);
+          mEquipNRAAdjustments.push_back(ct);
         } else {
-          adjustments.push_back(ct);
+          mEquipAdjustments.push_back(ct);
         }
       }
     }
   }
 
+  mEquipStatsKey = key;
+
+  adjustments.insert(adjustments.end(), mEquipAdjustments.begin(),
+                     mEquipAdjustments.end());
+  nraAdjustments.insert(nraAdjustments.end(), mEquipNRAAdjustments.begin(),
+                        mEquipNRAAdjustments.end());
+
   return true;
 }
 
@@ -436,17 +463,27 @@ void CharacterState::RecalcEquipState(
   // Keep track of the current system time for expired equipment
   uint32_t now = (uint32_t)std::time(0);
 
+  uint8_t maxStocks =
+      CharacterManager::HasValuable(character, SVR_CONST.VALUABLE_FUSION_GAUGE)
+          ? 1
+          : 0;
+
+  uint64_t key = GetEquipmentKey(definitionManager, now);
+
   std::lock_guard<std::mutex> lock(mLock);
+  if (key == mEquipStateKey) {
+    // Nothing on the equipment has changed, only the valuable can have
+    mMaxFusionGaugeStocks = (uint8_t)(maxStocks + mEquipFusionGaugeStocks);
+    return;
+  }
+
   mEquipmentTokuseiIDs.clear();
   mConditionalTokusei.clear();
   mEquipFuseBonuses.clear();
 
   mNextEquipmentExpiration = 0;
 
-  uint8_t maxStocks =
-      CharacterManager::HasValuable(character, SVR_CONST.VALUABLE_FUSION_GAUGE)
-          ? 1
-          : 0;
+  uint8_t equipStocks = 0;
 
   std::set<int16_t> soulFusionEffects;
   std::list<std::shared_ptr<objects::MiSpecialConditionData>> conditions;
@@ -465,9 +502,10 @@ void CharacterState::RecalcEquipState(
       }
     }
 
-    auto itemData = definitionManager->GetItemData(equip->GetType());
+    auto itemData = definitionManager->GetItemDataPtr(equip->GetType());
 
-    maxStocks = (uint8_t)(maxStocks + itemData->GetRestriction()->GetStock());
+    equipStocks =
+        (uint8_t)(equipStocks + itemData->GetRestriction()->GetStock());
 
     // Get item direct effects
     uint32_t specialEffect = equip->GetSpecialEffect();
@@ -614,7 +652,58 @@ void CharacterState::RecalcEquipState(
     }
   }
 
-  mMaxFusionGaugeStocks = maxStocks;
+  mEquipStateKey = key;
+  mEquipFusionGaugeStocks = equipStocks;
+  mMaxFusionGaugeStocks = (uint8_t)(maxStocks + equipStocks);
+}
+
+uint64_t CharacterState::GetEquipmentKey(
+    libhack::DefinitionManager* definitionManager, uint32_t now) const {
+  auto character = GetEntity();
+  if (!character) {
+    return 0;
+  }
+
+  // 64-bit FNV-1a over each value
+  uint64_t key = 14695981039346656037ULL;
+  auto add = [&key](uint64_t value) {
+    for (size_t i = 0; i < 8; i++) {
+      key ^= (uint8_t)(value >> (i * 8));
+      key *= 1099511628211ULL;
+    }
+  };
+
+  add((uint64_t)(uintptr_t)definitionManager);
+
+  for (size_t i = 0; i < 15; i++) {
+    auto equip = character->GetEquippedItems(i).Get();
+    if (!equip) {
+      add(0);
+      continue;
+    }
+
+    uint32_t expiration = equip->GetRentalExpiration();
+
+    add((uint64_t)(uintptr_t)equip.get());
+    add(equip->GetType());
+    add(equip->GetBasicEffect());
+    add(equip->GetSpecialEffect());
+    add(equip->GetDurability() == 0 ? 1 : 0);
+    add(expiration && expiration <= now ? 1 : 0);
+    add((uint64_t)(uint16_t)equip->GetSoul() |
+        ((uint64_t)(uint16_t)equip->GetTarot() << 16));
+
+    for (size_t k = 0; k < equip->ModSlotsCount(); k++) {
+      add(equip->GetModSlots(k));
+    }
+
+    for (size_t k = 0; k < 3; k++) {
+      add((uint8_t)equip->GetFuseBonuses(k));
+    }
+  }
+
+  // Never use the unset key
+  return key ? key : 1;
 }
 
 bool CharacterState::EquipmentExpired(uint32_t now) {
@@ -50,7 +50,10 @@ namespace channel {
 /**
  * Contains the state of a player character on the channel.
  */
-class CharacterState : public ActiveEntityStateImp<objects::Character> {
+class CharacterState
+    : public ActiveEntityStateImp<objects::Character>,
+      private libhack::MemoryTracked<libhack::MemoryTag_t::CHARACTER_STATES,
+                                     CharacterState> {
  public:
   /**
    * Create a new character state.
@@ -300,6 +303,19 @@ class CharacterState : public ActiveEntityStateImp<objects::Character> {
   void AdjustFuseBonus(libhack::DefinitionManager* definitionManager,
                        std::shared_ptr<objects::Item> equipment);
 
+  /**
+   * Build a key identifying everything about the character's equipment
+   * that the equipment state and stats are calculated from: the item in
+   * each slot, its effects, mod slots, enchantments, fuse bonuses and if
+   * it is broken or expired. The key only changes when one of these does.
+   * @param definitionManager Pointer to the definition manager the
+   *  equipment will be calculated with
+   * @param now Current system time
+   * @return Key for the current equipment
+   */
+  uint64_t GetEquipmentKey(libhack::DefinitionManager* definitionManager,
+                           uint32_t now) const;
+
   /// Tokusei effect IDs available due to the character's current
   /// equipment. Sources contain mod slots, equipment sets and
   /// enchantments. Can contain duplicates.
@@ -335,6 +351,26 @@ class CharacterState : public ActiveEntityStateImp<objects::Character> {
   /// Precalculated equipment fuse bonuses that are applied after base
   /// stats have been calculated (since they are all numeric adjustments)
   libcomp::EnumMap<CorrectTbl, int16_t> mEquipFuseBonuses;
+
+  /// Equipment key the equipment tokusei, conditions and fuse bonuses
+  /// were last calculated from
+  uint64_t mEquipStateKey;
+
+  /// Fusion gauge stocks granted by the current equipment
+  uint8_t mEquipFusionGaugeStocks;
+
+  /// Equipment key the cached equipment adjustments were gathered from
+  uint64_t mEquipStatsKey;
+
+  /// Cached non-NRA adjustments from the current equipment
+  std::list<std::shared_ptr<objects::MiCorrectTbl>> mEquipAdjustments;
+
+  /// Cached NRA adjustments from the current equipment
+  std::list<std::shared_ptr<objects::MiCorrectTbl>> mEquipNRAAdjustments;
+
+  /// Lock for the cached equipment adjustments, separate from the entity
+  /// lock since they are gathered while it is held
+  std::mutex mEquipStatsLock;
 };
 
 }  // namespace channel
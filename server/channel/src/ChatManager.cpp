@@ -30,6 +30,7 @@
 #include <DefinitionManager.h>
 #include <Git.h>
 #include <Log.h>
+#include <MemoryAccounting.h>
 #include <PacketCodes.h>
 #include <ServerConstants.h>
 #include <ServerDataManager.h>
@@ -123,12 +124,14 @@ ChatManager::ChatManager(const std::weak_ptr<ChannelServer>& server)
   mGMands["license"] = &ChatManager::GMCommand_License;
   mGMands["lnc"] = &ChatManager::GMCommand_LNC;
   mGMands["map"] = &ChatManager::GMCommand_Map;
+  mGMands["memory"] = &ChatManager::GMCommand_Memory;
   mGMands["online"] = &ChatManager::GMCommand_Online;
   mGMands["penalty"] = &ChatManager::GMCommand_PenaltyReset;
   mGMands["plugin"] = &ChatManager::GMCommand_Plugin;
   mGMands["pos"] = &ChatManager::GMCommand_Position;
   mGMands["post"] = &ChatManager::GMCommand_Post;
   mGMands["quest"] = &ChatManager::GMCommand_Quest;
+  mGMands["reloaddata"] = &ChatManager::GMCommand_ReloadData;
   mGMands["reported"] = &ChatManager::GMCommand_Reported;
   mGMands["resolve"] = &ChatManager::GMCommand_Resolve;
   mGMands["reunion"] = &ChatManager::GMCommand_Reunion;
@@ -1904,6 +1907,9 @@ bool ChatManager::GMCommand_Help(
            "@map ID",
            "Adds map for the player with the given ID.",
        }},
+      {"memory",
+       {"@memory", "Prints the number of live objects and approximate",
+        "memory used by each subsystem of the current channel."}},
       {"online",
        {"@online [NAME]", "Print how many players are online or check if the",
         "character with a specific NAME is online."}},
@@ -1929,6 +1935,11 @@ bool ChatManager::GMCommand_Help(
        {"@quest ID PHASE",
         "Sets the phase of the quest given by the ID to the phase",
         "PHASE. A phase of -1 is complete and -2 is a reset."}},
+      {"reloaddata",
+       {"@reloaddata",
+        "Reloads the server data (events, shops, zones, scripts,",
+        "etc.) on the current channel without a restart. The new",
+        "data is only used if it loads and passes verification."}},
       {"reported",
        {"@reported [COUNT|PLAYERNAME]",
         "Get a set of unresolved reported player records of a",
@@ -2477,6 +2488,29 @@ bool ChatManager::GMCommand_Map(
   return true;
 }
 
+bool ChatManager::GMCommand_Memory(
+    const std::shared_ptr<channel::ChannelClientConnection>& client,
+    const std::list<libcomp::String>& args) {
+  (void)args;
+
+  if (!HaveUserLevel(client, SVR_CONST.GM_CMD_LVL_MEMORY)) {
+    return true;
+  }
+
+  for (auto& usage : libhack::MemoryAccounting::GetUsage()) {
+    if (!SendChatMessage(
+            client, ChatType_t::CHAT_SELF,
+            libcomp::String("%1: %2 (%3)")
+                .Arg(usage.Name)
+                .Arg(usage.Count)
+                .Arg(libhack::MemoryAccounting::FormatBytes(usage.Bytes)))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 bool ChatManager::GMCommand_Online(
     const std::shared_ptr<channel::ChannelClientConnection>& client,
     const std::list<libcomp::String>& args) {
@@ -2734,6 +2768,33 @@ bool ChatManager::GMCommand_Post(
   return true;
 }
 
+bool ChatManager::GMCommand_ReloadData(
+    const std::shared_ptr<channel::ChannelClientConnection>& client,
+    const std::list<libcomp::String>& args) {
+  (void)args;
+
+  if (!HaveUserLevel(client, SVR_CONST.GM_CMD_LVL_RELOAD_DATA)) {
+    return true;
+  }
+
+  auto server = mServer.lock();
+
+  std::weak_ptr<channel::ChannelClientConnection> weakClient = client;
+  bool started = server->ReloadServerData([this, weakClient](bool success) {
+    auto pClient = weakClient.lock();
+    if (pClient) {
+      SendChatMessage(pClient, ChatType_t::CHAT_SELF,
+                      success ? "Server data reloaded."
+                              : "Failed to reload server data. The current "
+                                "server data is still active.");
+    }
+  });
+
+  return SendChatMessage(client, ChatType_t::CHAT_SELF,
+                         started ? "Reloading server data..."
+                                 : "Server data is already being reloaded.");
+}
+
 bool ChatManager::GMCommand_Reported(
     const std::shared_ptr<channel::ChannelClientConnection>& client,
     const std::list<libcomp::String>& args) {
@@ -443,6 +443,17 @@ class ChatManager {
       const std::shared_ptr<channel::ChannelClientConnection>& client,
       const std::list<libcomp::String>& args);
 
+  /**
+   * GM command to print the memory used by each subsystem of the
+   * current channel.
+   * @param client Pointer to the client that sent the command
+   * @param args List of arguments for the command
+   * @return true if the command was handled properly, else false
+   */
+  bool GMCommand_Memory(
+      const std::shared_ptr<channel::ChannelClientConnection>& client,
+      const std::list<libcomp::String>& args);
+
   /**
    * GM command to get the number of players on each channel or to
    * determine if a specific character is currently online.
@@ -505,6 +516,16 @@ class ChatManager {
       const std::shared_ptr<channel::ChannelClientConnection>& client,
       const std::list<libcomp::String>& args);
 
+  /**
+   * GM command to reload the server data on the channel.
+   * @param client Pointer to the client that sent the command
+   * @param args List of arguments for the command
+   * @return true if the command was handled properly, else false
+   */
+  bool GMCommand_ReloadData(
+      const std::shared_ptr<channel::ChannelClientConnection>& client,
+      const std::list<libcomp::String>& args);
+
   /**
    * GM command to get reported players that have not been resolved
    * yet.
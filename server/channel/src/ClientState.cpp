@@ -431,3 +431,32 @@ ClientState::GetCostAdjustments(int32_t entityID) {
              ? it->second
              : std::list<std::shared_ptr<objects::ClientCostAdjustment>>();
 }
+
+void ClientState::DeferUpdate(
+    const std::shared_ptr<libcomp::PersistentObject>& obj) {
+  if (!obj) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mLock);
+  mDeferredUpdates[obj->GetUUID().ToString()] = obj;
+}
+
+void ClientState::DropDeferredUpdate(const libobjgen::UUID& uuid) {
+  std::lock_guard<std::mutex> lock(mLock);
+  mDeferredUpdates.erase(uuid.ToString());
+}
+
+std::list<std::shared_ptr<libcomp::PersistentObject>>
+ClientState::PopDeferredUpdates() {
+  std::list<std::shared_ptr<libcomp::PersistentObject>> updates;
+
+  std::lock_guard<std::mutex> lock(mLock);
+  for (auto& pair : mDeferredUpdates) {
+    updates.push_back(pair.second);
+  }
+
+  mDeferredUpdates.clear();
+
+  return updates;
+}
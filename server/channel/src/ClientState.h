@@ -323,6 +323,27 @@ class ClientState : public objects::ClientStateObject {
   std::list<std::shared_ptr<objects::ClientCostAdjustment>> GetCostAdjustments(
       int32_t entityID);
 
+  /**
+   * Hold a world database update for a frequently changing record (quest
+   * kill counts, expertise points, etc) so repeated changes to the same
+   * record are written once when the deferred updates are next flushed.
+   * @param obj Record that has been updated
+   */
+  void DeferUpdate(const std::shared_ptr<libcomp::PersistentObject>& obj);
+
+  /**
+   * Stop holding a deferred update for a record that is being deleted so it
+   * is not written again after the delete.
+   * @param uuid UUID of the record being deleted
+   */
+  void DropDeferredUpdate(const libobjgen::UUID& uuid);
+
+  /**
+   * Remove and return all updates held by @ref DeferUpdate.
+   * @return List of records that need to be updated
+   */
+  std::list<std::shared_ptr<libcomp::PersistentObject>> PopDeferredUpdates();
+
  private:
   /// Static registry of all client states sorted as world (true) or
   /// local entity IDs (false) and their respective IDs
@@ -358,6 +379,11 @@ class ClientState : public objects::ClientStateObject {
                      std::list<std::shared_ptr<objects::ClientCostAdjustment>>>
       mCostAdjustments;
 
+  /// Map of record UUIDs to records with a deferred world database update
+  std::unordered_map<libcomp::String,
+                     std::shared_ptr<libcomp::PersistentObject>>
+      mDeferredUpdates;
+
   /// Current time of the server set upon creating the client
   /// state.
   ServerTime mStartTime;
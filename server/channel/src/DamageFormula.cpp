@@ -0,0 +1,147 @@
+/**
+ * @file server/channel/src/DamageFormula.cpp
+ * @ingroup channel
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Arithmetic core of the skill damage formulas.
+ *
+ * This file is part of the Channel Server (channel).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DamageFormula.h"
+
+// Standard C++11 Includes
+#include <cmath>
+#include <limits>
+
+// libcomp Includes
+#include <Randomizer.h>
+
+using namespace channel;
+
+float DamageFormula::CalculateNormal(const NormalDamageParams& params) {
+  // Damage starts with offense stat * modifier/100
+  float calc = (float)params.Offense * ((float)params.Modifier * 0.01f);
+
+  // Add the expertise modifier
+  calc = calc + (float)params.ExpertiseRankBoost * 0.5f;
+
+  // Subtract the enemy defense, unless its a critical or limit break
+  if (params.CritLevel > 0) {
+    if (params.CritDefenseReduction != 1.f) {
+      // Non-full reduction on crit
+      calc = calc -
+             (float)params.Defense * (1.f - params.CritDefenseReduction);
+    }
+  } else {
+    calc = calc - (float)params.Defense;
+  }
+
+  if (calc > 0.f) {
+    // Scale the current value by the critical, limit break or min to
+    // max damage factor
+    calc = calc * params.Scale;
+
+    // Multiply by 100% + -resistance
+    calc = calc * (1.f + params.Resist * -1.f);
+
+    // Multiply by 100% + boost
+    calc = calc * (1.f + params.Boost);
+  }
+
+  return calc;
+}
+
+float DamageFormula::GetScale(uint8_t critLevel, int32_t limitBreakDamage) {
+  switch (critLevel) {
+    case 1:  // Critical hit
+      return 1.2f;
+    case 2:  // Limit Break
+      return 1.5f * (float)limitBreakDamage * 0.01f;
+    default:  // Normal hit, 80%-99% damage
+      return RNG_DEC(float, 0.8f, 0.99f, 2);
+  }
+}
+
+int32_t DamageFormula::CalculateNormalHit(const NormalDamageParams& params,
+                                          const DamageRateParams& rates) {
+  int32_t amount = 0;
+
+  float calc = CalculateNormal(params);
+  if (calc > 0.f) {
+    // Floor and adjust rates, and prevent overflow
+    if (calc > (float)std::numeric_limits<int32_t>::max()) {
+      amount = ApplyRates(std::numeric_limits<int32_t>::max(), rates);
+    } else {
+      amount = ApplyRates((int32_t)floor(calc), rates);
+    }
+  }
+
+  // Apply minimum value of 1
+  return amount < 1 ? 1 : amount;
+}
+
+int32_t DamageFormula::ApplyRates(int32_t damage,
+                                  const DamageRateParams& params) {
+  float calc = (float)damage;
+
+  float rateTaken[3];
+  size_t rateCount = 0;
+
+  // If the source is not hitting itself, apply entity rates
+  if (params.ApplyEntityRates) {
+    // Multiply by entity rate dealt
+    calc = calc * params.EntityRateDealt;
+
+    // Multiply by entity rate taken
+    rateTaken[rateCount++] = params.EntityRateTaken;
+  }
+
+  // Multiply by dependency rate dealt
+  if (params.ApplyDependencyDealt) {
+    calc = calc * params.DependencyDealt;
+  }
+
+  if (params.PowerBoost != 0.0) {
+    // Multiply by 1 + remaining power increases/100
+    calc = calc * (float)(1.0 + params.PowerBoost);
+  }
+
+  // Multiply by dependency rate taken
+  rateTaken[rateCount++] = params.DependencyTaken;
+
+  // Multiply by 100% + -general rate taken
+  rateTaken[rateCount++] = (float)params.DamageTaken;
+
+  for (size_t i = 0; i < rateCount; i++) {
+    // Apply rate taken if not piercing or rate is not a reduction
+    if (!params.Pierce || rateTaken[i] > 1.f) {
+      calc = calc * rateTaken[i];
+    }
+  }
+
+  // Apply floor and enforce maximum.
+  if (calc < 0.f) {
+    calc = 0.f;
+  } else if (calc > (float)std::numeric_limits<int32_t>::max()) {
+    return std::numeric_limits<int32_t>::max();
+  }
+
+  return (int32_t)floor(calc);
+}
@@ -0,0 +1,149 @@
+/**
+ * @file server/channel/src/DamageFormula.h
+ * @ingroup channel
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Arithmetic core of the skill damage formulas.
+ *
+ * This file is part of the Channel Server (channel).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SERVER_CHANNEL_SRC_DAMAGEFORMULA_H
+#define SERVER_CHANNEL_SRC_DAMAGEFORMULA_H
+
+// Standard C++11 Includes
+#include <cstdint>
+
+namespace channel {
+
+/**
+ * Values used by the normal damage formula once the source and target
+ * specific values have been determined.
+ */
+struct NormalDamageParams {
+  /// Offense value of the source
+  uint16_t Offense = 0;
+
+  /// Skill modifier applied to the offense value as a percentage
+  uint16_t Modifier = 0;
+
+  /// Expertise rank boost of the source
+  uint8_t ExpertiseRankBoost = 0;
+
+  /// Defense value of the target including any guard modifier
+  uint16_t Defense = 0;
+
+  /// 0 for a normal hit, 1 for a critical hit or 2 for a limit break
+  uint8_t CritLevel = 0;
+
+  /// Portion of the defense ignored by critical hits and limit breaks
+  float CritDefenseReduction = 1.f;
+
+  /// Critical, limit break or random min to max damage scale
+  float Scale = 1.f;
+
+  /// Resistance of the target to the effective affinity
+  float Resist = 0.f;
+
+  /// Affinity boost of the source, no lower than -1
+  float Boost = 0.f;
+};
+
+/**
+ * Rates applied to calculated damage once the source and target specific
+ * rates have been determined. Each rate is a multiplier where 1 is 100%.
+ */
+struct DamageRateParams {
+  /// Indicates the entity rates apply since the source is not the target
+  bool ApplyEntityRates = false;
+
+  /// Rate the source deals damage to the target's entity type
+  float EntityRateDealt = 1.f;
+
+  /// Rate the target takes damage from the source's entity type
+  float EntityRateTaken = 1.f;
+
+  /// Indicates the dependency rate dealt applies
+  bool ApplyDependencyDealt = false;
+
+  /// Rate the source deals damage with the skill's dependency type
+  float DependencyDealt = 1.f;
+
+  /// Rate the target takes damage from the skill's dependency type
+  float DependencyTaken = 1.f;
+
+  /// Additional power or damage dealt from tokusei with 0 being none
+  double PowerBoost = 0.0;
+
+  /// Rate the target takes damage from tokusei
+  double DamageTaken = 1.0;
+
+  /// Indicates reductions to the rates taken are ignored
+  bool Pierce = false;
+};
+
+/**
+ * Arithmetic core of the skill damage formulas. This has no dependency on
+ * the rest of the server so it can be used to simulate and benchmark
+ * damage outside of a running channel.
+ */
+class DamageFormula {
+ public:
+  /**
+   * Calculate normal damage before any rates are applied.
+   * @param params Values to calculate the damage from
+   * @return Calculated damage or zero or less if the defense blocks all of
+   *  the damage
+   */
+  static float CalculateNormal(const NormalDamageParams& params);
+
+  /**
+   * Get the damage scale for a hit.
+   * @param critLevel 0 for a normal hit, 1 for a critical hit or 2 for a
+   *  limit break
+   * @param limitBreakDamage Limit break damage rate of the source as a
+   *  percentage, only used by limit breaks
+   * @return 1.2 for a critical hit, 1.5 times the limit break damage rate
+   *  for a limit break or a random scale from 0.8 to 0.99 for a normal hit
+   */
+  static float GetScale(uint8_t critLevel, int32_t limitBreakDamage);
+
+  /**
+   * Calculate normal damage and apply the rates to it. This is the full
+   * normal damage formula as used by the channel once the source and
+   * target specific values have been determined.
+   * @param params Values to calculate the damage from
+   * @param rates Rates to apply
+   * @return Final damage, no lower than one
+   */
+  static int32_t CalculateNormalHit(const NormalDamageParams& params,
+                                    const DamageRateParams& rates);
+
+  /**
+   * Apply damage dealt and taken rates to calculated damage.
+   * @param damage Damage to adjust
+   * @param params Rates to apply
+   * @return Adjusted damage, no lower than zero
+   */
+  static int32_t ApplyRates(int32_t damage, const DamageRateParams& params);
+};
+
+}  // namespace channel
+
+#endif  // SERVER_CHANNEL_SRC_DAMAGEFORMULA_H
@@ -42,7 +42,10 @@ namespace channel {
 /**
  * Contains the state of a partner demon related to a channel.
  */
-class DemonState : public ActiveEntityStateImp<objects::Demon> {
+class DemonState
+    : public ActiveEntityStateImp<objects::Demon>,
+      private libhack::MemoryTracked<libhack::MemoryTag_t::DEMON_STATES,
+                                     DemonState> {
  public:
   /**
    * Create a new demon state.
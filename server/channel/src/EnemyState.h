@@ -37,7 +37,10 @@ namespace channel {
  * Contains the state of an enemy related to a channel as well
  * as functionality to be used by the scripting engine for AI.
  */
-class EnemyState : public ActiveEntityStateImp<objects::Enemy> {
+class EnemyState
+    : public ActiveEntityStateImp<objects::Enemy>,
+      private libhack::MemoryTracked<libhack::MemoryTag_t::ENEMY_STATES,
+                                     EnemyState> {
  public:
   /**
    * Create a new enemy state.
@@ -0,0 +1,98 @@
+/**
+ * @file server/channel/src/EventConditionProgram.cpp
+ * @ingroup channel
+ *
+ * @author HACKfrost
+ *
+ * @brief Event conditions compiled into an ordered list of steps.
+ *
+ * This file is part of the Channel Server (channel).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EventConditionProgram.h"
+
+// Standard C++11 Includes
+#include <algorithm>
+
+using namespace channel;
+
+EventConditionProgram::EventConditionProgram(
+    const std::list<std::shared_ptr<objects::EventCondition>>& conditions)
+    : mSource(conditions.begin(), conditions.end()) {
+  std::vector<std::pair<uint8_t, Step>> steps;
+  for (auto& condition : conditions) {
+    Step step;
+    step.Condition = condition;
+    step.ClientOnly = false;
+    step.Negate = condition->GetNegate();
+
+    uint8_t cost = 0;
+    switch (condition->GetType()) {
+      case objects::EventCondition::Type_t::SCRIPT:
+        // A new script engine is built for each check
+        cost = 2;
+        break;
+      case objects::EventCondition::Type_t::ZONE_FLAGS:
+      case objects::EventCondition::Type_t::ZONE_CHARACTER_FLAGS:
+      case objects::EventCondition::Type_t::ZONE_INSTANCE_FLAGS:
+      case objects::EventCondition::Type_t::ZONE_INSTANCE_CHARACTER_FLAGS:
+        cost = 1;
+        break;
+      case objects::EventCondition::Type_t::PARTNER_ALIVE:
+      case objects::EventCondition::Type_t::PARTNER_FAMILIARITY:
+      case objects::EventCondition::Type_t::PARTNER_LEVEL:
+      case objects::EventCondition::Type_t::PARTNER_LOCKED:
+      case objects::EventCondition::Type_t::PARTNER_SKILL_LEARNED:
+      case objects::EventCondition::Type_t::PARTNER_STAT_VALUE:
+      case objects::EventCondition::Type_t::SOUL_POINTS:
+      case objects::EventCondition::Type_t::QUEST_AVAILABLE:
+      case objects::EventCondition::Type_t::QUEST_PHASE:
+      case objects::EventCondition::Type_t::QUEST_PHASE_REQUIREMENTS:
+      case objects::EventCondition::Type_t::QUEST_FLAGS:
+        step.ClientOnly = true;
+        cost = 1;
+        break;
+      default:
+        break;
+    }
+
+    steps.push_back(std::make_pair(cost, step));
+  }
+
+  // Equal cost conditions keep their order
+  std::stable_sort(steps.begin(), steps.end(),
+                   [](const std::pair<uint8_t, Step>& a,
+                      const std::pair<uint8_t, Step>& b) {
+                     return a.first < b.first;
+                   });
+
+  mSteps.reserve(steps.size());
+  for (auto& pair : steps) {
+    mSteps.push_back(pair.second);
+  }
+}
+
+bool EventConditionProgram::IsCompiledFrom(
+    const std::list<std::shared_ptr<objects::EventCondition>>& conditions)
+    const {
+  if (conditions.size() != mSource.size()) {
+    return false;
+  }
+
+  return std::equal(conditions.begin(), conditions.end(), mSource.begin());
+}
@@ -0,0 +1,111 @@
+/**
+ * @file server/channel/src/EventConditionProgram.h
+ * @ingroup channel
+ *
+ * @author HACKfrost
+ *
+ * @brief Event conditions compiled into an ordered list of steps.
+ *
+ * This file is part of the Channel Server (channel).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SERVER_CHANNEL_SRC_EVENTCONDITIONPROGRAM_H
+#define SERVER_CHANNEL_SRC_EVENTCONDITIONPROGRAM_H
+
+// object Includes
+#include <EventCondition.h>
+
+// Standard C++11 Includes
+#include <list>
+#include <memory>
+#include <vector>
+
+namespace channel {
+
+/**
+ * Event conditions compiled into a list of steps ordered by the relative
+ * cost of evaluating them. Conditions that only need the context come
+ * first, followed by conditions that look up zone, partner or quest
+ * state and finally script conditions which need a new script engine
+ * for each check. Conditions that need a client are resolved without
+ * being evaluated when there is none. The conditions themselves are
+ * still evaluated by the caller.
+ */
+class EventConditionProgram {
+ public:
+  /**
+   * Compile a list of event conditions which must all pass.
+   * @param conditions Event conditions to compile
+   */
+  explicit EventConditionProgram(
+      const std::list<std::shared_ptr<objects::EventCondition>>& conditions);
+
+  /**
+   * Check if the program was compiled from a list of event conditions.
+   * @param conditions Event conditions to compare to
+   * @return true if the program was compiled from the same condition
+   *  objects in the same order
+   */
+  bool IsCompiledFrom(
+      const std::list<std::shared_ptr<objects::EventCondition>>& conditions)
+      const;
+
+  /**
+   * Evaluate the program.
+   * @param hasClient true if the conditions are evaluated for a client
+   * @param evaluate Function returning if a single condition passes
+   * @return true if every condition passes
+   */
+  template <typename T>
+  bool Evaluate(bool hasClient, T evaluate) const {
+    for (auto& step : mSteps) {
+      // Client conditions fail without a client, before negation
+      bool result = (step.ClientOnly && !hasClient) ? step.Negate
+                                                    : evaluate(step.Condition);
+      if (!result) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+ private:
+  /// Single compiled condition
+  struct Step {
+    /// Condition to evaluate
+    std::shared_ptr<objects::EventCondition> Condition;
+
+    /// true if the condition always fails without a client
+    bool ClientOnly;
+
+    /// true if the result of the condition is negated
+    bool Negate;
+  };
+
+  /// Conditions the program was compiled from in their original order,
+  /// held so they cannot be replaced by others at the same address
+  std::vector<std::shared_ptr<objects::EventCondition>> mSource;
+
+  /// Conditions to evaluate in order
+  std::vector<Step> mSteps;
+};
+
+}  // namespace channel
+
+#endif  // SERVER_CHANNEL_SRC_EVENTCONDITIONPROGRAM_H
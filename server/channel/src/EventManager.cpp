@@ -105,6 +105,7 @@
 #include <WorldSharedConfig.h>
 
 // channel Includes
+#include "AccountManager.h"
 #include "ActionManager.h"
 #include "ChannelServer.h"
 #include "ChannelSyncManager.h"
@@ -643,6 +644,7 @@ bool EventManager::UpdateQuest(
 
     if (quest) {
       character->RemoveQuests(questID);
+      state->DropDeferredUpdate(quest->GetUUID());
       dbChanges->Update(character);
       dbChanges->Delete(quest);
     }
@@ -653,6 +655,7 @@ bool EventManager::UpdateQuest(
 
     if (quest) {
       character->RemoveQuests(questID);
+      state->DropDeferredUpdate(quest->GetUUID());
       dbChanges->Update(character);
       dbChanges->Delete(quest);
 
@@ -750,6 +753,8 @@ void EventManager::UpdateQuestKillCount(
   auto cState = state->GetCharacterState();
   auto character = cState->GetEntity();
 
+  auto accountManager = server->GetAccountManager();
+
   std::set<int16_t> countUpdates;
   for (auto qPair : character->GetQuests()) {
     auto quest = qPair.second.Get();
@@ -781,8 +786,9 @@ void EventManager::UpdateQuestKillCount(
       }
     }
 
-    if (countUpdates.size() > 0) {
-      server->GetWorldDatabase()->QueueUpdate(quest, state->GetAccountUID());
+    if (countUpdates.find(qPair.first) != countUpdates.end()) {
+      // Kill counts change constantly so defer the save
+      accountManager->QueueDeferredUpdate(state, quest);
     }
   }
 
@@ -873,7 +879,7 @@ bool EventManager::EvaluateEventCondition(
         return false;
       }
 
-      auto serverDataManager = mServer.lock()->GetServerDataManager();
+      auto serverDataManager = GetServerData(ctx);
       auto script =
           serverDataManager->GetScript(scriptCondition->GetScriptID());
       if (ctx.Client && !ctx.CurrentZone) {
@@ -1305,13 +1311,32 @@ bool EventManager::EvaluateEventConditions(
 bool EventManager::EvaluateEventConditions(
     EventContext& ctx,
     const std::list<std::shared_ptr<objects::EventCondition>>& conditions) {
-  for (auto condition : conditions) {
-    if (!EvaluateEventCondition(ctx, condition)) {
-      return false;
-    }
+  if (conditions.empty()) {
+    return true;
   }
 
-  return true;
+  return GetConditionProgram(conditions)->Evaluate(
+      ctx.Client != nullptr,
+      [this, &ctx](const std::shared_ptr<objects::EventCondition>& condition) {
+        return EvaluateEventCondition(ctx, condition);
+      });
+}
+
+void EventManager::ClearConditionPrograms() {
+  std::lock_guard<std::mutex> lock(mConditionProgramsLock);
+  mConditionPrograms.clear();
+}
+
+std::shared_ptr<const EventConditionProgram> EventManager::GetConditionProgram(
+    const std::list<std::shared_ptr<objects::EventCondition>>& conditions) {
+  std::lock_guard<std::mutex> lock(mConditionProgramsLock);
+
+  auto& program = mConditionPrograms[conditions.front()];
+  if (!program || !program->IsCompiledFrom(conditions)) {
+    program = std::make_shared<EventConditionProgram>(conditions);
+  }
+
+  return program;
 }
 
 bool EventManager::EvaluateCondition(
@@ -3576,6 +3601,15 @@ void EventManager::EndWebGame(
   }
 }
 
+std::shared_ptr<libhack::ServerDataManager> EventManager::GetServerData(
+    EventContext& ctx) {
+  if (!ctx.ServerData) {
+    ctx.ServerData = mServer.lock()->GetServerDataManager();
+  }
+
+  return ctx.ServerData;
+}
+
 bool EventManager::HandleEvent(EventContext& ctx) {
   auto client = !ctx.AutoOnly ? ctx.Client : nullptr;
   if (ctx.EventInstance == nullptr) {
@@ -3717,7 +3751,7 @@ void EventManager::HandleNext(EventContext& ctx) {
   bool skipInvalid = event->GetSkipInvalid() || iState->GetSkipInvalid();
   if (skipInvalid) {
     // Filter out invalid next and branch results
-    auto serverDataManager = mServer.lock()->GetServerDataManager();
+    auto serverDataManager = GetServerData(ctx);
     if (serverDataManager->GetEventData(nextEventID) == nullptr) {
       nextEventID = "";
     }
@@ -3743,7 +3777,7 @@ void EventManager::HandleNext(EventContext& ctx) {
     if (!branchScriptID.IsEmpty()) {
       // Branch based on an index result of a script representing
       // the branch number to use
-      auto serverDataManager = mServer.lock()->GetServerDataManager();
+      auto serverDataManager = GetServerData(ctx);
       auto script = serverDataManager->GetScript(branchScriptID);
       if (ctx.Client && !ctx.CurrentZone) {
         LogEventManagerError([&]() {
@@ -3953,7 +3987,7 @@ bool EventManager::Prompt(EventContext& ctx) {
     bool skip = choice->GetMessageID() == 0;
     if (!skip && (e->GetSkipInvalid() || choice->GetSkipInvalid())) {
       // If all sub-next IDs are invalid, don't show the choice
-      auto serverDataManager = mServer.lock()->GetServerDataManager();
+      auto serverDataManager = GetServerData(ctx);
 
       bool valid =
           !choice->GetNext().IsEmpty() &&
@@ -4327,7 +4361,7 @@ bool EventManager::HandleWebGame(
 bool EventManager::PrepareTransformScript(
     EventContext& ctx, std::shared_ptr<libhack::ScriptEngine> engine) {
   auto server = mServer.lock();
-  auto serverDataManager = server->GetServerDataManager();
+  auto serverDataManager = GetServerData(ctx);
   auto e = ctx.EventInstance->GetEvent();
   auto script =
       e ? serverDataManager->GetScript(e->GetTransformScriptID()) : nullptr;
@@ -38,12 +38,18 @@
 #include <EventCondition.h>
 #include <EventInstance.h>
 
+// Standard C++11 Includes
+#include <mutex>
+#include <unordered_map>
+
 // channel Includes
 #include "ChannelClientConnection.h"
+#include "EventConditionProgram.h"
 
 namespace libhack {
 class ScriptEngine;
-}
+class ServerDataManager;
+}  // namespace libhack
 
 namespace objects {
 class EventConditionData;
@@ -361,15 +367,32 @@ class EventManager {
       const std::list<std::shared_ptr<objects::EventCondition>>& conditions,
       const std::shared_ptr<ChannelClientConnection>& client = nullptr);
 
+  /**
+   * Clear all compiled event condition lists so they are compiled again
+   * from the current server data.
+   */
+  void ClearConditionPrograms();
+
  private:
   struct EventContext {
     std::shared_ptr<ChannelClientConnection> Client;
     std::shared_ptr<Zone> CurrentZone;
     std::shared_ptr<objects::EventInstance> EventInstance;
     std::list<libcomp::String> TransformScriptParams;
+    std::shared_ptr<libhack::ServerDataManager> ServerData;
     bool AutoOnly = false;
   };
 
+  /**
+   * Get the server data used by the event context, pinning the current
+   * server data to it on first use so the whole event is handled with the
+   * same data even if it is reloaded part way through
+   * @param ctx Execution context of the event
+   * @return Pointer to the ServerDataManager
+   */
+  std::shared_ptr<libhack::ServerDataManager> GetServerData(
+      EventContext& ctx);
+
   /**
    * Handle an event instance by branching into the appropriate handler
    * function after updating the character's overhead icon if needed
@@ -414,6 +437,16 @@ class EventManager {
       EventContext& ctx,
       const std::list<std::shared_ptr<objects::EventCondition>>& conditions);
 
+  /**
+   * Get the compiled form of a list of event conditions, compiling it
+   * first if needed
+   * @param conditions Event conditions to get the compiled form of.
+   *  Cannot be empty
+   * @return Pointer to the compiled event conditions
+   */
+  std::shared_ptr<const EventConditionProgram> GetConditionProgram(
+      const std::list<std::shared_ptr<objects::EventCondition>>& conditions);
+
   /**
    * Evaluate a standard event condition
    * @param ctx Execution context of the event
@@ -666,6 +699,16 @@ class EventManager {
 
   /// Pointer to the channel server.
   std::weak_ptr<ChannelServer> mServer;
+
+  /// Compiled event condition lists by the first condition in each list.
+  /// Conditions are not shared between lists in the server data so each
+  /// list is only compiled once per server data version.
+  std::unordered_map<std::shared_ptr<objects::EventCondition>,
+                     std::shared_ptr<const EventConditionProgram>>
+      mConditionPrograms;
+
+  /// Lock for mConditionPrograms which is used from every worker
+  std::mutex mConditionProgramsLock;
 };
 
 }  // namespace channel
@@ -301,6 +301,8 @@ PACKET_PARSER_DECL(PartyUpdate);          // 0x100A
 PACKET_PARSER_DECL(ClanUpdate);           // 0x100B
 PACKET_PARSER_DECL(WebGame);              // 0x100C
 PACKET_PARSER_DECL(TeamUpdate);           // 0x100D
+PACKET_PARSER_DECL(ServerDataReload);     // 0x100E
+PACKET_PARSER_DECL(MemoryReport);         // 0x100F
 
 }  // namespace Parsers
 
@@ -59,3 +59,11 @@ void PerformanceTimer::Stop(const libcomp::String& metric) {
     });
   }
 }
+
+void PerformanceTimer::Count(const libcomp::String& metric, uint64_t value) {
+  if (mEnabled) {
+    LogGeneralDebug([&]() {
+      return libcomp::String("PERF: %1 count %2\n").Arg(metric).Arg(value);
+    });
+  }
+}
@@ -72,6 +72,13 @@ class PerformanceTimer {
    * @param metric Name of the task that was measured.
    */
   void Stop(const libcomp::String &metric);
+
+  /**
+   * Log a count measured during a task.
+   * @param metric Name of the value that was counted.
+   * @param value Value that was counted.
+   */
+  void Count(const libcomp::String &metric, uint64_t value);
 };
 
 }  // namespace channel
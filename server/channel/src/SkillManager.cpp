@@ -38,6 +38,7 @@
 #include <ServerDataManager.h>
 
 // Standard C++11 Includes
+#include <algorithm>
 #include <math.h>
 
 // object Includes
@@ -138,6 +139,7 @@
 #include "ChannelServer.h"
 #include "CharacterManager.h"
 #include "ChatManager.h"
+#include "DamageFormula.h"
 #include "EventManager.h"
 #include "ManagerConnection.h"
 #include "MatchManager.h"
@@ -227,11 +229,29 @@ const uint8_t NRA_OFFSET = (uint8_t)CorrectTbl::NRA_DEFAULT;
 const uint8_t AIL_OFFSET = (uint8_t)((uint8_t)CorrectTbl::RES_FIRE -
                                      (uint8_t)CorrectTbl::RES_DEFAULT - 1);
 
+class channel::SkillPlan {
+ public:
+  uint32_t SkillID = 0;
+  uint16_t FunctionID = 0;
+  std::shared_ptr<objects::MiSkillData> Definition;
+  const SkillFunction* Function = nullptr;
+  const SkillFunction* EffectFunction = nullptr;
+  std::shared_ptr<SkillLogicSettings> LogicSettings;
+  std::shared_ptr<libhack::ScriptEngine> LogicScript;
+  SkillActivationType_t ActivationType = (SkillActivationType_t)0;
+  bool IsProjectile = false;
+  bool CanNRA = true;
+  int32_t AbsoluteDamage = 0;
+  bool HasExpertise = false;
+  uint8_t ExpertiseType = 0;
+};
+
 class channel::ProcessingSkill {
  public:
   uint32_t SkillID = 0;
   uint16_t FunctionID = 0;
   std::shared_ptr<objects::MiSkillData> Definition;
+  std::shared_ptr<const SkillPlan> Plan;
   std::shared_ptr<objects::ActivatedAbility> Activated;
   SkillExecutionContext* ExecutionContext = 0;
   uint16_t Modifier1 = 0;
@@ -597,6 +617,9 @@ bool SkillManager::ActivateSkill(
   auto skillBasic = def->GetBasic();
   SkillActivationType_t activationType = skillBasic->GetActivationType();
 
+  // Activation checks and costs need current stats
+  server->GetCharacterManager()->FlushRecalculateStats(source);
+
   // Check for cooldown first
   source->ExpireStatusTimes(now);
   if (source->GetSkillCooldowns(skillBasic->GetCooldownID())) {
@@ -771,11 +794,9 @@ bool SkillManager::ActivateSkill(
 
     source->SetActivatedAbility(activated);
 
-    if (pSkill->FunctionID) {
-      if (mSkillFunctions.find(pSkill->FunctionID) != mSkillFunctions.end()) {
-        // Set special activation and let the respective skill handle it
-        source->SetSpecialActivations(activated->GetActivationID(), activated);
-      }
+    if (pSkill->Plan->Function) {
+      // Set special activation and let the respective skill handle it
+      source->SetSpecialActivations(activated->GetActivationID(), activated);
     }
 
     SendActivateSkill(pSkill);
@@ -1149,8 +1170,8 @@ bool SkillManager::ExecuteSkill(
   source->RefreshCurrentPosition(activated->GetExecutionTime());
 
   // Execute the skill
-  auto fIter = mSkillFunctions.find(pSkill->FunctionID);
-  if (fIter == mSkillFunctions.end()) {
+  auto function = pSkill->Plan->Function;
+  if (!function) {
     switch (skillCategory) {
       case SKILL_CATEGORY_ACTIVE:
         return ExecuteNormalSkill(client, activated, ctx);
@@ -1163,14 +1184,13 @@ bool SkillManager::ExecuteSkill(
     }
   }
 
-  bool success = fIter->second(*this, activated, ctx, client);
+  bool success = (*function)(*this, activated, ctx, client);
   if (success) {
     FinalizeSkillExecution(client, ctx, activated);
     FinalizeSkill(ctx, activated);
   } else {
     // Skip finalization if performing an instant activation
-    if (skillData->GetBasic()->GetActivationType() !=
-        SkillActivationType_t::INSTANT) {
+    if (pSkill->Plan->ActivationType != SkillActivationType_t::INSTANT) {
       // Clear skill first as it can affect movement speed
       source->SetActivatedAbility(nullptr);
       source->ResetUpkeep();
@@ -1189,16 +1209,13 @@ bool SkillManager::CancelSkill(const std::shared_ptr<ActiveEntityState> source,
     return false;
   } else {
     // If the skill is a special toggle, fire its function again
-    auto skillData = activated->GetSkillData();
-    auto functionID = skillData->GetDamage()->GetFunctionID();
-    auto fIter = mSkillFunctions.find(functionID);
-    if (fIter != mSkillFunctions.end() &&
-        skillData->GetBasic()->GetActivationType() ==
-            SkillActivationType_t::ON_TOGGLE) {
+    auto plan = GetSkillPlan(activated->GetSkillData());
+    if (plan->Function &&
+        plan->ActivationType == SkillActivationType_t::ON_TOGGLE) {
       auto ctx = std::make_shared<SkillExecutionContext>();
       auto client = mServer.lock()->GetManagerConnection()->GetEntityClient(
           source->GetEntityID());
-      fIter->second(*this, activated, ctx, client);
+      (*plan->Function)(*this, activated, ctx, client);
     }
 
     // A skill is considered hit cancelled if its pending a hit
@@ -3263,18 +3280,29 @@ bool SkillManager::ProcessSkillResult(
             break;
           }
 
+          // Only entities in the bounding box of the line can be in the
+          // line so only those need to be checked against the polygon
+          float minX = rect.front().x;
+          float minY = rect.front().y;
+          float maxX = minX;
+          float maxY = minY;
+          for (auto& corner : rect) {
+            minX = std::min(minX, corner.x);
+            minY = std::min(minY, corner.y);
+            maxX = std::max(maxX, corner.x);
+            maxY = std::max(maxY, corner.y);
+          }
+
           // Gather entities in the polygon as well as ones bisected
-          // by the boundaries on their hitbox
-          uint64_t now = ChannelServer::GetServerTime();
-          for (auto t : zone->GetActiveEntities()) {
+          // by the boundaries on their hitbox. The source does not need
+          // to be checked and is always added.
+          effectiveTargets.push_back(effectiveSource);
+          for (auto& t :
+               zone->GetActiveEntitiesInBox(minX, minY, maxX, maxY, true)) {
             if (t == effectiveSource) {
-              // Do not check, just add
-              effectiveTargets.push_back(t);
               continue;
             }
 
-            t->RefreshCurrentPosition(now);
-
             Point p(t->GetCurrentX(), t->GetCurrentY());
             if (ZoneManager::PointInPolygon(p, rect,
                                             (float)t->GetHitboxSize() * 10.f)) {
@@ -3525,11 +3553,10 @@ bool SkillManager::ProcessSkillResult(
   }
 
   // Apply skill effect functions now that all normal handling is complete
-  auto fIter = mSkillEffectFunctions.find(pSkill->FunctionID);
-  if (fIter != mSkillEffectFunctions.end()) {
+  if (pSkill->Plan->EffectFunction) {
     auto client =
         server->GetManagerConnection()->GetEntityClient(source->GetEntityID());
-    fIter->second(*this, activated, ctx, client);
+    (*pSkill->Plan->EffectFunction)(*this, activated, ctx, client);
   }
 
   if (skillData->GetBasic()->GetCombatSkill() && ctx->ApplyAggro) {
@@ -3580,6 +3607,12 @@ void SkillManager::ProcessSkillResultFinal(
   auto tokuseiManager = server->GetTokuseiManager();
   auto zoneManager = server->GetZoneManager();
 
+  // Damage and status calculations need current stats
+  characterManager->FlushRecalculateStats(source);
+  for (auto& target : skill.Targets) {
+    characterManager->FlushRecalculateStats(target.EntityState);
+  }
+
   auto damageData = skill.Definition->GetDamage();
   bool hasBattleDamage = damageData->GetBattleDamage()->GetFormula() !=
                          objects::MiBattleDamageData::Formula_t::NONE;
@@ -4056,26 +4089,8 @@ void SkillManager::ProcessSkillResultFinal(
 
   // Recalculate any effects that trigger from the skill effects
   std::unordered_map<int32_t, bool> effectRecalc;
-  for (SkillTargetResult& target : skill.Targets) {
-    if (target.RecalcTriggers.size() == 0) continue;
-
-    std::unordered_map<int32_t, bool> result;
-
-    auto eState = target.EntityState;
-    auto& triggers = target.RecalcTriggers;
-
-    // Anything with a status effect modified needs a full tokusei
-    // and stat recalc
-    bool statusChanged =
-        triggers.find(TokuseiConditionType::STATUS_ACTIVE) != triggers.end();
-    if (effectRecalc.find(eState->GetEntityID()) == effectRecalc.end()) {
-      if (statusChanged) {
-        result = tokuseiManager->Recalculate(eState, true);
-      } else {
-        result = tokuseiManager->Recalculate(eState, triggers);
-      }
-    }
-
+  auto mergeRecalc = [&effectRecalc](
+                         const std::unordered_map<int32_t, bool>& result) {
     for (auto resultPair : result) {
       if (effectRecalc.find(resultPair.first) == effectRecalc.end()) {
         effectRecalc[resultPair.first] = resultPair.second;
@@ -4083,9 +4098,51 @@ void SkillManager::ProcessSkillResultFinal(
         effectRecalc[resultPair.first] |= resultPair.second;
       }
     }
+  };
 
-    if (statusChanged && !effectRecalc[eState->GetEntityID()]) {
-      characterManager->RecalculateStats(eState);
+  // Anything with a status effect modified needs a full tokusei and stat
+  // recalc. Each group of entities that can affect one another (such as a
+  // party) is recalculated on its own, and only once even if the skill
+  // hit several of its members.
+  std::list<std::shared_ptr<ActiveEntityState>> statusChanged;
+  std::set<int32_t> statusChangedIDs;
+  std::set<int32_t> statusRecalcIDs;
+  for (SkillTargetResult& target : skill.Targets) {
+    auto& triggers = target.RecalcTriggers;
+    auto eState = target.EntityState;
+    if (triggers.find(TokuseiConditionType::STATUS_ACTIVE) == triggers.end() ||
+        !statusChangedIDs.insert(eState->GetEntityID()).second) {
+      continue;
+    }
+
+    statusChanged.push_back(eState);
+
+    if (statusRecalcIDs.find(eState->GetEntityID()) == statusRecalcIDs.end()) {
+      auto group = tokuseiManager->GetAllTokuseiEntities(eState);
+      for (auto& entity : group) {
+        statusRecalcIDs.insert(entity->GetEntityID());
+      }
+
+      mergeRecalc(tokuseiManager->Recalculate(group, true));
+    }
+  }
+
+  for (SkillTargetResult& target : skill.Targets) {
+    auto& triggers = target.RecalcTriggers;
+    if (triggers.size() == 0 ||
+        triggers.find(TokuseiConditionType::STATUS_ACTIVE) != triggers.end()) {
+      continue;
+    }
+
+    auto eState = target.EntityState;
+    if (effectRecalc.find(eState->GetEntityID()) == effectRecalc.end()) {
+      mergeRecalc(tokuseiManager->Recalculate(eState, triggers));
+    }
+  }
+
+  for (auto& eState : statusChanged) {
+    if (!effectRecalc[eState->GetEntityID()]) {
+      characterManager->QueueRecalculateStats(eState);
     }
   }
 
@@ -4749,9 +4806,12 @@ std::shared_ptr<ProcessingSkill> SkillManager::GetProcessingSkill(
   auto cSource = std::dynamic_pointer_cast<CharacterState>(source);
   auto state = ClientState::GetEntityClientState(source->GetEntityID(), false);
 
+  auto plan = GetSkillPlan(skillData);
+
   auto skill = std::make_shared<ProcessingSkill>();
-  skill->SkillID = skillData->GetCommon()->GetID();
+  skill->SkillID = plan->SkillID;
   skill->Definition = skillData;
+  skill->Plan = plan;
   skill->Activated = activated;
   skill->Modifier1 = skillData->GetDamage()->GetBattleDamage()->GetModifier1();
   skill->Modifier2 = skillData->GetDamage()->GetBattleDamage()->GetModifier2();
@@ -4766,16 +4826,10 @@ std::shared_ptr<ProcessingSkill> SkillManager::GetProcessingSkill(
   skill->CurrentZone = source->GetZone();
   skill->InPvP = skill->CurrentZone &&
                  skill->CurrentZone->GetInstanceType() == InstanceType_t::PVP;
-  skill->IsProjectile =
-      skillData->GetDischarge()->GetProjectileSpeed() &&
-      skillData->GetTarget()->GetType() != objects::MiTargetData::Type_t::NONE;
-  skill->FunctionID = skillData->GetDamage()->GetFunctionID();
-
-  // Non-combat skills cannot be NRA'd meaning NRA_HEAL was (apparently)
-  // never implemented originally
-  skill->CanNRA = skillData->GetBasic()->GetCombatSkill() &&
-                  (!skill->FunctionID ||
-                   skill->FunctionID != SVR_CONST.SKILL_ZONE_TARGET_ALL);
+  skill->IsProjectile = plan->IsProjectile;
+  skill->FunctionID = plan->FunctionID;
+  skill->CanNRA = plan->CanNRA;
+  skill->AbsoluteDamage = plan->AbsoluteDamage;
 
   // Set item ID for the skill.
   if (state &&
@@ -4789,18 +4843,9 @@ std::shared_ptr<ProcessingSkill> SkillManager::GetProcessingSkill(
     skill->ItemID = item ? item->GetType() : 0;
   }
 
-  if (skill->FunctionID &&
-      (skill->FunctionID == SVR_CONST.SKILL_ABS_DAMAGE ||
-       skill->FunctionID == SVR_CONST.SKILL_ZONE_TARGET_ALL)) {
-    skill->AbsoluteDamage = skillData->GetSpecial()->GetSpecialParams(0);
-  }
-
   // Set the expertise and any boosts gained from ranks
-  // The expertise type of a skill is determined by the first
-  // type listed in the expertise growth list (defaults to attack)
-  auto expGrowth = skillData->GetExpertGrowth();
-  if (expGrowth.size() > 0) {
-    skill->ExpertiseType = expGrowth.front()->GetExpertiseID();
+  if (plan->HasExpertise) {
+    skill->ExpertiseType = plan->ExpertiseType;
     if (cSource) {
       skill->ExpertiseRankBoost =
           cSource->GetExpertiseRank(skill->ExpertiseType, definitionManager);
@@ -4944,6 +4989,72 @@ std::shared_ptr<ProcessingSkill> SkillManager::GetProcessingSkill(
   return skill;
 }
 
+std::shared_ptr<const SkillPlan> SkillManager::GetSkillPlan(
+    const std::shared_ptr<objects::MiSkillData>& skillData) {
+  uint32_t skillID = skillData->GetCommon()->GetID();
+
+  {
+    std::lock_guard<std::mutex> lock(mSkillPlanLock);
+    auto it = mSkillPlans.find(skillID);
+    if (it != mSkillPlans.end() && it->second->Definition == skillData) {
+      return it->second;
+    }
+  }
+
+  auto plan = std::make_shared<SkillPlan>();
+  plan->SkillID = skillID;
+  plan->Definition = skillData;
+  plan->FunctionID = skillData->GetDamage()->GetFunctionID();
+  plan->ActivationType = skillData->GetBasic()->GetActivationType();
+  plan->IsProjectile =
+      skillData->GetDischarge()->GetProjectileSpeed() &&
+      skillData->GetTarget()->GetType() != objects::MiTargetData::Type_t::NONE;
+
+  // Non-combat skills cannot be NRA'd meaning NRA_HEAL was (apparently)
+  // never implemented originally
+  plan->CanNRA = skillData->GetBasic()->GetCombatSkill() &&
+                 (!plan->FunctionID ||
+                  plan->FunctionID != SVR_CONST.SKILL_ZONE_TARGET_ALL);
+
+  if (plan->FunctionID) {
+    // The handler maps are never modified after construction so the
+    // functions can be referenced directly
+    auto fIter = mSkillFunctions.find(plan->FunctionID);
+    if (fIter != mSkillFunctions.end()) {
+      plan->Function = &fIter->second;
+    }
+
+    fIter = mSkillEffectFunctions.find(plan->FunctionID);
+    if (fIter != mSkillEffectFunctions.end()) {
+      plan->EffectFunction = &fIter->second;
+    }
+
+    auto settingsIter = mSkillLogicSettings.find(plan->FunctionID);
+    if (settingsIter != mSkillLogicSettings.end()) {
+      plan->LogicSettings = settingsIter->second;
+      plan->LogicScript = mSkillLogicScripts[plan->FunctionID];
+    }
+
+    if (plan->FunctionID == SVR_CONST.SKILL_ABS_DAMAGE ||
+        plan->FunctionID == SVR_CONST.SKILL_ZONE_TARGET_ALL) {
+      plan->AbsoluteDamage = skillData->GetSpecial()->GetSpecialParams(0);
+    }
+  }
+
+  // The expertise type of a skill is determined by the first
+  // type listed in the expertise growth list (defaults to attack)
+  auto expGrowth = skillData->GetExpertGrowth();
+  if (expGrowth.size() > 0) {
+    plan->HasExpertise = true;
+    plan->ExpertiseType = expGrowth.front()->GetExpertiseID();
+  }
+
+  std::lock_guard<std::mutex> lock(mSkillPlanLock);
+  mSkillPlans[skillID] = plan;
+
+  return plan;
+}
+
 std::shared_ptr<objects::CalculatedEntityState>
 SkillManager::GetCalculatedState(
     const std::shared_ptr<ActiveEntityState>& eState,
@@ -8894,65 +9005,29 @@ int32_t SkillManager::CalculateDamage_Normal(
 
     def = (uint16_t)(def + target.GuardModifier);
 
-    float scale = 0.f;
-    switch (critLevel) {
-      case 1:  // Critical hit
-        scale = 1.2f;
-        break;
-      case 2:  // Limit Break
-        scale =
-            1.5f *
-            (float)source->GetCorrectValue(CorrectTbl::LB_DAMAGE, calcState) *
-            0.01f;
-        break;
-      default:  // Normal hit, 80%-99% damage
-        scale = RNG_DEC(float, 0.8f, 0.99f, 2);
-        break;
-    }
-
-    // Damage starts with offense stat * modifier/100
-    float calc = (float)off * ((float)mod * 0.01f);
-
-    // Add the expertise modifier
-    calc = calc + (float)skill.ExpertiseRankBoost * 0.5f;
+    NormalDamageParams params;
+    params.Offense = off;
+    params.Modifier = mod;
+    params.ExpertiseRankBoost = skill.ExpertiseRankBoost;
+    params.Defense = def;
+    params.CritLevel = critLevel;
+    params.Scale = DamageFormula::GetScale(
+        critLevel,
+        critLevel == 2
+            ? source->GetCorrectValue(CorrectTbl::LB_DAMAGE, calcState)
+            : 0);
+    params.Resist = resist;
+    params.Boost = boost;
 
-    // Subtract the enemy defense, unless its a critical or limit break
     if (critLevel > 0) {
       const static float reduction =
           mServer.lock()->GetWorldSharedConfig()->GetCritDefenseReduction();
-      if (reduction != 1.f) {
-        // Non-full reduction on crit
-        calc = calc - (float)def * (1.f - reduction);
-      }
-    } else {
-      calc = calc - (float)def;
+      params.CritDefenseReduction = reduction;
     }
 
-    if (calc > 0.f) {
-      // Scale the current value by the critical, limit break or min to
-      // max damage factor
-      calc = calc * scale;
-
-      // Multiply by 100% + -resistance
-      calc = calc * (1.f + resist * -1.f);
-
-      // Multiply by 100% + boost
-      calc = calc * (1.f + boost);
-
-      // Floor and adjust rates, and prevent overflow
-      if (calc > (float)std::numeric_limits<int32_t>::max()) {
-        amount = AdjustDamageRates(std::numeric_limits<int32_t>::max(), source,
-                                   target.EntityState, pSkill, isHeal, true);
-      } else {
-        amount = AdjustDamageRates((int32_t)floor(calc), source,
-                                   target.EntityState, pSkill, isHeal, true);
-      }
-    }
-
-    if (amount < 1) {
-      // Apply minimum value of 1
-      amount = 1;
-    }
+    amount = DamageFormula::CalculateNormalHit(
+        params,
+        GetDamageRates(source, target.EntityState, pSkill, isHeal, true));
 
     damageType = DAMAGE_TYPE_GENERIC;
   }
@@ -9002,6 +9077,15 @@ int32_t SkillManager::AdjustDamageRates(
     const std::shared_ptr<ActiveEntityState>& target,
     const std::shared_ptr<channel::ProcessingSkill>& pSkill, bool isHeal,
     bool adjustPower) {
+  return DamageFormula::ApplyRates(
+      damage, GetDamageRates(source, target, pSkill, isHeal, adjustPower));
+}
+
+DamageRateParams SkillManager::GetDamageRates(
+    const std::shared_ptr<ActiveEntityState>& source,
+    const std::shared_ptr<ActiveEntityState>& target,
+    const std::shared_ptr<channel::ProcessingSkill>& pSkill, bool isHeal,
+    bool adjustPower) {
   auto calcState = GetCalculatedState(source, pSkill, false, target);
   auto targetState = GetCalculatedState(target, pSkill, true, source);
 
@@ -9098,51 +9182,27 @@ int32_t SkillManager::AdjustDamageRates(
     }
   }
 
-  float calc = (float)damage;
-  std::list<float> rateTaken;
+  DamageRateParams params;
 
   // If the source is not hitting itself, apply entity rates
   if (source != target) {
-    // Multiply by entity rate dealt
-    calc = calc * (float)(GetEntityRate(target, calcState, false) * 0.01);
-
-    // Multiply by entity rate taken
-    rateTaken.push_back(
-        (float)(GetEntityRate(source, targetState, true) * 0.01));
-  }
-
-  // Multiply by dependency rate dealt even to source if it is a heal
-  if (isHeal || source != target) {
-    calc = calc * (float)(dependencyDealt * 0.01);
-  }
-
-  if (tokuseiDamageDealt != 0.0) {
-    // Multiply by 1 + remaining power increases/100
-    calc = calc * (float)(1.0 + tokuseiDamageDealt);
-  }
-
-  // Multiply by dependency rate taken
-  rateTaken.push_back((float)(dependencyTaken * 0.01));
-
-  // Multiply by 100% + -general rate taken, calculated earluer
-  rateTaken.push_back((float)tokuseiDamageTaken);
-
-  for (float taken : rateTaken) {
-    // Apply rate taken if not piercing or rate is not a reduction
-    if (!pSkill->FunctionID || pSkill->FunctionID != SVR_CONST.SKILL_PIERCE ||
-        taken > 1.f) {
-      calc = calc * taken;
-    }
-  }
-
-  // Apply floor and enforce maximum.
-  if (calc < 0.f) {
-    calc = 0.f;
-  } else if (calc > (float)std::numeric_limits<int32_t>::max()) {
-    return std::numeric_limits<int32_t>::max();
-  }
-
-  return (int32_t)floor(calc);
+    params.ApplyEntityRates = true;
+    params.EntityRateDealt =
+        (float)(GetEntityRate(target, calcState, false) * 0.01);
+    params.EntityRateTaken =
+        (float)(GetEntityRate(source, targetState, true) * 0.01);
+  }
+
+  // Apply dependency rate dealt even to source if it is a heal
+  params.ApplyDependencyDealt = isHeal || source != target;
+  params.DependencyDealt = (float)(dependencyDealt * 0.01);
+  params.DependencyTaken = (float)(dependencyTaken * 0.01);
+  params.PowerBoost = tokuseiDamageDealt;
+  params.DamageTaken = tokuseiDamageTaken;
+  params.Pierce = pSkill->FunctionID &&
+                  pSkill->FunctionID == SVR_CONST.SKILL_PIERCE;
+
+  return params;
 }
 
 SkillTargetResult* SkillManager::GetSelfTarget(
@@ -11865,25 +11925,20 @@ bool SkillManager::XPUp(
 
 bool SkillManager::CheckScriptValidation(
     const std::shared_ptr<channel::ProcessingSkill>& pSkill, bool execution) {
-  if (!pSkill->FunctionID) {
+  auto settings = pSkill->Plan->LogicSettings;
+  if (!settings || (execution && !settings->HasExecutionValidation) ||
+      (!execution && !settings->HasActivationValidation)) {
     // Nothing to do
     return true;
   }
 
-  auto settingsIter = mSkillLogicSettings.find(pSkill->FunctionID);
-  if (settingsIter == mSkillLogicSettings.end() ||
-      (execution && !settingsIter->second->HasExecutionValidation) ||
-      (!execution && !settingsIter->second->HasActivationValidation)) {
-    return true;
-  }
-
   auto source = std::dynamic_pointer_cast<ActiveEntityState>(
       pSkill->Activated->GetSourceEntity());
   auto state = source ? ClientState::GetEntityClientState(source->GetEntityID())
                       : nullptr;
 
   Sqrat::Function f(
-      Sqrat::RootTable(mSkillLogicScripts[pSkill->FunctionID]->GetVM()),
+      Sqrat::RootTable(pSkill->Plan->LogicScript->GetVM()),
       execution ? "validateExecution" : "validateActivation");
   auto result = !f.IsNull()
                     ? f.Evaluate<int32_t>(
@@ -11909,24 +11964,19 @@ bool SkillManager::CheckScriptValidation(
 
 bool SkillManager::AdjustScriptCosts(
     const std::shared_ptr<channel::ProcessingSkill>& pSkill) {
-  if (!pSkill->FunctionID) {
+  auto settings = pSkill->Plan->LogicSettings;
+  if (!settings || !settings->HasCostAdjustment) {
     // Nothing to do
     return true;
   }
 
-  auto settingsIter = mSkillLogicSettings.find(pSkill->FunctionID);
-  if (settingsIter == mSkillLogicSettings.end() ||
-      !settingsIter->second->HasCostAdjustment) {
-    return true;
-  }
-
   auto source = std::dynamic_pointer_cast<ActiveEntityState>(
       pSkill->Activated->GetSourceEntity());
   auto state = source ? ClientState::GetEntityClientState(source->GetEntityID())
                       : nullptr;
 
   Sqrat::Function f(
-      Sqrat::RootTable(mSkillLogicScripts[pSkill->FunctionID]->GetVM()),
+      Sqrat::RootTable(pSkill->Plan->LogicScript->GetVM()),
       "adjustCost");
   auto result = !f.IsNull()
                     ? f.Evaluate<int32_t>(
@@ -11953,23 +12003,18 @@ bool SkillManager::AdjustScriptCosts(
 bool SkillManager::ExecuteScriptPreActions(
     const std::shared_ptr<channel::ProcessingSkill>& pSkill,
     std::list<std::shared_ptr<channel::ActiveEntityState>> targets) {
-  if (!pSkill->FunctionID) {
+  auto settings = pSkill->Plan->LogicSettings;
+  if (!settings || !settings->HasPreAction) {
     // Nothing to do
     return true;
   }
 
-  auto settingsIter = mSkillLogicSettings.find(pSkill->FunctionID);
-  if (settingsIter == mSkillLogicSettings.end() ||
-      !settingsIter->second->HasPreAction) {
-    return true;
-  }
-
   auto source = std::dynamic_pointer_cast<ActiveEntityState>(
       pSkill->Activated->GetSourceEntity());
   auto state = source ? ClientState::GetEntityClientState(source->GetEntityID())
                       : nullptr;
 
-  auto vm = mSkillLogicScripts[pSkill->FunctionID]->GetVM();
+  auto vm = pSkill->Plan->LogicScript->GetVM();
   Sqrat::Array targetStates(vm);
   for (auto& targetState : targets) {
     targetStates.Append(targetState);
@@ -11999,23 +12044,18 @@ bool SkillManager::ExecuteScriptPreActions(
 
 bool SkillManager::ExecuteScriptPostActions(
     const std::shared_ptr<channel::ProcessingSkill>& pSkill) {
-  if (!pSkill->FunctionID) {
+  auto settings = pSkill->Plan->LogicSettings;
+  if (!settings || !settings->HasPostAction) {
     // Nothing to do
     return true;
   }
 
-  auto settingsIter = mSkillLogicSettings.find(pSkill->FunctionID);
-  if (settingsIter == mSkillLogicSettings.end() ||
-      !settingsIter->second->HasPostAction) {
-    return true;
-  }
-
   auto source = std::dynamic_pointer_cast<ActiveEntityState>(
       pSkill->Activated->GetSourceEntity());
   auto state = source ? ClientState::GetEntityClientState(source->GetEntityID())
                       : nullptr;
 
-  auto vm = mSkillLogicScripts[pSkill->FunctionID]->GetVM();
+  auto vm = pSkill->Plan->LogicScript->GetVM();
   Sqrat::Array directTargets(vm);
   // std::list<SkillTargetResult*> directTargets;
   for (auto& target : pSkill->Targets) {
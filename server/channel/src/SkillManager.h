@@ -33,6 +33,9 @@
 // objgen Includes
 #include <MiSkillBasicData.h>
 
+// Standard C++11 Includes
+#include <mutex>
+
 namespace libhack {
 class ScriptEngine;
 }
@@ -53,13 +56,24 @@ typedef objects::MiSkillBasicData::ActivationType_t SkillActivationType_t;
 typedef objects::MiSkillBasicData::DependencyType_t SkillDependencyType_t;
 typedef objects::MiSkillBasicData::Family_t SkillFamily_t;
 
+struct DamageRateParams;
 class ProcessingSkill;
 class SkillLogicSettings;
+class SkillPlan;
 class SkillTargetResult;
 
 class ActiveEntityState;
 class AIState;
 class ChannelServer;
+class SkillManager;
+class SkillExecutionContext;
+
+/// Manager function used to handle a skill with a specific function ID
+typedef std::function<bool(SkillManager&,
+                           const std::shared_ptr<objects::ActivatedAbility>&,
+                           const std::shared_ptr<SkillExecutionContext>&,
+                           const std::shared_ptr<ChannelClientConnection>&)>
+    SkillFunction;
 
 /**
  * Container for skill execution contextual parameters.
@@ -514,6 +528,17 @@ class SkillManager {
       std::shared_ptr<objects::ActivatedAbility> activated,
       std::shared_ptr<SkillExecutionContext> ctx);
 
+  /**
+   * Get the execution plan for a skill, building it if this is the first
+   * time the skill has been processed. The plan holds the handler
+   * functions, logic script and fixed values derived from the definition
+   * so they are not looked up again on every use.
+   * @param skillData Pointer to the skill definition
+   * @return Pointer to the execution plan for the skill
+   */
+  std::shared_ptr<const SkillPlan> GetSkillPlan(
+      const std::shared_ptr<objects::MiSkillData>& skillData);
+
   /**
    * Get a CalculatedEntityState based upon the skill being executed and
    * the state of the entity as either the source or a target of the skill.
@@ -942,6 +967,22 @@ class SkillManager {
       const std::shared_ptr<channel::ProcessingSkill>& pSkill, bool isHeal,
       bool adjustPower);
 
+  /**
+   * Get the skill rates from the source and target entities used to
+   * adjust skill damage or healing
+   * @param source Pointer to the entity that activated the skill
+   * @param target Pointer to the entity that will receive damage
+   * @param pSkill Pointer to the current skill processing state
+   * @param isHeal true if healing "damage" should be applied instead
+   * @param adjustPower If true, adjuste tokusei EFFECT_POWER as well
+   * @return Rates to apply to the damage or healing
+   */
+  DamageRateParams GetDamageRates(
+      const std::shared_ptr<ActiveEntityState>& source,
+      const std::shared_ptr<ActiveEntityState>& target,
+      const std::shared_ptr<channel::ProcessingSkill>& pSkill, bool isHeal,
+      bool adjustPower);
+
   /**
    * Get the skill target that hits the source entity or create it if it does
    * not already exist
@@ -1565,23 +1606,11 @@ class SkillManager {
 
   /// Map of skill function IDs mapped to manager functions that execute
   /// in place of the normal skill handler.
-  std::unordered_map<
-      uint16_t,
-      std::function<bool(SkillManager&,
-                         const std::shared_ptr<objects::ActivatedAbility>&,
-                         const std::shared_ptr<SkillExecutionContext>&,
-                         const std::shared_ptr<ChannelClientConnection>&)>>
-      mSkillFunctions;
+  std::unordered_map<uint16_t, SkillFunction> mSkillFunctions;
 
   /// Map of skill function IDs mapped to manager functions that perform
   /// special actions after the normal skill processing completes.
-  std::unordered_map<
-      uint16_t,
-      std::function<bool(SkillManager&,
-                         const std::shared_ptr<objects::ActivatedAbility>&,
-                         const std::shared_ptr<SkillExecutionContext>&,
-                         const std::shared_ptr<ChannelClientConnection>&)>>
-      mSkillEffectFunctions;
+  std::unordered_map<uint16_t, SkillFunction> mSkillEffectFunctions;
 
   /// Map of skill function IDs to prepared scripts to be executed during
   /// one of several points during skill processing.
@@ -1592,6 +1621,13 @@ class SkillManager {
   /// special logic to apply to the associated skills.
   std::unordered_map<uint16_t, std::shared_ptr<SkillLogicSettings>>
       mSkillLogicSettings;
+
+  /// Map of skill IDs to execution plans built the first time each skill
+  /// is processed
+  std::unordered_map<uint32_t, std::shared_ptr<const SkillPlan>> mSkillPlans;
+
+  /// Server lock for the skill plan cache
+  std::mutex mSkillPlanLock;
 };
 
 }  // namespace channel
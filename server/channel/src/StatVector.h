@@ -0,0 +1,168 @@
+/**
+ * @file server/channel/src/StatVector.h
+ * @ingroup channel
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Fixed size stat accumulator indexed by correct table ID.
+ *
+ * This file is part of the Channel Server (channel).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SERVER_CHANNEL_SRC_STATVECTOR_H
+#define SERVER_CHANNEL_SRC_STATVECTOR_H
+
+// Standard C++11 Includes
+#include <array>
+#include <bitset>
+#include <initializer_list>
+
+// object Includes
+#include <MiCorrectTbl.h>
+
+namespace channel {
+
+/// Number of correct table entries on an entity
+const size_t CORRECT_TBL_COUNT = 126;
+
+/**
+ * Set of flags indexed by correct table ID.
+ */
+class StatFlags {
+ public:
+  /**
+   * Create a set with no flags set.
+   */
+  StatFlags() {}
+
+  /**
+   * Create a set with the supplied flags set.
+   * @param ids Correct table IDs to set
+   */
+  StatFlags(std::initializer_list<objects::MiCorrectTbl::ID_t> ids) {
+    for (auto id : ids) {
+      Set(id);
+    }
+  }
+
+  /**
+   * Check if a flag is set.
+   * @param id Correct table ID to check
+   * @return true if the flag is set
+   */
+  bool Has(objects::MiCorrectTbl::ID_t id) const {
+    return (size_t)id < CORRECT_TBL_COUNT && mFlags.test((size_t)id);
+  }
+
+  /**
+   * Set a flag.
+   * @param id Correct table ID to set
+   */
+  void Set(objects::MiCorrectTbl::ID_t id) {
+    if ((size_t)id < CORRECT_TBL_COUNT) {
+      mFlags.set((size_t)id);
+    }
+  }
+
+ private:
+  /// Flag per correct table ID
+  std::bitset<CORRECT_TBL_COUNT> mFlags;
+};
+
+/**
+ * Flat stat accumulator with one slot per correct table ID. Each slot
+ * also tracks if it has been set so an unset slot can be told apart
+ * from one that sums to zero. Used in place of a map when summing many
+ * adjustments during a stat calculation.
+ */
+template <typename T>
+class StatVector {
+ public:
+  /**
+   * Create a vector with every slot unset.
+   */
+  StatVector() { mValues.fill(0); }
+
+  /**
+   * Check if a slot has been set.
+   * @param id Correct table ID of the slot
+   * @return true if the slot has been set
+   */
+  bool Has(objects::MiCorrectTbl::ID_t id) const {
+    return (size_t)id < CORRECT_TBL_COUNT && mSet.test((size_t)id);
+  }
+
+  /**
+   * Get the value of a slot.
+   * @param id Correct table ID of the slot
+   * @return Value of the slot or zero if it is unset
+   */
+  T Get(objects::MiCorrectTbl::ID_t id) const {
+    return (size_t)id < CORRECT_TBL_COUNT ? mValues[(size_t)id] : 0;
+  }
+
+  /**
+   * Add to the value of a slot, setting it if it was unset.
+   * @param id Correct table ID of the slot
+   * @param value Value to add
+   */
+  void Add(objects::MiCorrectTbl::ID_t id, T value) {
+    if ((size_t)id < CORRECT_TBL_COUNT) {
+      mValues[(size_t)id] = (T)(mValues[(size_t)id] + value);
+      mSet.set((size_t)id);
+    }
+  }
+
+  /**
+   * Set a slot to the larger of its current value and the supplied one.
+   * An unset slot always takes the supplied value.
+   * @param id Correct table ID of the slot
+   * @param value Value to compare
+   */
+  void Max(objects::MiCorrectTbl::ID_t id, T value) {
+    if ((size_t)id < CORRECT_TBL_COUNT) {
+      if (!mSet.test((size_t)id) || mValues[(size_t)id] < value) {
+        mValues[(size_t)id] = value;
+      }
+
+      mSet.set((size_t)id);
+    }
+  }
+
+  /**
+   * Unset a slot.
+   * @param id Correct table ID of the slot
+   */
+  void Erase(objects::MiCorrectTbl::ID_t id) {
+    if ((size_t)id < CORRECT_TBL_COUNT) {
+      mValues[(size_t)id] = 0;
+      mSet.reset((size_t)id);
+    }
+  }
+
+ private:
+  /// Value per correct table ID
+  alignas(16) std::array<T, CORRECT_TBL_COUNT> mValues;
+
+  /// Flag per correct table ID indicating the slot has been set
+  std::bitset<CORRECT_TBL_COUNT> mSet;
+};
+
+}  // namespace channel
+
+#endif  // SERVER_CHANNEL_SRC_STATVECTOR_H
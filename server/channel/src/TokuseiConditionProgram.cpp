@@ -0,0 +1,158 @@
+/**
+ * @file server/channel/src/TokuseiConditionProgram.cpp
+ * @ingroup channel
+ *
+ * @author HACKfrost
+ *
+ * @brief Tokusei conditions compiled into a flat list of steps.
+ *
+ * This file is part of the Channel Server (channel).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TokuseiConditionProgram.h"
+
+// Standard C++11 Includes
+#include <list>
+#include <map>
+
+using namespace channel;
+
+typedef objects::TokuseiCondition::Type_t TokuseiConditionType;
+
+TokuseiConditionProgram::TokuseiConditionProgram(
+    const std::shared_ptr<objects::Tokusei>& tokusei)
+    : mSource(tokusei), mNeverPasses(false) {
+  // Compile each condition into a step along with its relative evaluation
+  // cost. Conditions that can never pass are dropped from their option
+  // group or fail the whole program.
+  std::list<std::pair<uint8_t, Step>> singular;
+  std::map<uint8_t, std::list<std::pair<uint8_t, Step>>> optionGroups;
+  for (auto condition : tokusei->GetConditions()) {
+    bool numericCompare =
+        condition->GetComparator() !=
+            objects::TokuseiCondition::Comparator_t::EQUALS &&
+        condition->GetComparator() !=
+            objects::TokuseiCondition::Comparator_t::NOT_EQUAL;
+
+    Step step;
+    step.Condition = condition;
+    step.GroupRemaining = 0;
+    step.InGroup = condition->GetOptionGroupID() != 0;
+    step.CharacterOnly = false;
+
+    uint8_t cost = 0;
+    bool neverPasses = false;
+    switch (condition->GetType()) {
+      case TokuseiConditionType::CURRENT_HP:
+      case TokuseiConditionType::CURRENT_MP:
+      case TokuseiConditionType::GAME_TIME:
+      case TokuseiConditionType::MOON_PHASE:
+        break;
+      case TokuseiConditionType::LNC:
+      case TokuseiConditionType::GENDER:
+      case TokuseiConditionType::STATUS_ACTIVE:
+        neverPasses = numericCompare;
+        break;
+      case TokuseiConditionType::DIGITALIZED:
+        neverPasses = numericCompare;
+        step.CharacterOnly = true;
+        break;
+      case TokuseiConditionType::EQUIPPED_WEAPON_TYPE:
+        neverPasses = numericCompare;
+        step.CharacterOnly = true;
+        cost = 1;
+        break;
+      case TokuseiConditionType::EXPERTISE:
+        step.CharacterOnly = true;
+        cost = 1;
+        break;
+      case TokuseiConditionType::DIASPORA_MINIBOSS_COUNT:
+        cost = 1;
+        break;
+      case TokuseiConditionType::PARTNER_FAMILIARITY:
+      case TokuseiConditionType::PARTNER_MITAMA:
+        step.CharacterOnly = true;
+        cost = 2;
+        break;
+      case TokuseiConditionType::PARTNER_TYPE:
+      case TokuseiConditionType::PARTNER_FAMILY:
+      case TokuseiConditionType::PARTNER_RACE:
+        neverPasses = numericCompare;
+        step.CharacterOnly = true;
+        cost = 2;
+        break;
+      case TokuseiConditionType::PARTY_DEMON_TYPE:
+        neverPasses = numericCompare;
+        cost = 2;
+        break;
+      case TokuseiConditionType::SKILL_STATE:
+      default:
+        // Never valid outside of skill processing
+        neverPasses = true;
+        break;
+    }
+
+    if (step.InGroup) {
+      // Make sure the group exists even if every condition is dropped
+      auto& group = optionGroups[condition->GetOptionGroupID()];
+      if (!neverPasses) {
+        group.push_back(std::make_pair(cost, step));
+      }
+    } else if (neverPasses) {
+      mNeverPasses = true;
+    } else {
+      singular.push_back(std::make_pair(cost, step));
+    }
+  }
+
+  auto byCost = [](const std::pair<uint8_t, Step>& a,
+                   const std::pair<uint8_t, Step>& b) {
+    return a.first < b.first;
+  };
+
+  // Sorting is stable so equal cost conditions keep their order
+  singular.sort(byCost);
+  for (auto& pair : singular) {
+    mSteps.push_back(pair.second);
+  }
+
+  for (auto& gPair : optionGroups) {
+    auto& group = gPair.second;
+    if (group.empty()) {
+      mNeverPasses = true;
+      continue;
+    }
+
+    group.sort(byCost);
+
+    uint16_t remaining = (uint16_t)group.size();
+    for (auto& pair : group) {
+      pair.second.GroupRemaining = --remaining;
+      mSteps.push_back(pair.second);
+    }
+  }
+
+  if (mNeverPasses) {
+    mSteps.clear();
+  }
+}
+
+bool TokuseiConditionProgram::IsCompiledFrom(
+    const std::shared_ptr<objects::Tokusei>& tokusei) const {
+  return mSource == tokusei;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file server/channel/src/TokuseiConditionProgram.h
+ * @ingroup channel
+ *
+ * @author HACKfrost
+ *
+ * @brief Tokusei conditions compiled into a flat list of steps.
+ *
+ * This file is part of the Channel Server (channel).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SERVER_CHANNEL_SRC_TOKUSEICONDITIONPROGRAM_H
+#define SERVER_CHANNEL_SRC_TOKUSEICONDITIONPROGRAM_H
+
+// object Includes
+#include <Tokusei.h>
+#include <TokuseiCondition.h>
+
+// Standard C++11 Includes
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace channel {
+
+/**
+ * Tokusei conditions compiled once at load time into a flat list of
+ * steps. Singular conditions come first, cheapest to evaluate first,
+ * followed by each option group stored contiguously so the whole set is
+ * evaluated in a single pass without tracking the groups in a map. The
+ * conditions themselves are still evaluated by the caller.
+ */
+class TokuseiConditionProgram {
+ public:
+  /**
+   * Compile the conditions of a tokusei.
+   * @param tokusei Pointer to the tokusei definition
+   */
+  explicit TokuseiConditionProgram(
+      const std::shared_ptr<objects::Tokusei>& tokusei);
+
+  /**
+   * Check if the program was compiled from a tokusei definition.
+   * @param tokusei Pointer to the tokusei definition
+   * @return true if the program was compiled from the definition
+   */
+  bool IsCompiledFrom(const std::shared_ptr<objects::Tokusei>& tokusei) const;
+
+  /**
+   * Evaluate the program.
+   * @param isCharacter true if the entity being evaluated is a character
+   * @param evaluate Function returning if a single condition passes
+   * @return true if the condition set evaluates to true
+   */
+  template <typename T>
+  bool Evaluate(bool isCharacter, T evaluate) const {
+    if (mNeverPasses) {
+      return false;
+    }
+
+    size_t idx = 0;
+    while (idx < mSteps.size()) {
+      auto& step = mSteps[idx];
+
+      bool result =
+          (!step.CharacterOnly || isCharacter) && evaluate(step.Condition);
+      if (result) {
+        // Skip the rest of the option group (if any)
+        idx += (size_t)step.GroupRemaining + 1;
+      } else if (!step.InGroup || step.GroupRemaining == 0) {
+        // Singular condition or last option in the group failed
+        return false;
+      } else {
+        idx++;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Evaluate the conditions of a tokusei without compiling them.
+   * @param tokusei Pointer to the tokusei definition
+   * @param evaluate Function returning if a single condition passes
+   * @return true if the condition set evaluates to true
+   */
+  template <typename T>
+  static bool EvaluateInterpreted(
+      const std::shared_ptr<objects::Tokusei>& tokusei, T evaluate) {
+    // Compare singular (and) and option group (or) conditions and
+    // only return true if the entire clause evaluates to true
+    std::unordered_map<uint8_t, bool> optionGroups;
+    for (auto condition : tokusei->GetConditions()) {
+      bool result = false;
+
+      // If the option group has already had a condition pass, skip it
+      uint8_t optionGroupID = condition->GetOptionGroupID();
+      if (optionGroupID != 0) {
+        if (optionGroups.find(optionGroupID) == optionGroups.end()) {
+          optionGroups[optionGroupID] = false;
+        } else {
+          result = optionGroups[optionGroupID];
+        }
+      }
+
+      if (!result) {
+        result = evaluate(condition);
+        if (optionGroupID != 0) {
+          optionGroups[optionGroupID] |= result;
+        } else if (!result) {
+          return false;
+        }
+      }
+    }
+
+    for (auto pair : optionGroups) {
+      if (!pair.second) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+ private:
+  /// Single compiled condition
+  struct Step {
+    /// Condition to evaluate
+    std::shared_ptr<objects::TokuseiCondition> Condition;
+
+    /// Number of steps left in the option group after this one which
+    /// are skipped when this step passes
+    uint16_t GroupRemaining;
+
+    /// true if the step belongs to an option group
+    bool InGroup;
+
+    /// true if the condition can only pass for a character
+    bool CharacterOnly;
+  };
+
+  /// Tokusei the program was compiled from, held so the definition
+  /// cannot be replaced by another one at the same address
+  std::shared_ptr<objects::Tokusei> mSource;
+
+  /// true if the conditions can never pass
+  bool mNeverPasses;
+
+  /// Conditions to evaluate in order
+  std::vector<Step> mSteps;
+};
+
+}  // namespace channel
+
+#endif  // SERVER_CHANNEL_SRC_TOKUSEICONDITIONPROGRAM_H
@@ -34,6 +34,7 @@
 
 // object Includes
 #include <CalculatedEntityState.h>
+#include <ChannelConfig.h>
 #include <Clan.h>
 #include <ClientCostAdjustment.h>
 #include <DigitalizeState.h>
@@ -63,7 +64,9 @@
 #include <WorldSharedConfig.h>
 
 // C++ Standard Includes
+#include <algorithm>
 #include <cmath>
+#include <map>
 
 // channel Includes
 #include "ChannelClientConnection.h"
@@ -311,6 +314,11 @@ bool TokuseiManager::Initialize() {
     if (!GatherTimedTokusei(tPair.second)) {
       return false;
     }
+
+    if (tPair.second->ConditionsCount() > 0) {
+      mConditionPrograms.emplace(tPair.first,
+                                 TokuseiConditionProgram(tPair.second));
+    }
   }
 
   // Verify conditional enchantment tokusei which are restricted from
@@ -517,11 +525,115 @@ bool TokuseiManager::GatherTimedTokusei(
 
     // Add to the set containing all timed tokusei
     mTimedTokusei[tokusei->GetID()] = false;
+
+    BuildTimedTokuseiSchedule(tokusei);
+  }
+
+  return true;
+}
+
+void TokuseiManager::BuildTimedTokuseiSchedule(
+    const std::shared_ptr<objects::Tokusei>& tokusei) {
+  auto conditions = tokusei->GetConditions();
+
+  TimedTokuseiSchedule schedule;
+  schedule.ActiveAtStart = EvaluateTimedConditions(conditions, 0, 0);
+
+  // The result only depends on the moon phase and game minute so walk
+  // every combination once and record where it changes
+  bool active = schedule.ActiveAtStart;
+  for (int32_t phase = 0; phase < 16; phase++) {
+    for (int32_t minute = 0; minute < 1440; minute++) {
+      int32_t gameTime = (minute / 60) * 100 + (minute % 60);
+      bool nowActive = EvaluateTimedConditions(conditions, phase, gameTime);
+      if (nowActive != active) {
+        schedule.Toggles.push_back((uint16_t)(phase * 1440 + minute));
+        active = nowActive;
+      }
+    }
+  }
+
+  mTimedTokuseiSchedules[tokusei->GetID()] = schedule;
+}
+
+bool TokuseiManager::EvaluateTimedConditions(
+    const std::list<std::shared_ptr<objects::TokuseiCondition>>& conditions,
+    int32_t moonPhase, int32_t gameTime) const {
+  // Compare singular (and) and option group (or) conditions and
+  // only return true if the entire clause evaluates to true
+  std::unordered_map<uint8_t, bool> optionGroups;
+  for (auto& condition : conditions) {
+    bool result = false;
+
+    // If the option group has already had a condition pass, skip it
+    uint8_t optionGroupID = condition->GetOptionGroupID();
+    if (optionGroupID != 0) {
+      if (optionGroups.find(optionGroupID) == optionGroups.end()) {
+        optionGroups[optionGroupID] = false;
+      } else {
+        result = optionGroups[optionGroupID];
+      }
+    }
+
+    if (!result) {
+      switch (condition->GetType()) {
+        case TokuseiConditionType::GAME_TIME:
+          // The current game time matches the specified time and
+          // comparison
+          result = Compare(gameTime, condition, true);
+          break;
+        case TokuseiConditionType::MOON_PHASE:
+          // The current moon phase matches the specified phase
+          // and comparison
+          result = Compare(moonPhase, condition, true);
+          break;
+        default:
+          break;
+      }
+
+      if (optionGroupID != 0) {
+        optionGroups[optionGroupID] |= result;
+      } else if (!result) {
+        // Non-option group failed, end here
+        return false;
+      }
+    }
+  }
+
+  for (auto pair : optionGroups) {
+    if (!pair.second) {
+      return false;
+    }
   }
 
   return true;
 }
 
+void TokuseiManager::SetTimedTokuseiEntity(
+    int32_t worldCID, const std::set<int32_t>& tokuseiIDs) {
+  auto it = mTimedTokuseiEntities.find(worldCID);
+  if (it != mTimedTokuseiEntities.end()) {
+    for (int32_t tokuseiID : it->second) {
+      auto hIter = mTimedTokuseiHolders.find(tokuseiID);
+      if (hIter != mTimedTokuseiHolders.end()) {
+        hIter->second.erase(worldCID);
+        if (hIter->second.size() == 0) {
+          mTimedTokuseiHolders.erase(hIter);
+        }
+      }
+    }
+  }
+
+  if (tokuseiIDs.size() > 0) {
+    mTimedTokuseiEntities[worldCID] = tokuseiIDs;
+    for (int32_t tokuseiID : tokuseiIDs) {
+      mTimedTokuseiHolders[tokuseiID].insert(worldCID);
+    }
+  } else {
+    mTimedTokuseiEntities.erase(worldCID);
+  }
+}
+
 std::unordered_map<int32_t, bool> TokuseiManager::Recalculate(
     const std::shared_ptr<ActiveEntityState>& eState,
     std::set<TokuseiConditionType> changes) {
@@ -555,7 +667,14 @@ std::unordered_map<int32_t, bool> TokuseiManager::Recalculate(
   }
 
   if (doRecalc) {
-    return Recalculate(eState, true);
+    // The changed entity is always evaluated again but any related
+    // entity only needs to be if it depends on one of the changes.
+    // Condition changes happen often and nothing reads the stats right
+    // away so they are recalculated once at the end of the tick.
+    eState->SetTokuseiSourceEffects(nullptr);
+
+    return RecalculateEntities(GetAllTokuseiEntities(eState), true, {},
+                               &changes, true);
   }
 
   return std::unordered_map<int32_t, bool>();
@@ -563,15 +682,25 @@ std::unordered_map<int32_t, bool> TokuseiManager::Recalculate(
 
 std::unordered_map<int32_t, bool> TokuseiManager::Recalculate(
     const std::shared_ptr<ActiveEntityState>& eState, bool recalcStats,
-    std::set<int32_t> ignoreStatRecalc) {
+    std::set<int32_t> ignoreStatRecalc, bool queueStatRecalc) {
   std::list<std::shared_ptr<ActiveEntityState>> entities =
       GetAllTokuseiEntities(eState);
-  return Recalculate(entities, recalcStats, ignoreStatRecalc);
+  return Recalculate(entities, recalcStats, ignoreStatRecalc,
+                     queueStatRecalc);
 }
 
 std::unordered_map<int32_t, bool> TokuseiManager::Recalculate(
     const std::list<std::shared_ptr<ActiveEntityState>>& entities,
-    bool recalcStats, std::set<int32_t> ignoreStatRecalc) {
+    bool recalcStats, std::set<int32_t> ignoreStatRecalc,
+    bool queueStatRecalc) {
+  return RecalculateEntities(entities, recalcStats, ignoreStatRecalc,
+                             nullptr, queueStatRecalc);
+}
+
+std::unordered_map<int32_t, bool> TokuseiManager::RecalculateEntities(
+    const std::list<std::shared_ptr<ActiveEntityState>>& entities,
+    bool recalcStats, const std::set<int32_t>& ignoreStatRecalc,
+    const std::set<TokuseiConditionType>* changes, bool queueStatRecalc) {
   std::unordered_map<int32_t, bool> result;
 
   // Effects directly on the entity
@@ -595,99 +724,82 @@ std::unordered_map<int32_t, bool> TokuseiManager::Recalculate(
   // Keep track of aspects encountered to avoid having to loop multiple times
   std::unordered_map<int32_t, std::set<int8_t>> aspectMap;
 
+  auto addEffects =
+      [](std::unordered_map<bool, std::unordered_map<int32_t, uint16_t>>& map,
+         const std::unordered_map<bool, std::unordered_map<int32_t, uint16_t>>&
+             effects) {
+        for (auto& pair : effects) {
+          for (auto& bPair : pair.second) {
+            map[pair.first][bPair.first] =
+                (uint16_t)(map[pair.first][bPair.first] + bPair.second);
+          }
+        }
+      };
+
   for (auto eState : entities) {
     result[eState->GetEntityID()] = false;
 
-    int32_t worldCID = 0;
-    auto state =
-        ClientState::GetEntityClientState(eState->GetEntityID(), false);
-    if (state) {
-      worldCID = state->GetWorldCID();
-
-      // Make sure there's always an entry per player
-      playerEntityTimedTokusei[worldCID];
-    }
-
-    std::set<int8_t> triggers;
-
-    std::unordered_map<int32_t, bool> evaluated;
-    for (auto tokusei : GetDirectTokusei(eState)) {
-      int32_t tokuseiID = tokusei->GetID();
-
-      bool add = false;
-      if (evaluated.find(tokuseiID) != evaluated.end()) {
-        add = evaluated[tokuseiID];
-      } else {
-        add = EvaluateTokuseiConditions(eState, tokusei);
-        evaluated[tokuseiID] = add;
-
-        if (worldCID && mTimedTokusei.find(tokuseiID) != mTimedTokusei.end()) {
-          playerEntityTimedTokusei[worldCID].insert(tokuseiID);
-        }
+    // Re-evaluate the entity only if it has not been evaluated yet or it
+    // depends on one of the changes
+    std::shared_ptr<const TokuseiSourceEffects> source;
+    if (changes) {
+      source = eState->GetTokuseiSourceEffects();
+      if (source && source->DependsOn(*changes)) {
+        source = nullptr;
+      }
 
-        for (auto aspect : tokusei->GetAspects()) {
-          aspectMap[tokuseiID].insert((int8_t)aspect->GetType());
-        }
+#ifdef TOKUSEI_CONSISTENCY_CHECK
+      if (source) {
+        auto expected = CalculateSourceEffects(eState);
+        if (!(*expected == *source)) {
+          LogTokuseiManagerError([&]() {
+            return libcomp::String(
+                       "Tokusei effects kept for entity %1 do not match a "
+                       "full recalculation.\n")
+                .Arg(eState->GetEntityID());
+          });
 
-        for (auto condition : tokusei->GetConditions()) {
-          triggers.insert((int8_t)condition->GetType());
+          source = expected;
+          eState->SetTokuseiSourceEffects(source);
         }
       }
+#endif  // TOKUSEI_CONSISTENCY_CHECK
+    }
 
-      if (add) {
-        bool skillTokusei = tokusei->SkillConditionsCount() > 0 ||
-                            tokusei->SkillTargetConditionsCount() > 0;
+    if (!source) {
+      source = CalculateSourceEffects(eState);
+      eState->SetTokuseiSourceEffects(source);
+    }
 
-        std::unordered_map<int32_t, uint16_t>* map = 0;
-        switch (tokusei->GetTargetType()) {
-          case objects::Tokusei::TargetType_t::PARTY:
-            map = &partyEffects[eState->GetEntityID()][skillTokusei];
-            break;
-          case objects::Tokusei::TargetType_t::SUMMONER:
-            if (eState->GetEntityType() == EntityType_t::PARTNER_DEMON) {
-              map = &otherEffects[eState->GetEntityID()][skillTokusei];
-            } else if (eState->GetEntityType() == EntityType_t::CHARACTER) {
-              // Mostly affects digitalize skills
-              map = &newMaps[eState->GetEntityID()][skillTokusei];
-            }
-            break;
-          case objects::Tokusei::TargetType_t::PARTNER:
-            if (eState->GetEntityType() == EntityType_t::CHARACTER) {
-              map = &otherEffects[eState->GetEntityID()][skillTokusei];
-            } else if (eState->GetEntityType() == EntityType_t::PARTNER_DEMON) {
-              // May never happen on actual skills but keep it
-              // consistent with digitalize behavior
-              map = &newMaps[eState->GetEntityID()][skillTokusei];
-            }
-            break;
-          case objects::Tokusei::TargetType_t::SELF:
-          default:
-            map = &newMaps[eState->GetEntityID()][skillTokusei];
-            break;
-        }
+    auto state =
+        ClientState::GetEntityClientState(eState->GetEntityID(), false);
+    if (state) {
+      int32_t worldCID = state->GetWorldCID();
 
-        if (map) {
-          if (map->find(tokuseiID) == map->end()) {
-            (*map)[tokuseiID] = 1;
-          } else {
-            (*map)[tokuseiID]++;
-          }
-        }
+      // Make sure there's always an entry per player
+      auto& timed = playerEntityTimedTokusei[worldCID];
+      if (worldCID) {
+        timed.insert(source->TimedTokusei.begin(),
+                     source->TimedTokusei.end());
       }
     }
 
-    eState->GetCalculatedState()->SetActiveTokuseiTriggers(triggers);
+    for (auto& aPair : source->Aspects) {
+      aspectMap[aPair.first].insert(aPair.second.begin(), aPair.second.end());
+    }
+
+    addEffects(newMaps[eState->GetEntityID()], source->Self);
+    addEffects(partyEffects[eState->GetEntityID()], source->Party);
+    addEffects(otherEffects[eState->GetEntityID()], source->Other);
+
+    eState->GetCalculatedState()->SetActiveTokuseiTriggers(source->Triggers);
   }
 
   // Set or clear all timed tokusei for player entities
   if (playerEntityTimedTokusei.size() > 0) {
     std::lock_guard<std::mutex> lock(mTimeLock);
     for (auto& ePair : playerEntityTimedTokusei) {
-      if (ePair.second.size() > 0) {
-        mTimedTokuseiEntities[ePair.first] = ePair.second;
-      } else {
-        mTimedTokuseiEntities.erase(ePair.first);
-      }
+      SetTimedTokuseiEntity(ePair.first, ePair.second);
     }
   }
 
@@ -866,7 +978,11 @@ std::unordered_map<int32_t, bool> TokuseiManager::Recalculate(
       }
 
       if (recalcStats && !ignoreStats) {
-        server->GetCharacterManager()->RecalculateStats(eState, client);
+        if (queueStatRecalc) {
+          server->GetCharacterManager()->QueueRecalculateStats(eState);
+        } else {
+          server->GetCharacterManager()->RecalculateStats(eState, client);
+        }
 
         result[eState->GetEntityID()] = true;
       }
@@ -876,6 +992,74 @@ std::unordered_map<int32_t, bool> TokuseiManager::Recalculate(
   return result;
 }
 
+std::shared_ptr<const TokuseiSourceEffects>
+TokuseiManager::CalculateSourceEffects(
+    const std::shared_ptr<ActiveEntityState>& eState) {
+  auto source = std::make_shared<TokuseiSourceEffects>();
+
+  std::unordered_map<int32_t, bool> evaluated;
+  for (auto tokusei : GetDirectTokusei(eState)) {
+    int32_t tokuseiID = tokusei->GetID();
+
+    bool add = false;
+    if (evaluated.find(tokuseiID) != evaluated.end()) {
+      add = evaluated[tokuseiID];
+    } else {
+      add = EvaluateTokuseiConditions(eState, tokusei);
+      evaluated[tokuseiID] = add;
+
+      if (mTimedTokusei.find(tokuseiID) != mTimedTokusei.end()) {
+        source->TimedTokusei.insert(tokuseiID);
+      }
+
+      for (auto aspect : tokusei->GetAspects()) {
+        source->Aspects[tokuseiID].insert((int8_t)aspect->GetType());
+      }
+
+      source->AddTriggers(tokusei->GetConditions());
+    }
+
+    if (add) {
+      bool skillTokusei = tokusei->SkillConditionsCount() > 0 ||
+                          tokusei->SkillTargetConditionsCount() > 0;
+
+      std::unordered_map<int32_t, uint16_t>* map = 0;
+      switch (tokusei->GetTargetType()) {
+        case objects::Tokusei::TargetType_t::PARTY:
+          map = &source->Party[skillTokusei];
+          break;
+        case objects::Tokusei::TargetType_t::SUMMONER:
+          if (eState->GetEntityType() == EntityType_t::PARTNER_DEMON) {
+            map = &source->Other[skillTokusei];
+          } else if (eState->GetEntityType() == EntityType_t::CHARACTER) {
+            // Mostly affects digitalize skills
+            map = &source->Self[skillTokusei];
+          }
+          break;
+        case objects::Tokusei::TargetType_t::PARTNER:
+          if (eState->GetEntityType() == EntityType_t::CHARACTER) {
+            map = &source->Other[skillTokusei];
+          } else if (eState->GetEntityType() == EntityType_t::PARTNER_DEMON) {
+            // May never happen on actual skills but keep it
+            // consistent with digitalize behavior
+            map = &source->Self[skillTokusei];
+          }
+          break;
+        case objects::Tokusei::TargetType_t::SELF:
+        default:
+          map = &source->Self[skillTokusei];
+          break;
+      }
+
+      if (map) {
+        (*map)[tokuseiID]++;
+      }
+    }
+  }
+
+  return source;
+}
+
 std::unordered_map<int32_t, bool> TokuseiManager::RecalculateParty(
     const std::shared_ptr<objects::Party>& party) {
   std::unordered_map<int32_t, bool> result;
@@ -1112,7 +1296,7 @@ std::list<std::shared_ptr<objects::Tokusei>> TokuseiManager::GetDirectTokusei(
 
   // Gather the remaining tokusei from the skills on the entity
   for (uint32_t skillID : skillIDs) {
-    auto skillData = definitionManager->GetSkillData(skillID);
+    auto skillData = definitionManager->GetSkillDataPtr(skillID);
     if (skillData) {
       uint8_t category =
           skillData->GetCommon()->GetCategory()->GetMainCategory();
@@ -1184,39 +1368,20 @@ bool TokuseiManager::EvaluateTokuseiConditions(
 
   int32_t tokuseiID = tokusei->GetID();
 
-  // Compare singular (and) and option group (or) conditions and
-  // only return true if the entire clause evaluates to true
-  std::unordered_map<uint8_t, bool> optionGroups;
-  for (auto condition : tokusei->GetConditions()) {
-    bool result = false;
-
-    // If the option group has already had a condition pass, skip it
-    uint8_t optionGroupID = condition->GetOptionGroupID();
-    if (optionGroupID != 0) {
-      if (optionGroups.find(optionGroupID) == optionGroups.end()) {
-        optionGroups[optionGroupID] = false;
-      } else {
-        result = optionGroups[optionGroupID];
-      }
-    }
-
-    if (!result) {
-      result = EvaluateTokuseiCondition(eState, tokuseiID, condition);
-      if (optionGroupID != 0) {
-        optionGroups[optionGroupID] |= result;
-      } else if (!result) {
-        return false;
-      }
-    }
-  }
-
-  for (auto pair : optionGroups) {
-    if (!pair.second) {
-      return false;
-    }
+  auto evaluate =
+      [this, &eState,
+       tokuseiID](const std::shared_ptr<objects::TokuseiCondition>& condition) {
+        return EvaluateTokuseiCondition(eState, tokuseiID, condition);
+      };
+
+  auto programIter = mConditionPrograms.find(tokuseiID);
+  if (programIter != mConditionPrograms.end() &&
+      programIter->second.IsCompiledFrom(tokusei)) {
+    return programIter->second.Evaluate(
+        eState->GetEntityType() == EntityType_t::CHARACTER, evaluate);
   }
 
-  return true;
+  return TokuseiConditionProgram::EvaluateInterpreted(tokusei, evaluate);
 }
 
 bool TokuseiManager::EvaluateTokuseiCondition(
@@ -1836,78 +2001,45 @@ bool TokuseiManager::AspectValueExists(
 }
 
 void TokuseiManager::RecalcTimedTokusei(WorldClock& clock) {
+  // Look up the schedule at the current clock index if the clock is valid
+  bool useSchedule = clock.MoonPhase >= 0 && clock.MoonPhase < 16 &&
+                     clock.Hour >= 0 && clock.Hour < 24 && clock.Min >= 0 &&
+                     clock.Min < 60;
+  uint16_t clockIdx = 0;
+  if (useSchedule) {
+    clockIdx = (uint16_t)(clock.MoonPhase * 1440 + clock.Hour * 60 +
+                          clock.Min);
+  }
+
   std::set<int32_t> updateCIDs;
   {
-    std::set<int32_t> toggled;
-
     auto definitionManager = mServer.lock()->GetDefinitionManager();
     std::lock_guard<std::mutex> lock(mTimeLock);
     for (auto& tPair : mTimedTokusei) {
-      bool setActive = true;
-      bool isActive = tPair.second;
-
-      // Compare singular (and) and option group (or) conditions and
-      // only return true if the entire clause evaluates to true
-      std::unordered_map<uint8_t, bool> optionGroups;
-
-      auto tokusei = definitionManager->GetTokuseiData(tPair.first);
-      for (auto condition : tokusei->GetConditions()) {
-        bool result = false;
-
-        // If the option group has already had a condition pass, skip it
-        uint8_t optionGroupID = condition->GetOptionGroupID();
-        if (optionGroupID != 0) {
-          if (optionGroups.find(optionGroupID) == optionGroups.end()) {
-            optionGroups[optionGroupID] = false;
-          } else {
-            result = optionGroups[optionGroupID];
-          }
-        }
-
-        if (!result) {
-          switch (condition->GetType()) {
-            case TokuseiConditionType::GAME_TIME:
-              // The current game time matches the specified time and
-              // comparison
-              {
-                result =
-                    Compare((int32_t)(clock.Hour * 100 + (int32_t)clock.Min),
-                            condition, true);
-              }
-              break;
-            case TokuseiConditionType::MOON_PHASE:
-              // The current moon phase matches the specified phase
-              // and comparison
-              { result = Compare((int32_t)clock.MoonPhase, condition, true); }
-              break;
-            default:
-              break;
-          }
-
-          if (optionGroupID != 0) {
-            optionGroups[optionGroupID] |= result;
-          } else if (!result) {
-            // Non-option group failed, end here
-            setActive = false;
-            break;
-          }
-        }
-      }
-
-      for (auto pair : optionGroups) {
-        setActive &= pair.second;
+      bool setActive = false;
+
+      auto sIter = mTimedTokuseiSchedules.find(tPair.first);
+      if (useSchedule && sIter != mTimedTokuseiSchedules.end()) {
+        // Active if an odd number of toggles have passed
+        auto& toggles = sIter->second.Toggles;
+        size_t passed = (size_t)(
+            std::upper_bound(toggles.begin(), toggles.end(), clockIdx) -
+            toggles.begin());
+        setActive = sIter->second.ActiveAtStart != (passed % 2 == 1);
+      } else {
+        auto tokusei = definitionManager->GetTokuseiData(tPair.first);
+        setActive = EvaluateTimedConditions(
+            tokusei->GetConditions(), (int32_t)clock.MoonPhase,
+            (int32_t)(clock.Hour * 100 + (int32_t)clock.Min));
       }
 
-      if (isActive != setActive) {
+      if (tPair.second != setActive) {
         tPair.second = setActive;
-        toggled.insert(tPair.first);
-      }
-    }
 
-    for (int32_t tokuseiID : toggled) {
-      for (auto& pair : mTimedTokuseiEntities) {
-        if (pair.second.find(tokuseiID) != pair.second.end()) {
-          updateCIDs.insert(pair.first);
+        // Only characters holding the tokusei need to be updated
+        auto hIter = mTimedTokuseiHolders.find(tPair.first);
+        if (hIter != mTimedTokuseiHolders.end()) {
+          updateCIDs.insert(hIter->second.begin(), hIter->second.end());
         }
       }
     }
@@ -1924,7 +2056,7 @@ void TokuseiManager::RecalcTimedTokusei(WorldClock& clock) {
 
 void TokuseiManager::RemoveTrackingEntities(int32_t worldCID) {
   std::lock_guard<std::mutex> lock(mTimeLock);
-  mTimedTokuseiEntities.erase(worldCID);
+  SetTimedTokuseiEntity(worldCID, {});
 }
 
 void TokuseiManager::UpdateMovementDecay(
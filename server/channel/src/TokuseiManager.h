@@ -35,6 +35,8 @@
 
 // channel Includes
 #include "ActiveEntityState.h"
+#include "TokuseiConditionProgram.h"
+#include "TokuseiSourceEffects.h"
 
 namespace objects {
 class ClientCostAdjustment;
@@ -44,7 +46,6 @@ class TokuseiAttributes;
 }  // namespace objects
 
 typedef objects::TokuseiAspect::Type_t TokuseiAspectType;
-typedef objects::TokuseiCondition::Type_t TokuseiConditionType;
 typedef objects::TokuseiSkillCondition ::SkillConditionType_t
     TokuseiSkillConditionType;
 
@@ -99,12 +100,15 @@ class TokuseiManager {
    * occur
    * @param ignoreStateRecalc Set of entity IDs to ignore when recalculating
    * stats
+   * @param queueStatRecalc true if the stats should be queued to recalculate
+   * at the end of the tick instead of right away
    * @return Map of entity IDs to a true value if they have had their stats
    * recalculated or false if only their tokusei sets and triggers were updated
    */
   std::unordered_map<int32_t, bool> Recalculate(
       const std::shared_ptr<ActiveEntityState>& eState,
-      bool recalcStats = false, std::set<int32_t> ignoreStatRecalc = {});
+      bool recalcStats = false, std::set<int32_t> ignoreStatRecalc = {},
+      bool queueStatRecalc = false);
 
   /**
    * Recalculate the tokusei effects on the supplied entities.
@@ -114,12 +118,15 @@ class TokuseiManager {
    * occur
    * @param ignoreStateRecalc Set of entity IDs to ignore when recalculating
    * stats
+   * @param queueStatRecalc true if the stats should be queued to recalculate
+   * at the end of the tick instead of right away
    * @return Map of entity IDs to a true value if they have had their stats
    * recalculated or false if only their tokusei sets and triggers were updated
    */
   std::unordered_map<int32_t, bool> Recalculate(
       const std::list<std::shared_ptr<ActiveEntityState>>& entities,
-      bool recalcStats = false, std::set<int32_t> ignoreStatRecalc = {});
+      bool recalcStats = false, std::set<int32_t> ignoreStatRecalc = {},
+      bool queueStatRecalc = false);
 
   /**
    * Recalculate the tokusei effects for all entities in a party on the channel.
@@ -298,6 +305,37 @@ class TokuseiManager {
   bool DeadTokuseiDisabled();
 
  private:
+  /**
+   * Recalculate the tokusei effects on the supplied entities.
+   * @param entities List of pointers to the entities to recalculate
+   * @param recalcStats false if the effect tokusei should be determined but
+   *  the entities should not have their stats recalculated, true if both
+   *  should occur
+   * @param ignoreStateRecalc Set of entity IDs to ignore when recalculating
+   *  stats
+   * @param changes Optional set of changes that triggered the
+   *  recalculation. If supplied only the entities with one of the changes
+   *  as a trigger are re-evaluated and the rest keep their last effects.
+   *  If null every entity is re-evaluated.
+   * @param queueStatRecalc true if the stats should be queued to recalculate
+   *  at the end of the tick instead of right away
+   * @return Map of entity IDs to a true value if they have had their stats
+   *  recalculated or false if only their tokusei sets and triggers were
+   *  updated
+   */
+  std::unordered_map<int32_t, bool> RecalculateEntities(
+      const std::list<std::shared_ptr<ActiveEntityState>>& entities,
+      bool recalcStats, const std::set<int32_t>& ignoreStatRecalc,
+      const std::set<TokuseiConditionType>* changes, bool queueStatRecalc);
+
+  /**
+   * Evaluate all tokusei originating from the supplied entity.
+   * @param eState Pointer to the tokusei source
+   * @return Pointer to the effects originating from the entity
+   */
+  std::shared_ptr<const TokuseiSourceEffects> CalculateSourceEffects(
+      const std::shared_ptr<ActiveEntityState>& eState);
+
   /**
    * Recalculate skill cost adjustments from tokusei for the specified
    * entity. If the entity's data has already been sent to the client,
@@ -327,6 +365,36 @@ class TokuseiManager {
    */
   bool GatherTimedTokusei(const std::shared_ptr<objects::Tokusei>& tokusei);
 
+  /**
+   * Build the activation schedule of a time restricted tokusei by
+   * evaluating its conditions at every game minute of every moon phase.
+   * @param tokusei Pointer to the tokusei definition
+   */
+  void BuildTimedTokuseiSchedule(
+      const std::shared_ptr<objects::Tokusei>& tokusei);
+
+  /**
+   * Evaluate the time conditions of a time restricted tokusei. Any other
+   * condition type that is not part of an option group fails the tokusei.
+   * @param conditions Conditions of the tokusei
+   * @param moonPhase Moon phase to evaluate at
+   * @param gameTime Game time to evaluate at as hours * 100 + minutes
+   * @return true if the tokusei is active at the supplied time
+   */
+  bool EvaluateTimedConditions(
+      const std::list<std::shared_ptr<objects::TokuseiCondition>>& conditions,
+      int32_t moonPhase, int32_t gameTime) const;
+
+  /**
+   * Set the time restricted tokusei directly on a character or its
+   * partner demon, keeping the tokusei to world CID index in sync.
+   * Must be called with the time lock held.
+   * @param worldCID World CID associated to the character
+   * @param tokuseiIDs Set of time restricted tokusei IDs, empty to clear
+   */
+  void SetTimedTokuseiEntity(int32_t worldCID,
+                             const std::set<int32_t>& tokuseiIDs);
+
   /**
    * Convert a tokusei condition to a world clock time representation. Calling
    * this function for multiple conditions will combine the times into a complex
@@ -380,12 +448,34 @@ class TokuseiManager {
   /// that the effect is ultimately marked as effective.
   std::unordered_map<int32_t, std::set<int32_t>> mTimedTokuseiEntities;
 
+  /// Map of time restricted tokusei IDs to the world CIDs of the characters
+  /// holding them. This is the reverse of mTimedTokuseiEntities.
+  std::unordered_map<int32_t, std::set<int32_t>> mTimedTokuseiHolders;
+
+  /// Activation schedule of a time restricted tokusei
+  struct TimedTokuseiSchedule {
+    /// true if the tokusei is active at the new moon at 00:00
+    bool ActiveAtStart;
+
+    /// Sorted clock indexes (moon phase * 1440 + game minute of the day)
+    /// where the tokusei switches between active and inactive
+    std::vector<uint16_t> Toggles;
+  };
+
+  /// Map of time restricted tokusei IDs to their activation schedule.
+  /// Only modified during initialization.
+  std::unordered_map<int32_t, TimedTokuseiSchedule> mTimedTokuseiSchedules;
+
   /// Set of all tokusei with at least one cost adjustment aspect
   std::set<int32_t> mCostAdjustmentTokusei;
 
   /// Set of all tokusei with at least one movement decay aspect
   std::set<int32_t> mMoveDecayTokusei;
 
+  /// Map of tokusei IDs with conditions to their compiled conditions.
+  /// Only modified during initialization.
+  std::unordered_map<int32_t, TokuseiConditionProgram> mConditionPrograms;
+
   /// Server lock for time calculation
   std::mutex mTimeLock;
 
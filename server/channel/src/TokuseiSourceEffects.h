@@ -0,0 +1,113 @@
+/**
+ * @file server/channel/src/TokuseiSourceEffects.h
+ * @ingroup channel
+ *
+ * @author HACKfrost
+ *
+ * @brief Tokusei effects originating from a single entity.
+ *
+ * This file is part of the Channel Server (channel).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SERVER_CHANNEL_SRC_TOKUSEISOURCEEFFECTS_H
+#define SERVER_CHANNEL_SRC_TOKUSEISOURCEEFFECTS_H
+
+// object Includes
+#include <TokuseiCondition.h>
+
+// Standard C++11 Includes
+#include <list>
+#include <memory>
+#include <set>
+#include <unordered_map>
+
+typedef objects::TokuseiCondition::Type_t TokuseiConditionType;
+
+namespace channel {
+
+/**
+ * Tokusei effects originating from a single entity along with the
+ * condition types they were evaluated with. Each entity keeps the last
+ * set calculated for it so a recalculation triggered by specific
+ * condition types only needs to re-evaluate the entities that depend on
+ * one of them. Once built the set is never modified.
+ */
+struct TokuseiSourceEffects {
+  /// Effects on the entity itself by skill tokusei flag then tokusei ID
+  std::unordered_map<bool, std::unordered_map<int32_t, uint16_t>> Self;
+
+  /// Effects on the entity's party by skill tokusei flag then tokusei ID
+  std::unordered_map<bool, std::unordered_map<int32_t, uint16_t>> Party;
+
+  /// Effects on the entity's partner or summoner by skill tokusei flag
+  /// then tokusei ID
+  std::unordered_map<bool, std::unordered_map<int32_t, uint16_t>> Other;
+
+  /// Condition types evaluated, used to invalidate the effects
+  std::set<int8_t> Triggers;
+
+  /// Time restricted tokusei evaluated
+  std::set<int32_t> TimedTokusei;
+
+  /// Aspect types of each tokusei evaluated by tokusei ID
+  std::unordered_map<int32_t, std::set<int8_t>> Aspects;
+
+  /**
+   * Record the condition types of a tokusei being evaluated.
+   * @param conditions Conditions of the tokusei
+   */
+  void AddTriggers(
+      const std::list<std::shared_ptr<objects::TokuseiCondition>>&
+          conditions) {
+    for (auto& condition : conditions) {
+      Triggers.insert((int8_t)condition->GetType());
+    }
+  }
+
+  /**
+   * Check if the effects depend on any of a set of changed condition
+   * types. Effects that do not can be kept instead of being evaluated
+   * again.
+   * @param changes Condition types that changed
+   * @return true if the effects must be evaluated again
+   */
+  bool DependsOn(const std::set<TokuseiConditionType>& changes) const {
+    for (auto change : changes) {
+      if (Triggers.find((int8_t)change) != Triggers.end()) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * Check if another set contains the same effects.
+   * @param other Set of effects to compare to
+   * @return true if both sets contain the same effects
+   */
+  bool operator==(const TokuseiSourceEffects& other) const {
+    return Self == other.Self && Party == other.Party &&
+           Other == other.Other && Triggers == other.Triggers &&
+           TimedTokusei == other.TimedTokusei && Aspects == other.Aspects;
+  }
+};
+
+}  // namespace channel
+
+#endif  // SERVER_CHANNEL_SRC_TOKUSEISOURCEEFFECTS_H
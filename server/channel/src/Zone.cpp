@@ -38,6 +38,7 @@
 #include <AllyState.h>
 #include <CultureMachineState.h>
 #include <DiasporaBase.h>
+#include <Enemy.h>
 #include <EnemyBase.h>
 #include <Loot.h>
 #include <LootBox.h>
@@ -55,6 +56,7 @@
 #include <UBMatch.h>
 
 // channel Includes
+#include "AIState.h"
 #include "ChannelServer.h"
 #include "WorldClock.h"
 #include "ZoneInstance.h"
@@ -192,6 +194,29 @@ const std::shared_ptr<DynamicMap> Zone::GetDynamicMap() const {
 
 bool Zone::HasRespawns() const { return mHasRespawns; }
 
+bool Zone::HasPendingSpawns() {
+  std::lock_guard<std::mutex> lock(mLock);
+  if (mRespawnTimes.size() > 0 || mStaggeredSpawns.size() > 0) {
+    return true;
+  }
+
+  // Groups are never removed once spawned so an empty one has been
+  // defeated and would spawn again right away if the zone was rebuilt
+  for (auto& pair : mSpawnGroups) {
+    if (pair.second.size() == 0) {
+      return true;
+    }
+  }
+
+  for (auto& pair : mSpawnLocationGroups) {
+    if (pair.second.size() == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 bool Zone::HasStaggeredSpawns(uint64_t now) {
   std::lock_guard<std::mutex> lock(mLock);
   return mStaggeredSpawns.size() > 0 && mStaggeredSpawns.begin()->first <= now;
@@ -554,7 +579,15 @@ Zone::GetActiveEntitiesInRadius(float x, float y, double radius,
 
   float rSquared = (float)std::pow(radius, 2);
 
-  for (auto active : GetActiveEntities()) {
+  // Copy the list under the zone lock and refresh positions after releasing
+  // it as refreshing locks each entity
+  std::list<std::shared_ptr<ActiveEntityState>> entities;
+  {
+    std::lock_guard<std::mutex> lock(mLock);
+    entities = mActiveEntities;
+  }
+
+  for (auto& active : entities) {
     active->RefreshCurrentPosition(now);
 
     float sqDist = active->GetDistance(x, y, true);
@@ -574,6 +607,36 @@ Zone::GetActiveEntitiesInRadius(float x, float y, double radius,
   return results;
 }
 
+const std::list<std::shared_ptr<ActiveEntityState>>
+Zone::GetActiveEntitiesInBox(float x1, float y1, float x2, float y2,
+                             bool useHitbox) {
+  std::list<std::shared_ptr<ActiveEntityState>> results;
+
+  uint64_t now = ChannelServer::GetServerTime();
+
+  // Copy the list under the zone lock and refresh positions after releasing
+  // it as refreshing locks each entity
+  std::list<std::shared_ptr<ActiveEntityState>> entities;
+  {
+    std::lock_guard<std::mutex> lock(mLock);
+    entities = mActiveEntities;
+  }
+
+  for (auto& active : entities) {
+    active->RefreshCurrentPosition(now);
+
+    float extend = useHitbox ? (float)active->GetHitboxSize() * 10.f : 0.f;
+    float x = active->GetCurrentX();
+    float y = active->GetCurrentY();
+    if (x + extend >= x1 && x - extend <= x2 && y + extend >= y1 &&
+        y - extend <= y2) {
+      results.push_back(active);
+    }
+  }
+
+  return results;
+}
+
 std::shared_ptr<AllyState> Zone::GetAlly(int32_t id) {
   return std::dynamic_pointer_cast<AllyState>(GetEntity(id));
 }
@@ -1888,3 +1951,13 @@ int32_t Zone::GetEntitiesManagedBy(const libobjgen::UUID& responsibleEntity) {
 
   return 0;
 }
+
+std::shared_ptr<EnemyState> Zone::NewEnemyState() {
+  return mEnemyStatePool.Create();
+}
+
+std::shared_ptr<objects::Enemy> Zone::NewEnemy() {
+  return mEnemyPool.Create();
+}
+
+std::shared_ptr<AIState> Zone::NewAIState() { return mAIStatePool.Create(); }
@@ -28,6 +28,8 @@
 #define SERVER_CHANNEL_SRC_ZONE_H
 
 // libcomp Includes
+#include <MemoryAccounting.h>
+#include <ObjectPool.h>
 #include <ScriptEngine.h>
 
 // channel Includes
@@ -50,6 +52,7 @@ namespace objects {
 class Action;
 class Ally;
 class DiasporaBase;
+class Enemy;
 class Loot;
 class LootBox;
 class PvPBase;
@@ -62,6 +65,7 @@ class UBMatch;
 
 namespace channel {
 
+class AIState;
 class ChannelClientConnection;
 class CultureMachineState;
 class PlasmaState;
@@ -80,7 +84,9 @@ typedef objects::ServerZoneInstanceVariant::InstanceType_t InstanceType_t;
  * Represents a server zone containing client connections, objects,
  * enemies, etc.
  */
-class Zone : public objects::ZoneObject {
+class Zone
+    : public objects::ZoneObject,
+      private libhack::MemoryTracked<libhack::MemoryTag_t::ZONES, Zone> {
  public:
   /**
    * Create a new zone.
@@ -161,6 +167,13 @@ class Zone : public objects::ZoneObject {
    */
   bool HasRespawns() const;
 
+  /**
+   * Check if any spawn in the zone has been defeated or is still waiting
+   * to spawn or respawn. This state is lost if the zone is created again.
+   * @return true if the zone has defeated or pending spawns
+   */
+  bool HasPendingSpawns();
+
   /**
    * Check if the zone has staggered spawns ready
    * @param now System time representing the current server time
@@ -293,6 +306,20 @@ class Zone : public objects::ZoneObject {
   const std::list<std::shared_ptr<ActiveEntityState>> GetActiveEntitiesInRadius(
       float x, float y, double radius, bool useHitbox = false);
 
+  /**
+   * Get all active entities in the zone within a supplied axis aligned box.
+   * Used to narrow down the entities that need a more exact area check.
+   * @param x1 Smallest X coordinate of the box
+   * @param y1 Smallest Y coordinate of the box
+   * @param x2 Largest X coordinate of the box
+   * @param y2 Largest Y coordinate of the box
+   * @param useHitbox If true, the entities' hitboxes will be used to
+   *  determine if they are in the box, even if the center point is not
+   * @return List of pointers to active entities in the box
+   */
+  const std::list<std::shared_ptr<ActiveEntityState>> GetActiveEntitiesInBox(
+      float x1, float y1, float x2, float y2, bool useHitbox = false);
+
   /**
    * Get an entity instance by it's ID.
    * @param id Instance ID of the entity.
@@ -809,6 +836,25 @@ class Zone : public objects::ZoneObject {
    */
   int32_t GetEntitiesManagedBy(const libobjgen::UUID& responsibleEntity);
 
+  /**
+   * Create a new enemy state from the zone's object pool. Enemies are
+   * spawned and despawned constantly so their memory is reused.
+   * @return Pointer to the new enemy state
+   */
+  std::shared_ptr<EnemyState> NewEnemyState();
+
+  /**
+   * Create a new enemy from the zone's object pool.
+   * @return Pointer to the new enemy
+   */
+  std::shared_ptr<objects::Enemy> NewEnemy();
+
+  /**
+   * Create a new AI state from the zone's object pool.
+   * @return Pointer to the new AI state
+   */
+  std::shared_ptr<AIState> NewAIState();
+
  private:
   /**
    * Register an entity as one that currently exists in the zone
@@ -988,6 +1034,15 @@ class Zone : public objects::ZoneObject {
   /// updated since the last call to DiasporaMiniBossUpdated
   bool mDiasporaMiniBossUpdated;
 
+  /// Pool of enemy states spawned in the zone
+  libhack::ObjectPool<EnemyState> mEnemyStatePool;
+
+  /// Pool of enemies spawned in the zone
+  libhack::ObjectPool<objects::Enemy> mEnemyPool;
+
+  /// Pool of AI states for entities in the zone
+  libhack::ObjectPool<AIState> mAIStatePool;
+
   /// Server lock for shared resources
   std::mutex mLock;
 };
@@ -73,6 +73,17 @@ ZoneGeometryLoader::LoadQMP(
   return mZoneGeometry;
 }
 
+std::shared_ptr<ZoneGeometry> ZoneGeometryLoader::LoadZoneGeometry(
+    uint32_t zoneID, const std::set<uint32_t>& dynamicMapIDs,
+    const std::shared_ptr<ChannelServer>& server) {
+  mZonePairs.push_back(std::make_pair(zoneID, dynamicMapIDs));
+
+  // Load on the calling thread since there is only one file
+  LoadZoneQMP(server);
+
+  return mZoneGeometry.size() > 0 ? mZoneGeometry.begin()->second : nullptr;
+}
+
 bool ZoneGeometryLoader::LoadZoneQMP(
     const std::shared_ptr<ChannelServer>& server) {
   mDataLock.lock();
@@ -51,6 +51,18 @@ class ZoneGeometryLoader {
       std::unordered_map<uint32_t, std::set<uint32_t>> localZoneIDs,
       const std::shared_ptr<ChannelServer>& server);
 
+  /**
+   * Load the QMP zone geometry file for a single zone.
+   * @param zoneID ID of the zone to load the geometry for.
+   * @param dynamicMapIDs IDs of the zone's dynamic maps used to filter
+   *  out unreachable navigation points.
+   * @param server Pointer to the channel server.
+   * @returns Loaded zone geometry or null if it failed to load.
+   */
+  std::shared_ptr<ZoneGeometry> LoadZoneGeometry(
+      uint32_t zoneID, const std::set<uint32_t>& dynamicMapIDs,
+      const std::shared_ptr<ChannelServer>& server);
+
  private:
   /**
    * Load a QMP for the next zone in the list.
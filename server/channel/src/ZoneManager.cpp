@@ -44,6 +44,7 @@
 #include <ActionStartEvent.h>
 #include <ActivatedAbility.h>
 #include <Ally.h>
+#include <ChannelConfig.h>
 #include <ChannelLogin.h>
 #include <CharacterLogin.h>
 #include <CharacterProgress.h>
@@ -156,9 +157,12 @@ BaseScriptEngine& BaseScriptEngine::Using<ZoneManager>() {
 }  // namespace libcomp
 
 ZoneManager::ZoneManager(const std::weak_ptr<ChannelServer>& server)
-    : mTrackingRefresh(0),
+    : mInstancePoolHits(0),
+      mInstancePoolMisses(0),
+      mTrackingRefresh(0),
       mNextZoneID(1),
       mNextZoneInstanceID(1),
+      mLazyZones(false),
       mServer(server) {}
 
 ZoneManager::~ZoneManager() {
@@ -172,6 +176,10 @@ void ZoneManager::LoadGeometry() {
   auto sharedConfig = server->GetWorldSharedConfig();
   uint8_t channelID = server->GetChannelID();
 
+  auto conf =
+      std::dynamic_pointer_cast<objects::ChannelConfig>(server->GetConfig());
+  mLazyZones = conf->GetLazyZones();
+
   auto definitionManager = server->GetDefinitionManager();
   auto serverDataManager = server->GetServerDataManager();
 
@@ -200,6 +208,23 @@ void ZoneManager::LoadGeometry() {
     }
   }
 
+  {
+    std::lock_guard<libcomp::Mutex> lock(mLock);
+    mLocalZoneIDs = localZoneIDs;
+  }
+
+  if (mLazyZones) {
+    // Geometry and dynamic maps will be built as zones are created
+    LogZoneManagerInfo([&]() {
+      return libcomp::String(
+                 "Lazy zones enabled. Geometry for %1 zone(s) will be "
+                 "loaded on demand.\n")
+          .Arg(localZoneIDs.size());
+    });
+
+    return;
+  }
+
   // Build zone geometry from QMP files
   ZoneGeometryLoader loader;
   mZoneGeometry = loader.LoadQMP(localZoneIDs, server);
@@ -213,67 +238,10 @@ void ZoneManager::LoadGeometry() {
 
     for (auto dynamicMapID : zonePair.second) {
       auto serverZone = serverDataManager->GetZoneData(zoneID, dynamicMapID);
-      if (zoneData && serverZone) {
-        auto dynamicMap = definitionManager->GetDynamicMapData(dynamicMapID);
-        if (dynamicMap &&
-            mDynamicMaps.find(dynamicMapID) == mDynamicMaps.end()) {
-          auto dMap = std::make_shared<DynamicMap>();
-          auto spots = definitionManager->GetSpotData(dynamicMapID);
-          for (auto spotPair : spots) {
-            Point center(spotPair.second->GetCenterX(),
-                         spotPair.second->GetCenterY());
-            float rot = spotPair.second->GetRotation();
-
-            float x1 = center.x - spotPair.second->GetSpanX();
-            float y1 = center.y - spotPair.second->GetSpanY();
-
-            float x2 = center.x + spotPair.second->GetSpanX();
-            float y2 = center.y + spotPair.second->GetSpanY();
-
-            // Build the unrotated rectangle
-            std::vector<Point> points;
-            points.push_back(Point(x1, y1));
-            points.push_back(Point(x2, y1));
-            points.push_back(Point(x2, y2));
-            points.push_back(Point(x1, y2));
-
-            auto shape = std::make_shared<ZoneSpotShape>();
-
-            // Rotate each point around the center
-            for (auto& p : points) {
-              p = RotatePoint(p, center, rot);
-              shape->Vertices.push_back(p);
-            }
-
-            shape->Definition = spotPair.second;
-            shape->Lines.push_back(Line(points[0], points[1]));
-            shape->Lines.push_back(Line(points[1], points[2]));
-            shape->Lines.push_back(Line(points[2], points[3]));
-            shape->Lines.push_back(Line(points[3], points[0]));
-
-            // Determine the boundaries of the completed shape
-            std::list<float> xVals;
-            std::list<float> yVals;
-
-            for (Line& line : shape->Lines) {
-              for (const Point& p : {line.first, line.second}) {
-                xVals.push_back(p.x);
-                yVals.push_back(p.y);
-              }
-            }
-
-            xVals.sort([](const float& a, const float& b) { return a < b; });
-
-            yVals.sort([](const float& a, const float& b) { return a < b; });
-
-            shape->Boundaries[0] = Point(xVals.front(), yVals.front());
-            shape->Boundaries[1] = Point(xVals.back(), yVals.back());
-
-            dMap->Spots[spotPair.first] = shape;
-            dMap->SpotTypes[(uint8_t)spotPair.second->GetType()].push_back(
-                shape);
-          }
-
+      if (zoneData && serverZone &&
+          mDynamicMaps.find(dynamicMapID) == mDynamicMaps.end()) {
+        auto dMap = BuildDynamicMap(dynamicMapID);
+        if (dMap) {
           mDynamicMaps[dynamicMapID] = dMap;
         }
       }
@@ -314,17 +282,11 @@ void ZoneManager::InstanceGlobalZones() {
     }
   }
 
-  // Build zones from definitions
+  // Build zones from definitions. Lazy zones still need every zone in a
+  // multi-zone boss group up front to report the group status.
   for (auto zoneData : zoneDefs) {
-    uint32_t zoneID = zoneData->GetID();
-    uint32_t dynamicMapID = zoneData->GetDynamicMapID();
-
-    auto zone = CreateZone(zoneData);
-
-    std::lock_guard<libcomp::Mutex> lock(mLock);
-    mGlobalZoneMap[zoneID][dynamicMapID] = zone->GetID();
-    if (zoneData->GetGlobalBossGroup()) {
-      mGlobalBossZones[zoneData->GetGlobalBossGroup()].insert(zone->GetID());
+    if (!mLazyZones || zoneData->GetGlobalBossGroup()) {
+      CreateGlobalZone(zoneData);
     }
   }
 
@@ -349,6 +311,100 @@ void ZoneManager::InstanceGlobalZones() {
   }
 }
 
+bool ZoneManager::ScheduleIdleZoneEviction(uint16_t timeOut) {
+  auto server = mServer.lock();
+
+  // Check at least once a minute so zones are not kept much longer
+  // than the time-out
+  uint16_t interval = timeOut < 60 ? timeOut : 60;
+
+  ServerTime nextTime =
+      server->GetServerTime() + (ServerTime)(interval * 1000000ULL);
+  return server->ScheduleWork(
+      nextTime,
+      [](ChannelServer* svr, uint16_t t) {
+        auto zoneManager = svr->GetZoneManager();
+
+        zoneManager->EvictIdleZones(t);
+        zoneManager->ScheduleIdleZoneEviction(t);
+      },
+      server.get(), timeOut);
+}
+
+void ZoneManager::EvictIdleZones(uint16_t timeOut) {
+  if (!mLazyZones) {
+    return;
+  }
+
+  uint64_t cutoff = ChannelServer::GetServerTime();
+  if (cutoff < (uint64_t)timeOut * 1000000ULL) {
+    return;
+  }
+
+  cutoff -= (uint64_t)timeOut * 1000000ULL;
+
+  std::lock_guard<libcomp::Mutex> gLock(mGlobalZoneLock);
+  std::lock_guard<libcomp::Mutex> lock(mLock);
+
+  size_t zoneCount = 0;
+  for (auto it = mIdleZones.begin(); it != mIdleZones.end();) {
+    auto zoneIter = mZones.find(it->first);
+    if (zoneIter == mZones.end()) {
+      it = mIdleZones.erase(it);
+      continue;
+    }
+
+    auto zone = zoneIter->second;
+    if (it->second > cutoff || !CanEvictZone(zone)) {
+      it++;
+      continue;
+    }
+
+    it = mIdleZones.erase(it);
+
+    auto iter = mGlobalZoneMap.find(zone->GetDefinitionID());
+    if (iter != mGlobalZoneMap.end()) {
+      iter->second.erase(zone->GetDynamicMapID());
+      if (iter->second.size() == 0) {
+        mGlobalZoneMap.erase(iter);
+      }
+    }
+
+    RemoveZone(zone, false);
+    zoneCount++;
+  }
+
+  if (!zoneCount) {
+    return;
+  }
+
+  // Drop any geometry and dynamic maps only referenced here
+  size_t geometryCount = 0;
+  for (auto it = mZoneGeometry.begin(); it != mZoneGeometry.end();) {
+    if (it->second.use_count() == 1) {
+      it = mZoneGeometry.erase(it);
+      geometryCount++;
+    } else {
+      it++;
+    }
+  }
+
+  for (auto it = mDynamicMaps.begin(); it != mDynamicMaps.end();) {
+    if (it->second.use_count() == 1) {
+      it = mDynamicMaps.erase(it);
+    } else {
+      it++;
+    }
+  }
+
+  LogZoneManagerDebug([&]() {
+    return libcomp::String(
+               "Removed %1 idle zone(s) and %2 unused zone geometry file(s).\n")
+        .Arg(zoneCount)
+        .Arg(geometryCount);
+  });
+}
+
 std::shared_ptr<Zone> ZoneManager::GetCurrentZone(
     const std::shared_ptr<ChannelClientConnection>& client) {
   auto worldCID = client->GetClientState()->GetWorldCID();
@@ -377,16 +433,19 @@ std::shared_ptr<Zone> ZoneManager::GetExistingZone(uint32_t zoneID,
     auto instance = GetInstance(instanceID);
     return instance ? instance->GetZone(zoneID, dynamicMapID) : nullptr;
   } else {
-    std::lock_guard<libcomp::Mutex> lock(mLock);
-    auto iter = mGlobalZoneMap.find(zoneID);
-    if (iter != mGlobalZoneMap.end()) {
-      auto subIter = iter->second.find(dynamicMapID);
-      if (subIter != iter->second.end()) {
-        return mZones[subIter->second];
+    {
+      std::lock_guard<libcomp::Mutex> lock(mLock);
+      auto iter = mGlobalZoneMap.find(zoneID);
+      if (iter != mGlobalZoneMap.end()) {
+        auto subIter = iter->second.find(dynamicMapID);
+        if (subIter != iter->second.end()) {
+          return mZones[subIter->second];
+        }
       }
     }
 
-    return nullptr;
+    // Global zones always exist unless they have not been needed yet
+    return GetLazyGlobalZone(zoneID, dynamicMapID);
   }
 }
 
@@ -460,6 +519,7 @@ bool ZoneManager::EnterZone(
     } else {
       if (nextZone->GetDefinition()->GetRestricted() &&
           !CanEnterRestrictedZone(client, nextZone)) {
+        UnpinZone(nextZone);
         return false;
       }
     }
@@ -479,6 +539,10 @@ bool ZoneManager::EnterZone(
           .Arg(state->GetAccountUID().ToString());
     });
 
+    if (nextZone) {
+      UnpinZone(nextZone);
+    }
+
     return false;
   }
 
@@ -587,10 +651,18 @@ bool ZoneManager::EnterZone(
       syncManager->SyncOutgoing();
     }
 
+    // Active zones are never evicted so the pin taken when the zone was
+    // looked up is no longer needed
+    auto pinIter = mPinnedZones.find(uniqueID);
+    if (pinIter != mPinnedZones.end() && --pinIter->second == 0) {
+      mPinnedZones.erase(pinIter);
+    }
+
     // Reactive the zone if its not active already
     bool activateTracking = false;
     if (mActiveZones.find(uniqueID) == mActiveZones.end()) {
       mActiveZones.insert(uniqueID);
+      mIdleZones.erase(uniqueID);
       firstConnection = true;
 
       if (nextZone->GetInstanceType() == InstanceType_t::DIASPORA ||
@@ -905,6 +977,12 @@ void ZoneManager::LeaveZone(
     }
   }
 
+  // Write out any deferred record updates when changing zones (logging
+  // out saves them along with everything else)
+  if (!logOut) {
+    server->GetAccountManager()->FlushDeferredUpdates(state);
+  }
+
   // Lock entity interactions in the zone
   state->SetZoneInTime(0);
 
@@ -1083,6 +1161,11 @@ void ZoneManager::LeaveZone(
           for (auto eState : zone->GetEnemies()) {
             eState->Stop(now);
           }
+
+          // Lazy global zones can be removed once idle long enough
+          if (mLazyZones && def->GetGlobal()) {
+            mIdleZones[uniqueID] = now;
+          }
         }
 
         // Reset tracking refresh if no other zones are active
@@ -1308,9 +1391,47 @@ uint8_t ZoneManager::CreateInstance(
     // on a different channel
     std::shared_ptr<ZoneInstance> instance;
     {
-      uint32_t id = mNextZoneInstanceID++;
+      // Take a prewarmed copy if one is available
+      auto poolIter = !variant ? mInstancePool.find(def->GetID())
+                               : mInstancePool.end();
+      if (poolIter != mInstancePool.end()) {
+        if (poolIter->second.size() > 0) {
+          instance = poolIter->second.front();
+          poolIter->second.pop_front();
+
+          instance->SetAccess(access);
+          instance->SetOriginalAccessCIDs(access->GetAccessCIDs());
+
+          mInstancePoolHits++;
+        } else {
+          mInstancePoolMisses++;
+        }
+
+        // Replace it once the current work is done
+        server->QueueWork(
+            [](ZoneManager* pZoneManager, uint32_t pDefinitionID) {
+              pZoneManager->FillInstancePool(pDefinitionID);
+            },
+            this, def->GetID());
+
+        LogZoneManagerDebug([&]() {
+          return libcomp::String(
+                     "Prewarmed instance pool %1 for instance %2 (%3 hit(s), "
+                     "%4 miss(es))\n")
+              .Arg(instance ? "hit" : "miss")
+              .Arg(def->GetID())
+              .Arg(mInstancePoolHits)
+              .Arg(mInstancePoolMisses);
+        });
+      }
+
+      if (!instance) {
+        instance = std::make_shared<ZoneInstance>(mNextZoneInstanceID++, def,
+                                                  access);
+      }
+
+      uint32_t id = instance->GetID();
 
-      instance = std::make_shared<ZoneInstance>(id, def, access);
       if (variant) {
         instance->SetVariant(variant);
         instance->SetTimerExpirationEventID(
@@ -1373,6 +1494,45 @@ uint8_t ZoneManager::CreateInstance(
   }
 }
 
+void ZoneManager::PrewarmInstances() {
+  auto server = mServer.lock();
+  auto conf =
+      std::dynamic_pointer_cast<objects::ChannelConfig>(server->GetConfig());
+
+  for (auto pair : conf->GetInstancePrewarm()) {
+    if (pair.second) {
+      FillInstancePool(pair.first);
+    }
+  }
+}
+
+void ZoneManager::ClearInstancePool() {
+  std::lock_guard<libcomp::Mutex> lock(mLock);
+
+  for (auto& pair : mInstancePool) {
+    for (auto& instance : pair.second) {
+      for (auto& zone : instance->GetZones()) {
+        RemoveZone(zone, false);
+      }
+    }
+  }
+
+  mInstancePool.clear();
+}
+
+void ZoneManager::GetInstancePoolStats(uint64_t& hits, uint64_t& misses,
+                                       size_t& pooled) {
+  std::lock_guard<libcomp::Mutex> lock(mLock);
+
+  hits = mInstancePoolHits;
+  misses = mInstancePoolMisses;
+
+  pooled = 0;
+  for (auto& pair : mInstancePool) {
+    pooled += pair.second.size();
+  }
+}
+
 void ZoneManager::ExpireInstance(uint32_t instanceID, uint64_t timeOut) {
   auto instance = GetInstance(instanceID);
 
@@ -4005,15 +4165,16 @@ std::shared_ptr<ActiveEntityState> ZoneManager::CreateEnemy(
   std::shared_ptr<objects::EnemyBase> eBase;
   if (!asAlly &&
       (!spawn || spawn->GetCategory() != objects::Spawn::Category_t::ALLY)) {
-    // Building an enemy
-    auto enemy = std::make_shared<objects::Enemy>();
+    // Building an enemy from the zone's pools since enemies respawn
+    // constantly
+    auto enemy = zone->NewEnemy();
     enemy->SetCoreStats(stats);
     enemy->SetType(demonID);
     enemy->SetVariantType(spawn ? spawn->GetVariantType() : 0);
     enemy->SetSpawnSource(spawn);
     eBase = enemy;
 
-    auto eState = std::make_shared<EnemyState>();
+    auto eState = zone->NewEnemyState();
     eState->SetResponsibleEntity(responsibleEntity);
     eState->SetEntity(enemy, definitionManager);
     state = eState;
@@ -6315,7 +6476,7 @@ Point ZoneManager::GetNearestPoint(const Line& line, const Point& point) {
 }
 
 bool ZoneManager::PointInPolygon(const Point& p,
-                                 const std::list<Point> vertices,
+                                 const std::list<Point>& vertices,
                                  float overlapRadius) {
   auto p1 = vertices.begin();
   auto p2 = vertices.begin();
@@ -6570,19 +6731,30 @@ std::shared_ptr<Zone> ZoneManager::GetZone(
   std::shared_ptr<Zone> zone;
   {
     if (zoneDefinition->GetGlobal()) {
-      std::lock_guard<libcomp::Mutex> lock(mLock);
-      auto iter = mGlobalZoneMap.find(zoneID);
-      if (iter != mGlobalZoneMap.end()) {
-        for (auto dPair : iter->second) {
-          // If dynamicMapID is 0, check all valid instances and take
-          // the first one that applies
-          if (dynamicMapID == 0 || dPair.first == dynamicMapID) {
-            zone = mZones[dPair.second];
-            break;
+      {
+        std::lock_guard<libcomp::Mutex> lock(mLock);
+        auto iter = mGlobalZoneMap.find(zoneID);
+        if (iter != mGlobalZoneMap.end()) {
+          for (auto dPair : iter->second) {
+            // If dynamicMapID is 0, check all valid instances and take
+            // the first one that applies
+            if (dynamicMapID == 0 || dPair.first == dynamicMapID) {
+              zone = mZones[dPair.second];
+
+              // Keep lazy zones from being evicted until entered
+              if (mLazyZones) {
+                mPinnedZones[dPair.second]++;
+              }
+              break;
+            }
           }
         }
       }
 
+      if (nullptr == zone) {
+        zone = GetLazyGlobalZone(zoneID, dynamicMapID, true);
+      }
+
       if (nullptr == zone) {
         LogZoneManagerError([&]() {
           return libcomp::String(
@@ -6835,6 +7007,10 @@ std::shared_ptr<Zone> ZoneManager::CreateZone(
   auto definitionManager = server->GetDefinitionManager();
   auto zoneData = definitionManager->GetZoneData(zoneID);
 
+  // Get the geometry first as lazy zones may need to load it
+  auto geometry = GetZoneGeometry(zoneData);
+  auto dynamicMap = GetDynamicMap(dynamicMapID);
+
   std::shared_ptr<Zone> zone;
   {
     std::lock_guard<libcomp::Mutex> lock(mLock);
@@ -6847,16 +7023,12 @@ std::shared_ptr<Zone> ZoneManager::CreateZone(
       zone->SetMatch(instance->GetMatch());
     }
 
-    auto qmpFile = zoneData->GetFile()->GetQmpFile();
-    auto geoIter = !qmpFile.IsEmpty() ? mZoneGeometry.find(qmpFile.C())
-                                      : mZoneGeometry.end();
-    if (geoIter != mZoneGeometry.end()) {
-      zone->SetGeometry(geoIter->second);
+    if (geometry) {
+      zone->SetGeometry(geometry);
     }
 
-    auto it = mDynamicMaps.find(dynamicMapID);
-    if (it != mDynamicMaps.end()) {
-      zone->SetDynamicMap(it->second);
+    if (dynamicMap) {
+      zone->SetDynamicMap(dynamicMap);
     } else {
       LogZoneManagerWarning([zoneID, dynamicMapID]() {
         return libcomp::String(
@@ -7191,6 +7363,349 @@ std::shared_ptr<Zone> ZoneManager::CreateZone(
   return zone;
 }
 
+std::shared_ptr<Zone> ZoneManager::CreateGlobalZone(
+    const std::shared_ptr<objects::ServerZone>& definition) {
+  auto zone = CreateZone(definition);
+  if (!zone) {
+    return nullptr;
+  }
+
+  std::lock_guard<libcomp::Mutex> lock(mLock);
+  mGlobalZoneMap[definition->GetID()][definition->GetDynamicMapID()] =
+      zone->GetID();
+  if (definition->GetGlobalBossGroup()) {
+    mGlobalBossZones[definition->GetGlobalBossGroup()].insert(zone->GetID());
+  }
+
+  return zone;
+}
+
+std::shared_ptr<Zone> ZoneManager::GetLazyGlobalZone(uint32_t zoneID,
+                                                     uint32_t dynamicMapID,
+                                                     bool pin) {
+  if (!mLazyZones) {
+    return nullptr;
+  }
+
+  // Only one global zone is created at a time so two requests for the
+  // same zone cannot both create it
+  std::lock_guard<libcomp::Mutex> gLock(mGlobalZoneLock);
+
+  {
+    std::lock_guard<libcomp::Mutex> lock(mLock);
+    auto iter = mGlobalZoneMap.find(zoneID);
+    if (iter != mGlobalZoneMap.end()) {
+      for (auto dPair : iter->second) {
+        if (dynamicMapID == 0 || dPair.first == dynamicMapID) {
+          if (pin) {
+            mPinnedZones[dPair.second]++;
+          }
+
+          return mZones[dPair.second];
+        }
+      }
+    }
+
+    auto localIter = mLocalZoneIDs.find(zoneID);
+    if (localIter == mLocalZoneIDs.end() ||
+        (dynamicMapID != 0 &&
+         localIter->second.find(dynamicMapID) == localIter->second.end())) {
+      // Not hosted by this server
+      return nullptr;
+    }
+  }
+
+  auto server = mServer.lock();
+  auto definition =
+      server->GetServerDataManager()->GetZoneData(zoneID, dynamicMapID, true);
+  if (!definition || !definition->GetGlobal()) {
+    return nullptr;
+  }
+
+  auto sharedConfig = server->GetWorldSharedConfig();
+  if (sharedConfig->ChannelDistributionCount() != 0 &&
+      sharedConfig->GetChannelDistribution(definition->GetGroupID()) !=
+          server->GetChannelID()) {
+    return nullptr;
+  }
+
+  LogZoneManagerDebug([&]() {
+    return libcomp::String("Creating lazy global zone: %1 (%2)\n")
+        .Arg(zoneID)
+        .Arg(definition->GetDynamicMapID());
+  });
+
+  auto zone = CreateGlobalZone(definition);
+  if (zone) {
+    // The zone is idle until someone enters it
+    std::lock_guard<libcomp::Mutex> lock(mLock);
+    mIdleZones[zone->GetID()] = ChannelServer::GetServerTime();
+
+    if (pin) {
+      mPinnedZones[zone->GetID()]++;
+    }
+  }
+
+  return zone;
+}
+
+void ZoneManager::UnpinZone(const std::shared_ptr<Zone>& zone) {
+  std::lock_guard<libcomp::Mutex> lock(mLock);
+  auto it = mPinnedZones.find(zone->GetID());
+  if (it != mPinnedZones.end() && --it->second == 0) {
+    mPinnedZones.erase(it);
+  }
+}
+
+std::shared_ptr<ZoneGeometry> ZoneManager::GetZoneGeometry(
+    const std::shared_ptr<objects::MiZoneData>& zoneData) {
+  if (!zoneData) {
+    return nullptr;
+  }
+
+  auto qmpFile = zoneData->GetFile()->GetQmpFile();
+  if (qmpFile.IsEmpty()) {
+    return nullptr;
+  }
+
+  std::set<uint32_t> dynamicMapIDs;
+  {
+    std::lock_guard<libcomp::Mutex> lock(mLock);
+    auto geoIter = mZoneGeometry.find(qmpFile.C());
+    if (geoIter != mZoneGeometry.end()) {
+      return geoIter->second;
+    } else if (!mLazyZones) {
+      return nullptr;
+    }
+
+    auto localIter = mLocalZoneIDs.find(zoneData->GetBasic()->GetID());
+    if (localIter != mLocalZoneIDs.end()) {
+      dynamicMapIDs = localIter->second;
+    }
+  }
+
+  // Load the file outside of the lock as it can take a while
+  ZoneGeometryLoader loader;
+  auto geometry = loader.LoadZoneGeometry(zoneData->GetBasic()->GetID(),
+                                          dynamicMapIDs, mServer.lock());
+  if (!geometry) {
+    return nullptr;
+  }
+
+  std::lock_guard<libcomp::Mutex> lock(mLock);
+  auto geoIter = mZoneGeometry.find(qmpFile.C());
+  if (geoIter != mZoneGeometry.end()) {
+    // Loaded by another zone in the meantime
+    return geoIter->second;
+  }
+
+  mZoneGeometry[qmpFile.C()] = geometry;
+
+  return geometry;
+}
+
+std::shared_ptr<DynamicMap> ZoneManager::GetDynamicMap(uint32_t dynamicMapID) {
+  {
+    std::lock_guard<libcomp::Mutex> lock(mLock);
+    auto it = mDynamicMaps.find(dynamicMapID);
+    if (it != mDynamicMaps.end()) {
+      return it->second;
+    } else if (!mLazyZones) {
+      return nullptr;
+    }
+  }
+
+  auto dMap = BuildDynamicMap(dynamicMapID);
+  if (!dMap) {
+    return nullptr;
+  }
+
+  std::lock_guard<libcomp::Mutex> lock(mLock);
+  auto it = mDynamicMaps.find(dynamicMapID);
+  if (it != mDynamicMaps.end()) {
+    return it->second;
+  }
+
+  mDynamicMaps[dynamicMapID] = dMap;
+
+  return dMap;
+}
+
+std::shared_ptr<DynamicMap> ZoneManager::BuildDynamicMap(
+    uint32_t dynamicMapID) {
+  auto definitionManager = mServer.lock()->GetDefinitionManager();
+  if (!definitionManager->GetDynamicMapData(dynamicMapID)) {
+    return nullptr;
+  }
+
+  auto dMap = std::make_shared<DynamicMap>();
+  auto spots = definitionManager->GetSpotData(dynamicMapID);
+  for (auto spotPair : spots) {
+    Point center(spotPair.second->GetCenterX(), spotPair.second->GetCenterY());
+    float rot = spotPair.second->GetRotation();
+
+    float x1 = center.x - spotPair.second->GetSpanX();
+    float y1 = center.y - spotPair.second->GetSpanY();
+
+    float x2 = center.x + spotPair.second->GetSpanX();
+    float y2 = center.y + spotPair.second->GetSpanY();
+
+    // Build the unrotated rectangle
+    std::vector<Point> points;
+    points.push_back(Point(x1, y1));
+    points.push_back(Point(x2, y1));
+    points.push_back(Point(x2, y2));
+    points.push_back(Point(x1, y2));
+
+    auto shape = std::make_shared<ZoneSpotShape>();
+
+    // Rotate each point around the center
+    for (auto& p : points) {
+      p = RotatePoint(p, center, rot);
+      shape->Vertices.push_back(p);
+    }
+
+    shape->Definition = spotPair.second;
+    shape->Lines.push_back(Line(points[0], points[1]));
+    shape->Lines.push_back(Line(points[1], points[2]));
+    shape->Lines.push_back(Line(points[2], points[3]));
+    shape->Lines.push_back(Line(points[3], points[0]));
+
+    // Determine the boundaries of the completed shape
+    std::list<float> xVals;
+    std::list<float> yVals;
+
+    for (Line& line : shape->Lines) {
+      for (const Point& p : {line.first, line.second}) {
+        xVals.push_back(p.x);
+        yVals.push_back(p.y);
+      }
+    }
+
+    xVals.sort([](const float& a, const float& b) { return a < b; });
+
+    yVals.sort([](const float& a, const float& b) { return a < b; });
+
+    shape->Boundaries[0] = Point(xVals.front(), yVals.front());
+    shape->Boundaries[1] = Point(xVals.back(), yVals.back());
+
+    dMap->Spots[spotPair.first] = shape;
+    dMap->SpotTypes[(uint8_t)spotPair.second->GetType()].push_back(shape);
+  }
+
+  return dMap;
+}
+
+void ZoneManager::FillInstancePool(uint32_t definitionID) {
+  auto server = mServer.lock();
+  auto conf =
+      std::dynamic_pointer_cast<objects::ChannelConfig>(server->GetConfig());
+
+  size_t count = (size_t)conf->GetInstancePrewarm(definitionID);
+
+  auto def = server->GetServerDataManager()->GetZoneInstanceData(definitionID);
+  if (!def || !def->ZoneIDsCount()) {
+    LogZoneManagerWarning([&]() {
+      return libcomp::String(
+                 "Invalid zone instance configured to be prewarmed: %1\n")
+          .Arg(definitionID);
+    });
+
+    return;
+  }
+
+  // Only instances hosted by this channel can be created here
+  auto sharedConfig = server->GetWorldSharedConfig();
+  if (sharedConfig->ChannelDistributionCount() > 0 &&
+      sharedConfig->GetChannelDistribution(def->GetGroupID()) !=
+          server->GetChannelID()) {
+    return;
+  }
+
+  // Setup actions run when the starting zone is built, which for a pooled
+  // instance is before anyone has been given access to it
+  auto zoneDef = server->GetServerDataManager()->GetZoneData(
+      def->GetZoneIDs(0), def->GetDynamicMapIDs(0), true);
+  if (zoneDef) {
+    for (auto trigger : zoneDef->GetTriggers()) {
+      if (trigger->GetTrigger() ==
+          objects::ServerZoneTrigger::Trigger_t::ON_SETUP) {
+        LogZoneManagerWarning([&]() {
+          return libcomp::String(
+                     "Zone instance %1 cannot be prewarmed as its starting "
+                     "zone has setup actions\n")
+              .Arg(definitionID);
+        });
+
+        return;
+      }
+    }
+  }
+
+  while (true) {
+    {
+      std::lock_guard<libcomp::Mutex> lock(mLock);
+      if (mInstancePool[definitionID].size() >= count) {
+        break;
+      }
+    }
+
+    auto instance = BuildPooledInstance(def);
+    if (!instance) {
+      break;
+    }
+
+    std::lock_guard<libcomp::Mutex> lock(mLock);
+    mInstancePool[definitionID].push_back(instance);
+  }
+}
+
+std::shared_ptr<ZoneInstance> ZoneManager::BuildPooledInstance(
+    const std::shared_ptr<objects::ServerZoneInstance>& definition) {
+  // Access is replaced when the instance is taken from the pool. Nothing
+  // acts on this one as instances with setup actions are never pooled.
+  auto access = std::make_shared<objects::InstanceAccess>();
+  access->SetDefinitionID(definition->GetID());
+
+  std::shared_ptr<ZoneInstance> instance;
+  {
+    std::lock_guard<libcomp::Mutex> lock(mLock);
+    instance = std::make_shared<ZoneInstance>(mNextZoneInstanceID++,
+                                              definition, access);
+  }
+
+  // Only the starting zone is built as later zones can depend on the
+  // state of the instance when they are first entered
+  auto zone = GetInstanceZone(instance, definition->GetZoneIDs(0),
+                              definition->GetDynamicMapIDs(0));
+  if (!zone) {
+    return nullptr;
+  }
+
+  return instance;
+}
+
+bool ZoneManager::CanEvictZone(const std::shared_ptr<Zone>& zone) {
+  // A client is about to enter the zone
+  if (mPinnedZones.find(zone->GetID()) != mPinnedZones.end()) {
+    return false;
+  }
+
+  auto def = zone->GetDefinition();
+
+  // Anything that holds player, event or spawn state must stay loaded as
+  // it would not be the same if the zone was created again. Killed spawns
+  // in particular would come back early without their respawn timers.
+  return zone->GetConnections().size() == 0 && def->GetGlobal() &&
+         !def->GetGlobalBossGroup() && !zone->HasPendingSpawns() &&
+         zone->GetFlagStates().size() == 0 &&
+         zone->GetBazaars().size() == 0 &&
+         zone->GetCultureMachines().size() == 0 &&
+         zone->GetLootBoxes().size() == 0 &&
+         zone->GetPvPBases().size() == 0 &&
+         zone->GetDiasporaBases().size() == 0 && !zone->GetUBMatch();
+}
+
 void ZoneManager::AddPvPBases(
     const std::shared_ptr<Zone>& zone,
     const std::shared_ptr<objects::PvPInstanceVariant>& variant) {
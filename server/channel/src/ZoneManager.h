@@ -82,7 +82,9 @@ class ZoneManager {
    * Load all QMP zone geometry files and prepare them to be bound
    * to zones as they are instantiated. If a specific file fails to
    * load, an error will be returned but the zone will still be
-   * accessible without server side collision support.
+   * accessible without server side collision support. If lazy zones
+   * are enabled, only the local zone IDs are gathered and the geometry
+   * is loaded when the first zone using it is created.
    */
   void LoadGeometry();
 
@@ -90,9 +92,27 @@ class ZoneManager {
    * Instantiate all global zones the server is responsible for
    * hosting. This should be called only once, after a valid world
    * connection has been established but before any clients connect.
+   * If lazy zones are enabled, only zones in a multi-zone boss group
+   * are instantiated and the rest are created when first needed.
    */
   void InstanceGlobalZones();
 
+  /**
+   * Schedule future server work to remove lazily created global zones
+   * that have been idle for longer than the supplied time-out.
+   * @param timeOut Time in seconds a zone must be idle to be removed
+   * @return true if the work was scheduled, false if it was not
+   */
+  bool ScheduleIdleZoneEviction(uint16_t timeOut);
+
+  /**
+   * Remove all lazily created global zones that have been idle for
+   * longer than the supplied time-out along with any geometry and
+   * dynamic maps no longer used by a zone.
+   * @param timeOut Time in seconds a zone must be idle to be removed
+   */
+  void EvictIdleZones(uint16_t timeOut);
+
   /**
    * Get the zone associated to a client connection
    * @param client Client connection connected to a zone
@@ -182,6 +202,31 @@ class ZoneManager {
   uint8_t CreateInstance(
       const std::shared_ptr<objects::InstanceAccess>& access);
 
+  /**
+   * Build the configured number of pooled copies of each prewarmed
+   * instance so creating one does not need to build the starting zone.
+   * This should be called after the global zones have been instanced.
+   */
+  void PrewarmInstances();
+
+  /**
+   * Remove every prewarmed instance that has not been given to anyone
+   * yet. Used when the server data they were built from is replaced.
+   */
+  void ClearInstancePool();
+
+  /**
+   * Get the usage statistics of the prewarmed instance pool
+   * @param hits Output parameter for the number of instances created
+   *  from the pool
+   * @param misses Output parameter for the number of prewarmed instances
+   *  that had to be built because the pool was empty
+   * @param pooled Output parameter for the number of instances currently
+   *  in the pool
+   */
+  void GetInstancePoolStats(uint64_t& hits, uint64_t& misses,
+                            size_t& pooled);
+
   /**
    * Expire and remove an instance matching the supplied values
    * @param instanceID ID of the instance to expire
@@ -1113,7 +1158,7 @@ class ZoneManager {
    *  using this value as the radius and checking if it overlaps anywhere
    * @return true if the point is within the polygon, false if it is not
    */
-  static bool PointInPolygon(const Point& p, const std::list<Point> vertices,
+  static bool PointInPolygon(const Point& p, const std::list<Point>& vertices,
                              float overlapRadius = 0.f);
 
   /**
@@ -1316,7 +1361,9 @@ class ZoneManager {
    * @param client Pointer to the client connection to use to decide whether
    *  a new zone should be created if the zone is private
    * @param currentInstanceID Optional instance ID of the zone being moved from
-   * @return Pointer to the new or existing zone
+   * @return Pointer to the new or existing zone. Lazily created global
+   *  zones are pinned until @ref UnpinZone is called so they cannot be
+   *  evicted before the client enters them.
    */
   std::shared_ptr<Zone> GetZone(
       uint32_t zoneID, uint32_t dynamicMapID,
@@ -1333,6 +1380,84 @@ class ZoneManager {
       const std::shared_ptr<objects::ServerZone>& definition,
       const std::shared_ptr<ZoneInstance>& instance = nullptr);
 
+  /**
+   * Create a global zone and register it with the manager
+   * @param definition Pointer to a global zone definition
+   * @return Pointer to the new zone
+   */
+  std::shared_ptr<Zone> CreateGlobalZone(
+      const std::shared_ptr<objects::ServerZone>& definition);
+
+  /**
+   * Get or create a global zone hosted by the server when lazy zones
+   * are enabled
+   * @param zoneID Definition ID of the zone
+   * @param dynamicMapID Dynamic map ID of the zone or 0 for the first
+   *  one hosted by the server
+   * @param pin If true, pin the zone so it cannot be evicted until
+   *  @ref UnpinZone is called
+   * @return Pointer to the zone, null if the server does not host it
+   */
+  std::shared_ptr<Zone> GetLazyGlobalZone(uint32_t zoneID,
+                                          uint32_t dynamicMapID,
+                                          bool pin = false);
+
+  /**
+   * Release a pin on a lazily created global zone taken by @ref GetZone
+   * once the client has entered it or failed to
+   * @param zone Pointer to the zone
+   */
+  void UnpinZone(const std::shared_ptr<Zone>& zone);
+
+  /**
+   * Get the geometry for a zone, loading the QMP file if it is not
+   * loaded yet and lazy zones are enabled
+   * @param zoneData Pointer to the zone's binary definition
+   * @return Pointer to the zone geometry, null if none exists
+   */
+  std::shared_ptr<ZoneGeometry> GetZoneGeometry(
+      const std::shared_ptr<objects::MiZoneData>& zoneData);
+
+  /**
+   * Get the spot shapes for a dynamic map, building them if they are
+   * not built yet and lazy zones are enabled
+   * @param dynamicMapID Dynamic map ID to retrieve
+   * @return Pointer to the dynamic map, null if it does not exist
+   */
+  std::shared_ptr<DynamicMap> GetDynamicMap(uint32_t dynamicMapID);
+
+  /**
+   * Build the spot shapes for a dynamic map from its binary definition
+   * @param dynamicMapID Dynamic map ID to build
+   * @return Pointer to the dynamic map, null if it has no definition
+   */
+  std::shared_ptr<DynamicMap> BuildDynamicMap(uint32_t dynamicMapID);
+
+  /**
+   * Build pooled copies of a prewarmed instance until the pool holds
+   * the configured number
+   * @param definitionID Instance definition ID to build
+   */
+  void FillInstancePool(uint32_t definitionID);
+
+  /**
+   * Build an instance with placeholder access and its starting zone for
+   * the prewarmed instance pool
+   * @param definition Pointer to the instance definition
+   * @return Pointer to the new instance, null if it failed to build
+   */
+  std::shared_ptr<ZoneInstance> BuildPooledInstance(
+      const std::shared_ptr<objects::ServerZoneInstance>& definition);
+
+  /**
+   * Determine if a lazily created global zone can be removed without
+   * losing any state it would not have when created again or a client
+   * is about to enter it. Must be called with mLock held.
+   * @param zone Pointer to the zone
+   * @return true if the zone can be removed
+   */
+  bool CanEvictZone(const std::shared_ptr<Zone>& zone);
+
   /**
    * All all PvP bases defined in a zone from the variant
    * @param zone Pointer to the zone
@@ -1444,6 +1569,29 @@ class ZoneManager {
   /// corresponding binary definitions
   std::unordered_map<uint32_t, std::shared_ptr<DynamicMap>> mDynamicMaps;
 
+  /// Map of zone definition IDs to dynamic map IDs hosted by the server
+  std::unordered_map<uint32_t, std::set<uint32_t>> mLocalZoneIDs;
+
+  /// Map of instance definition IDs to prewarmed instances that have not
+  /// been given to anyone yet
+  std::unordered_map<uint32_t, std::list<std::shared_ptr<ZoneInstance>>>
+      mInstancePool;
+
+  /// Number of instances created from the prewarmed instance pool
+  uint64_t mInstancePoolHits;
+
+  /// Number of prewarmed instances built because the pool was empty
+  uint64_t mInstancePoolMisses;
+
+  /// Map of lazily created global zone unique IDs with no connections
+  /// to the server time they became idle
+  std::unordered_map<uint32_t, uint64_t> mIdleZones;
+
+  /// Map of lazily created global zone unique IDs to the number of clients
+  /// that have looked the zone up to enter it but have not entered yet.
+  /// Pinned zones are never evicted.
+  std::unordered_map<uint32_t, uint32_t> mPinnedZones;
+
   /// Map of global boss group IDs to zones in that group on the server
   std::unordered_map<uint32_t, std::set<uint32_t>> mGlobalBossZones;
 
@@ -1490,6 +1638,13 @@ class ZoneManager {
   /// Server lock for creating or getting existing zones in an instance
   libcomp::Mutex mInstanceZoneLock;
 
+  /// Server lock for lazily creating global zones
+  libcomp::Mutex mGlobalZoneLock;
+
+  /// Indicates that geometry and global zones are loaded when first
+  /// needed instead of at startup
+  bool mLazyZones;
+
   /// Pointer to the channel server
   std::weak_ptr<ChannelServer> mServer;
 };
@@ -35,6 +35,9 @@
 #include <Packet.h>
 #include <PacketCodes.h>
 
+// Standard C++11 Includes
+#include <sstream>
+
 // channel Includes
 #include "AccountManager.h"
 #include "ChannelServer.h"
@@ -47,7 +50,14 @@ void DumpAccount(AccountManager* accountManager,
                  const std::shared_ptr<ChannelClientConnection> client) {
   auto state = client->GetClientState();
 
-  std::string dump = accountManager->DumpAccount(state).ToUtf8();
+  // The header carries the size and checksum of the whole dump so the
+  // compact binary form is collected before it is sent.
+  std::stringstream ss;
+  std::string dump;
+
+  if (accountManager->DumpAccount(state, ss)) {
+    dump = ss.str();
+  }
 
   // Send the account dump to the client.
   if (!dump.empty()) {
@@ -0,0 +1,56 @@
+/**
+ * @file server/channel/src/packets/internal/MemoryReport.cpp
+ * @ingroup channel
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Parser to reply to memory usage requests from the world.
+ *
+ * This file is part of the Channel Server (channel).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Packets.h"
+
+// libcomp Includes
+#include <ManagerPacket.h>
+#include <MemoryAccounting.h>
+#include <Packet.h>
+#include <PacketCodes.h>
+
+using namespace channel;
+
+bool Parsers::MemoryReport::Parse(
+    libcomp::ManagerPacket* pPacketManager,
+    const std::shared_ptr<libcomp::TcpConnection>& connection,
+    libcomp::ReadOnlyPacket& p) const {
+  (void)pPacketManager;
+
+  if (p.Size() != 0) {
+    return false;
+  }
+
+  libcomp::Packet reply;
+  reply.WritePacketCode(InternalPacketCode_t::PACKET_MEMORY_REPORT);
+
+  libhack::MemoryAccounting::SavePacket(
+      reply, libhack::MemoryAccounting::GetUsage());
+
+  connection->SendPacket(reply);
+
+  return true;
+}
@@ -230,7 +230,8 @@ bool Parsers::PartyUpdate::Parse(
         auto cState = client->GetClientState()->GetCharacterState();
         if (recalcEntities.find(cState->GetEntityID()) ==
             recalcEntities.end()) {
-          for (auto pair : tokuseiManager->Recalculate(cState, true)) {
+          for (auto pair :
+               tokuseiManager->Recalculate(cState, true, {}, true)) {
             recalcEntities.insert(pair.first);
           }
         }
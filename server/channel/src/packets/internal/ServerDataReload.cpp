@@ -0,0 +1,57 @@
+/**
+ * @file server/channel/src/packets/internal/ServerDataReload.cpp
+ * @ingroup channel
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Parser to handle server data reload requests from the world.
+ *
+ * This file is part of the Channel Server (channel).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Packets.h"
+
+// libcomp Includes
+#include <ManagerPacket.h>
+#include <Packet.h>
+#include <PacketCodes.h>
+
+// channel Includes
+#include "ChannelServer.h"
+
+using namespace channel;
+
+bool Parsers::ServerDataReload::Parse(
+    libcomp::ManagerPacket* pPacketManager,
+    const std::shared_ptr<libcomp::TcpConnection>& connection,
+    libcomp::ReadOnlyPacket& p) const {
+  (void)connection;
+
+  if (p.Size() != 0) {
+    return false;
+  }
+
+  auto server =
+      std::dynamic_pointer_cast<ChannelServer>(pPacketManager->GetServer());
+
+  // A reload already in progress may have read the data before it
+  // changed so queue another one to run after it
+  server->ReloadServerData(nullptr, true);
+
+  return true;
+}
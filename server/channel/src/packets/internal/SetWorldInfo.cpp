@@ -162,6 +162,7 @@ bool SetWorldInfoFromPacket(
   // connected properly
   server->GetZoneManager()->LoadGeometry();
   server->GetZoneManager()->InstanceGlobalZones();
+  server->GetZoneManager()->PrewarmInstances();
 
   // Initialize the sync manager now that we have the DBs, shutdown if
   // it fails
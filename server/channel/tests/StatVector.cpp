@@ -0,0 +1,200 @@
+/**
+ * @file server/channel/tests/StatVector.cpp
+ * @ingroup channel
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Test the flat stat accumulators indexed by correct table ID.
+ *
+ * This file is part of the Channel Server (channel).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Ignore warnings
+#include <PushIgnore.h>
+
+#include <gtest/gtest.h>
+
+// Stop ignoring warnings
+#include <PopIgnore.h>
+
+// Standard C++11 Includes
+#include <map>
+#include <random>
+
+// channel Includes
+#include <StatVector.h>
+
+using namespace channel;
+
+typedef objects::MiCorrectTbl::ID_t CorrectTbl;
+
+TEST(StatVector, Unset) {
+  StatVector<int32_t> stats;
+
+  for (size_t i = 0; i < CORRECT_TBL_COUNT; i++) {
+    EXPECT_FALSE(stats.Has((CorrectTbl)i));
+    EXPECT_EQ(0, stats.Get((CorrectTbl)i));
+  }
+}
+
+TEST(StatVector, Add) {
+  StatVector<int32_t> stats;
+
+  stats.Add(CorrectTbl::STR, 5);
+  stats.Add(CorrectTbl::STR, 7);
+  EXPECT_TRUE(stats.Has(CorrectTbl::STR));
+  EXPECT_EQ(12, stats.Get(CorrectTbl::STR));
+
+  // A slot that sums to zero is still set
+  stats.Add(CorrectTbl::VIT, 3);
+  stats.Add(CorrectTbl::VIT, -3);
+  EXPECT_TRUE(stats.Has(CorrectTbl::VIT));
+  EXPECT_EQ(0, stats.Get(CorrectTbl::VIT));
+
+  // Other slots are not touched
+  EXPECT_FALSE(stats.Has(CorrectTbl::MAGIC));
+  EXPECT_EQ(0, stats.Get(CorrectTbl::MAGIC));
+}
+
+TEST(StatVector, Max) {
+  StatVector<int16_t> stats;
+
+  // An unset slot always takes the value, even if it is below zero
+  stats.Max(CorrectTbl::HP_MAX, -10);
+  EXPECT_TRUE(stats.Has(CorrectTbl::HP_MAX));
+  EXPECT_EQ(-10, stats.Get(CorrectTbl::HP_MAX));
+
+  stats.Max(CorrectTbl::HP_MAX, -20);
+  EXPECT_EQ(-10, stats.Get(CorrectTbl::HP_MAX));
+
+  stats.Max(CorrectTbl::HP_MAX, 30);
+  EXPECT_EQ(30, stats.Get(CorrectTbl::HP_MAX));
+
+  stats.Max(CorrectTbl::HP_MAX, 30);
+  EXPECT_EQ(30, stats.Get(CorrectTbl::HP_MAX));
+}
+
+TEST(StatVector, Erase) {
+  StatVector<double> stats;
+
+  stats.Add(CorrectTbl::SPEED, 1.5);
+  stats.Erase(CorrectTbl::SPEED);
+  EXPECT_FALSE(stats.Has(CorrectTbl::SPEED));
+  EXPECT_EQ(0.0, stats.Get(CorrectTbl::SPEED));
+
+  // Adding again starts from zero
+  stats.Add(CorrectTbl::SPEED, 2.0);
+  EXPECT_EQ(2.0, stats.Get(CorrectTbl::SPEED));
+
+  // Erasing an unset slot does nothing
+  stats.Erase(CorrectTbl::LUCK);
+  EXPECT_FALSE(stats.Has(CorrectTbl::LUCK));
+}
+
+TEST(StatVector, OutOfRange) {
+  StatVector<int32_t> stats;
+  auto id = (CorrectTbl)CORRECT_TBL_COUNT;
+
+  stats.Add(id, 1);
+  stats.Max(id, 1);
+  stats.Erase(id);
+  EXPECT_FALSE(stats.Has(id));
+  EXPECT_EQ(0, stats.Get(id));
+
+  auto last = (CorrectTbl)(CORRECT_TBL_COUNT - 1);
+  stats.Add(last, 4);
+  EXPECT_TRUE(stats.Has(last));
+  EXPECT_EQ(4, stats.Get(last));
+}
+
+TEST(StatVector, MatchesMap) {
+  // Fixed seed so a failure can be reproduced
+  std::mt19937 rng(45);
+
+  // Include IDs past the end of the table which must be ignored
+  std::uniform_int_distribution<size_t> idDist(0, CORRECT_TBL_COUNT + 4);
+  std::uniform_int_distribution<int32_t> valueDist(-100, 100);
+  std::uniform_int_distribution<int> opDist(0, 9);
+
+  StatVector<int32_t> stats;
+  std::map<size_t, int32_t> expected;
+
+  for (int i = 0; i < 100000; i++) {
+    size_t idx = idDist(rng);
+    auto id = (CorrectTbl)idx;
+    int32_t value = valueDist(rng);
+    bool valid = idx < CORRECT_TBL_COUNT;
+
+    int op = opDist(rng);
+    if (op < 6) {
+      stats.Add(id, value);
+      if (valid) {
+        expected[idx] += value;
+      }
+    } else if (op < 9) {
+      stats.Max(id, value);
+      if (valid) {
+        auto it = expected.find(idx);
+        if (it == expected.end() || it->second < value) {
+          expected[idx] = value;
+        }
+      }
+    } else {
+      stats.Erase(id);
+      expected.erase(idx);
+    }
+
+    auto it = expected.find(idx);
+    ASSERT_EQ(it != expected.end(), stats.Has(id)) << "Slot " << idx;
+    ASSERT_EQ(it != expected.end() ? it->second : 0, stats.Get(id))
+        << "Slot " << idx;
+  }
+
+  for (size_t i = 0; i < CORRECT_TBL_COUNT; i++) {
+    auto it = expected.find(i);
+    EXPECT_EQ(it != expected.end(), stats.Has((CorrectTbl)i));
+    EXPECT_EQ(it != expected.end() ? it->second : 0,
+              stats.Get((CorrectTbl)i));
+  }
+}
+
+TEST(StatFlags, SetAndHas) {
+  StatFlags none;
+  for (size_t i = 0; i < CORRECT_TBL_COUNT; i++) {
+    EXPECT_FALSE(none.Has((CorrectTbl)i));
+  }
+
+  StatFlags flags = {CorrectTbl::STR, CorrectTbl::INT};
+  EXPECT_TRUE(flags.Has(CorrectTbl::STR));
+  EXPECT_TRUE(flags.Has(CorrectTbl::INT));
+  EXPECT_FALSE(flags.Has(CorrectTbl::VIT));
+
+  flags.Set(CorrectTbl::VIT);
+  EXPECT_TRUE(flags.Has(CorrectTbl::VIT));
+
+  // Out of range IDs are never set
+  auto id = (CorrectTbl)CORRECT_TBL_COUNT;
+  flags.Set(id);
+  EXPECT_FALSE(flags.Has(id));
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
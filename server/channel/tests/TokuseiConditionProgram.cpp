@@ -0,0 +1,312 @@
+/**
+ * @file server/channel/tests/TokuseiConditionProgram.cpp
+ * @ingroup channel
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Test the compiled tokusei conditions against the interpreted
+ *  conditions.
+ *
+ * This file is part of the Channel Server (channel).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Ignore warnings
+#include <PushIgnore.h>
+
+#include <gtest/gtest.h>
+
+// Stop ignoring warnings
+#include <PopIgnore.h>
+
+// Standard C++11 Includes
+#include <list>
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+// channel Includes
+#include <TokuseiConditionProgram.h>
+
+using namespace channel;
+
+typedef objects::TokuseiCondition::Type_t ConditionType;
+typedef objects::TokuseiCondition::Comparator_t Comparator;
+
+namespace {
+
+std::shared_ptr<objects::TokuseiCondition> MakeCondition(
+    ConditionType type, Comparator comparator, int32_t value,
+    uint8_t optionGroupID) {
+  auto condition = std::make_shared<objects::TokuseiCondition>();
+  condition->SetType(type);
+  condition->SetComparator(comparator);
+  condition->SetValue(value);
+  condition->SetOptionGroupID(optionGroupID);
+
+  return condition;
+}
+
+/**
+ * Entity state holding one value per condition type. Conditions are
+ * evaluated following the same rules TokuseiManager uses for each
+ * condition type.
+ */
+class TestEntity {
+ public:
+  /**
+   * Generate an entity with a random value for each condition type.
+   * @param rng Random number source
+   * @return Generated entity
+   */
+  static TestEntity Random(std::mt19937& rng) {
+    TestEntity entity;
+    entity.mIsCharacter = std::uniform_int_distribution<int>(0, 1)(rng) == 1;
+
+    // Conditions compare against 0 to 3 so go one past either end
+    std::uniform_int_distribution<int32_t> valueDist(-1, 4);
+    for (int type = (int)ConditionType::NONE;
+         type <= (int)ConditionType::MOON_PHASE; type++) {
+      entity.mValues[(int8_t)type] = valueDist(rng);
+    }
+
+    return entity;
+  }
+
+  /**
+   * Check if the entity is a character.
+   * @return true if the entity is a character
+   */
+  bool IsCharacter() const { return mIsCharacter; }
+
+  /**
+   * Evaluate a single condition.
+   * @param condition Condition to evaluate
+   * @return true if the condition passes
+   */
+  bool Evaluate(
+      const std::shared_ptr<objects::TokuseiCondition>& condition) const {
+    bool numericCompare = condition->GetComparator() != Comparator::EQUALS &&
+                          condition->GetComparator() != Comparator::NOT_EQUAL;
+
+    switch (condition->GetType()) {
+      case ConditionType::CURRENT_HP:
+      case ConditionType::CURRENT_MP:
+      case ConditionType::DIASPORA_MINIBOSS_COUNT:
+      case ConditionType::GAME_TIME:
+      case ConditionType::MOON_PHASE:
+        break;
+      case ConditionType::LNC:
+      case ConditionType::GENDER:
+      case ConditionType::STATUS_ACTIVE:
+      case ConditionType::PARTY_DEMON_TYPE:
+        if (numericCompare) {
+          return false;
+        }
+        break;
+      case ConditionType::DIGITALIZED:
+      case ConditionType::EQUIPPED_WEAPON_TYPE:
+      case ConditionType::PARTNER_TYPE:
+      case ConditionType::PARTNER_FAMILY:
+      case ConditionType::PARTNER_RACE:
+        if (numericCompare || !mIsCharacter) {
+          return false;
+        }
+        break;
+      case ConditionType::EXPERTISE:
+      case ConditionType::PARTNER_FAMILIARITY:
+      case ConditionType::PARTNER_MITAMA:
+        if (!mIsCharacter) {
+          return false;
+        }
+        break;
+      case ConditionType::SKILL_STATE:
+      default:
+        // Never valid outside of skill processing
+        return false;
+    }
+
+    auto it = mValues.find((int8_t)condition->GetType());
+    int32_t value = it != mValues.end() ? it->second : 0;
+
+    switch (condition->GetComparator()) {
+      case Comparator::EQUALS:
+        return value == condition->GetValue();
+      case Comparator::NOT_EQUAL:
+        return value != condition->GetValue();
+      case Comparator::GTE:
+        return value >= condition->GetValue();
+      case Comparator::LTE:
+        return value <= condition->GetValue();
+      default:
+        return false;
+    }
+  }
+
+ private:
+  /// true if the entity is a character
+  bool mIsCharacter = false;
+
+  /// Value of each condition type
+  std::unordered_map<int8_t, int32_t> mValues;
+};
+
+/// Evaluate the conditions of a tokusei both ways
+void ExpectSameResult(const std::shared_ptr<objects::Tokusei>& tokusei,
+                      const TestEntity& entity) {
+  auto evaluate =
+      [&entity](const std::shared_ptr<objects::TokuseiCondition>& c) {
+        return entity.Evaluate(c);
+      };
+
+  TokuseiConditionProgram program(tokusei);
+
+  EXPECT_EQ(TokuseiConditionProgram::EvaluateInterpreted(tokusei, evaluate),
+            program.Evaluate(entity.IsCharacter(), evaluate))
+      << "Tokusei " << tokusei->GetID();
+}
+
+}  // namespace
+
+TEST(TokuseiConditionProgram, OptionGroups) {
+  // HP >= 50 and (LNC == 0 or LNC == 2)
+  auto tokusei = std::make_shared<objects::Tokusei>();
+  tokusei->AppendConditions(
+      MakeCondition(ConditionType::LNC, Comparator::EQUALS, 0, 1));
+  tokusei->AppendConditions(
+      MakeCondition(ConditionType::CURRENT_HP, Comparator::GTE, 50, 0));
+  tokusei->AppendConditions(
+      MakeCondition(ConditionType::LNC, Comparator::EQUALS, 2, 1));
+
+  TokuseiConditionProgram program(tokusei);
+
+  int32_t hp = 0;
+  int32_t lnc = 0;
+  auto evaluate = [&hp, &lnc](
+                      const std::shared_ptr<objects::TokuseiCondition>& c) {
+    int32_t value = c->GetType() == ConditionType::LNC ? lnc : hp;
+    return c->GetComparator() == Comparator::GTE ? value >= c->GetValue()
+                                                 : value == c->GetValue();
+  };
+
+  hp = 50;
+  lnc = 0;
+  EXPECT_TRUE(program.Evaluate(false, evaluate));
+
+  lnc = 2;
+  EXPECT_TRUE(program.Evaluate(false, evaluate));
+
+  lnc = 1;
+  EXPECT_FALSE(program.Evaluate(false, evaluate));
+
+  hp = 49;
+  lnc = 0;
+  EXPECT_FALSE(program.Evaluate(false, evaluate));
+}
+
+TEST(TokuseiConditionProgram, NeverPasses) {
+  // Skill state conditions are never valid outside of skill processing
+  auto skill = std::make_shared<objects::Tokusei>();
+  skill->AppendConditions(
+      MakeCondition(ConditionType::SKILL_STATE, Comparator::EQUALS, 0, 0));
+
+  // An option group with only impossible conditions can never pass
+  auto group = std::make_shared<objects::Tokusei>();
+  group->AppendConditions(
+      MakeCondition(ConditionType::GENDER, Comparator::GTE, 0, 1));
+  group->AppendConditions(
+      MakeCondition(ConditionType::LNC, Comparator::LTE, 0, 1));
+
+  size_t calls = 0;
+  auto evaluate = [&calls](const std::shared_ptr<objects::TokuseiCondition>&) {
+    calls++;
+    return true;
+  };
+
+  EXPECT_FALSE(TokuseiConditionProgram(skill).Evaluate(true, evaluate));
+  EXPECT_FALSE(TokuseiConditionProgram(group).Evaluate(true, evaluate));
+  EXPECT_EQ(0u, calls);
+}
+
+TEST(TokuseiConditionProgram, CharacterOnly) {
+  auto tokusei = std::make_shared<objects::Tokusei>();
+  tokusei->AppendConditions(
+      MakeCondition(ConditionType::EXPERTISE, Comparator::GTE, 1, 0));
+
+  TokuseiConditionProgram program(tokusei);
+
+  auto evaluate = [](const std::shared_ptr<objects::TokuseiCondition>&) {
+    return true;
+  };
+
+  EXPECT_TRUE(program.Evaluate(true, evaluate));
+  EXPECT_FALSE(program.Evaluate(false, evaluate));
+}
+
+TEST(TokuseiConditionProgram, IsCompiledFrom) {
+  auto tokusei = std::make_shared<objects::Tokusei>();
+  tokusei->AppendConditions(
+      MakeCondition(ConditionType::CURRENT_HP, Comparator::GTE, 1, 0));
+
+  auto copy = std::make_shared<objects::Tokusei>(*tokusei);
+
+  TokuseiConditionProgram program(tokusei);
+  EXPECT_TRUE(program.IsCompiledFrom(tokusei));
+  EXPECT_FALSE(program.IsCompiledFrom(copy));
+}
+
+TEST(TokuseiConditionProgram, MatchesInterpreted) {
+  // Fixed seed so a failure can be reproduced
+  std::mt19937 rng(43);
+
+  std::uniform_int_distribution<int> typeDist(
+      (int)ConditionType::NONE, (int)ConditionType::MOON_PHASE);
+  std::uniform_int_distribution<int> comparatorDist(
+      (int)Comparator::EQUALS, (int)Comparator::LTE);
+  std::uniform_int_distribution<int32_t> valueDist(0, 3);
+  std::uniform_int_distribution<int> groupDist(0, 3);
+  std::uniform_int_distribution<size_t> countDist(1, 6);
+
+  std::list<std::shared_ptr<objects::Tokusei>> tokusei;
+  for (int32_t id = 1; id <= 2000; id++) {
+    auto t = std::make_shared<objects::Tokusei>();
+    t->SetID(id);
+
+    size_t count = countDist(rng);
+    for (size_t i = 0; i < count; i++) {
+      t->AppendConditions(MakeCondition((ConditionType)typeDist(rng),
+                                        (Comparator)comparatorDist(rng),
+                                        valueDist(rng),
+                                        (uint8_t)groupDist(rng)));
+    }
+
+    tokusei.push_back(t);
+  }
+
+  for (int i = 0; i < 50; i++) {
+    auto entity = TestEntity::Random(rng);
+    for (auto& t : tokusei) {
+      ExpectSameResult(t, entity);
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,246 @@
+/**
+ * @file server/channel/tests/TokuseiSourceEffects.cpp
+ * @ingroup channel
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Test that cached tokusei effects are only kept when a full
+ *  evaluation would produce the same effects.
+ *
+ * This file is part of the Channel Server (channel).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Ignore warnings
+#include <PushIgnore.h>
+
+#include <gtest/gtest.h>
+
+// Stop ignoring warnings
+#include <PopIgnore.h>
+
+// object Includes
+#include <Tokusei.h>
+#include <TokuseiCondition.h>
+
+// Standard C++11 Includes
+#include <list>
+#include <memory>
+#include <random>
+#include <set>
+#include <unordered_map>
+
+// channel Includes
+#include <TokuseiSourceEffects.h>
+
+using namespace channel;
+
+namespace {
+
+/// Condition types the model evaluates
+const TokuseiConditionType CONDITION_TYPES[] = {
+    TokuseiConditionType::CURRENT_HP,   TokuseiConditionType::CURRENT_MP,
+    TokuseiConditionType::DIGITALIZED,  TokuseiConditionType::EXPERTISE,
+    TokuseiConditionType::LNC,          TokuseiConditionType::GENDER,
+    TokuseiConditionType::STATUS_ACTIVE, TokuseiConditionType::GAME_TIME,
+    TokuseiConditionType::MOON_PHASE,
+};
+
+/// Number of condition types the model evaluates
+const size_t CONDITION_TYPE_COUNT =
+    sizeof(CONDITION_TYPES) / sizeof(CONDITION_TYPES[0]);
+
+/// Number of values each condition type can have in the model
+const int32_t CONDITION_VALUE_COUNT = 3;
+
+/// Current value of each condition type for the entity being evaluated
+typedef std::unordered_map<int8_t, int32_t> WorldState;
+
+/**
+ * Build a tokusei with random conditions.
+ * @param id ID of the tokusei
+ * @param rng Random number source
+ * @return New tokusei
+ */
+std::shared_ptr<objects::Tokusei> RandomTokusei(int32_t id,
+                                                std::mt19937& rng) {
+  auto tokusei = std::make_shared<objects::Tokusei>();
+  tokusei->SetID(id);
+
+  std::uniform_int_distribution<size_t> countDist(0, 3);
+  std::uniform_int_distribution<size_t> typeDist(0,
+                                                 CONDITION_TYPE_COUNT - 1);
+  std::uniform_int_distribution<int32_t> valueDist(
+      0, CONDITION_VALUE_COUNT - 1);
+
+  size_t count = countDist(rng);
+  for (size_t i = 0; i < count; i++) {
+    auto condition = std::make_shared<objects::TokuseiCondition>();
+    condition->SetType(CONDITION_TYPES[typeDist(rng)]);
+    condition->SetValue(valueDist(rng));
+    tokusei->AppendConditions(condition);
+  }
+
+  return tokusei;
+}
+
+/**
+ * Evaluate a set of tokusei the same way TokuseiManager builds the
+ * effects of a source: every tokusei records its condition types as
+ * triggers and only applies if all of its conditions match.
+ * @param tokusei Tokusei to evaluate
+ * @param state Current condition values
+ * @return Evaluated effects
+ */
+TokuseiSourceEffects Evaluate(
+    const std::list<std::shared_ptr<objects::Tokusei>>& tokusei,
+    const WorldState& state) {
+  TokuseiSourceEffects effects;
+
+  for (auto& t : tokusei) {
+    effects.AddTriggers(t->GetConditions());
+
+    bool match = true;
+    for (auto& condition : t->GetConditions()) {
+      auto it = state.find((int8_t)condition->GetType());
+      if (it == state.end() || it->second != condition->GetValue()) {
+        match = false;
+        break;
+      }
+    }
+
+    if (match) {
+      effects.Self[false][t->GetID()]++;
+    }
+  }
+
+  return effects;
+}
+
+}  // namespace
+
+TEST(TokuseiSourceEffects, AddTriggers) {
+  auto tokusei = std::make_shared<objects::Tokusei>();
+
+  auto hp = std::make_shared<objects::TokuseiCondition>();
+  hp->SetType(TokuseiConditionType::CURRENT_HP);
+  tokusei->AppendConditions(hp);
+
+  auto moon = std::make_shared<objects::TokuseiCondition>();
+  moon->SetType(TokuseiConditionType::MOON_PHASE);
+  tokusei->AppendConditions(moon);
+
+  TokuseiSourceEffects effects;
+  effects.AddTriggers(tokusei->GetConditions());
+
+  EXPECT_EQ(std::set<int8_t>({(int8_t)TokuseiConditionType::CURRENT_HP,
+                              (int8_t)TokuseiConditionType::MOON_PHASE}),
+            effects.Triggers);
+}
+
+TEST(TokuseiSourceEffects, DependsOn) {
+  TokuseiSourceEffects effects;
+  effects.Triggers.insert((int8_t)TokuseiConditionType::CURRENT_HP);
+  effects.Triggers.insert((int8_t)TokuseiConditionType::GAME_TIME);
+
+  EXPECT_FALSE(effects.DependsOn({}));
+  EXPECT_FALSE(effects.DependsOn({TokuseiConditionType::CURRENT_MP}));
+  EXPECT_FALSE(effects.DependsOn({TokuseiConditionType::CURRENT_MP,
+                                  TokuseiConditionType::MOON_PHASE}));
+  EXPECT_TRUE(effects.DependsOn({TokuseiConditionType::CURRENT_HP}));
+  EXPECT_TRUE(effects.DependsOn({TokuseiConditionType::CURRENT_MP,
+                                 TokuseiConditionType::GAME_TIME}));
+
+  TokuseiSourceEffects none;
+  EXPECT_FALSE(none.DependsOn({TokuseiConditionType::CURRENT_HP}));
+}
+
+TEST(TokuseiSourceEffects, Equality) {
+  TokuseiSourceEffects a;
+  TokuseiSourceEffects b;
+  EXPECT_TRUE(a == b);
+
+  a.Self[false][1]++;
+  EXPECT_FALSE(a == b);
+
+  b.Self[false][1]++;
+  EXPECT_TRUE(a == b);
+
+  a.Triggers.insert((int8_t)TokuseiConditionType::LNC);
+  EXPECT_FALSE(a == b);
+}
+
+TEST(TokuseiSourceEffects, KeptEffectsMatchFullEvaluation) {
+  // Fixed seed so a failure can be reproduced
+  std::mt19937 rng(41);
+
+  std::uniform_int_distribution<size_t> typeDist(0,
+                                                 CONDITION_TYPE_COUNT - 1);
+  std::uniform_int_distribution<int32_t> valueDist(
+      0, CONDITION_VALUE_COUNT - 1);
+  std::uniform_int_distribution<size_t> changeCountDist(1, 3);
+
+  size_t kept = 0;
+  size_t evaluated = 0;
+
+  for (int32_t entity = 0; entity < 200; entity++) {
+    std::list<std::shared_ptr<objects::Tokusei>> tokusei;
+    for (int32_t id = 1; id <= 8; id++) {
+      tokusei.push_back(RandomTokusei(id, rng));
+    }
+
+    WorldState state;
+    for (auto type : CONDITION_TYPES) {
+      state[(int8_t)type] = valueDist(rng);
+    }
+
+    auto cached = Evaluate(tokusei, state);
+
+    for (int32_t step = 0; step < 50; step++) {
+      // Change a few condition values, which may or may not differ from
+      // the current values just like a real recalculation trigger
+      std::set<TokuseiConditionType> changes;
+      size_t changeCount = changeCountDist(rng);
+      for (size_t i = 0; i < changeCount; i++) {
+        auto type = CONDITION_TYPES[typeDist(rng)];
+        state[(int8_t)type] = valueDist(rng);
+        changes.insert(type);
+      }
+
+      auto expected = Evaluate(tokusei, state);
+      if (cached.DependsOn(changes)) {
+        cached = expected;
+        evaluated++;
+      } else {
+        ASSERT_TRUE(cached == expected)
+            << "Entity " << entity << " step " << step
+            << " kept effects that differ from a full evaluation.";
+        kept++;
+      }
+    }
+  }
+
+  // Make sure both paths were exercised
+  EXPECT_LT(0u, kept);
+  EXPECT_LT(0u, evaluated);
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -39,6 +39,7 @@
 #include <DefinitionManager.h>
 #include <ErrorCodes.h>
 #include <Log.h>
+#include <MemoryAccounting.h>
 #include <PacketCodes.h>
 #include <Randomizer.h>
 #include <ScriptEngine.h>
@@ -64,6 +65,12 @@ using namespace lobby;
 
 #define MAX_PAYLOAD (4096)
 
+/// Number of accounts returned by /admin/get_accounts if no limit is given.
+#define API_ACCOUNT_PAGE_DEFAULT (100)
+
+/// Maximum number of accounts returned by one /admin/get_accounts call.
+#define API_ACCOUNT_PAGE_MAX (1000)
+
 #ifdef _WIN32
 // Disable "decorated name length exceeded" warning for
 // JsonBox::Object binding
@@ -93,6 +100,8 @@ ApiHandler::ApiHandler(const std::shared_ptr<objects::LobbyConfig>& config,
   mParsers["/admin/message_world"] = &ApiHandler::Admin_MessageWorld;
   mParsers["/admin/online"] = &ApiHandler::Admin_Online;
   mParsers["/admin/post_items"] = &ApiHandler::Admin_PostItems;
+  mParsers["/admin/reload_data"] = &ApiHandler::Admin_ReloadData;
+  mParsers["/admin/memory_report"] = &ApiHandler::Admin_MemoryReport;
   mParsers["/admin/get_promos"] = &ApiHandler::Admin_GetPromos;
   mParsers["/admin/create_promo"] = &ApiHandler::Admin_CreatePromo;
   mParsers["/admin/delete_promo"] = &ApiHandler::Admin_DeletePromo;
@@ -489,19 +498,271 @@ bool ApiHandler::Account_Register(const JsonBox::Object& request,
 bool ApiHandler::Admin_GetAccounts(const JsonBox::Object& request,
                                    JsonBox::Object& response,
                                    const std::shared_ptr<ApiSession>& session) {
-  (void)request;
-  (void)session;
-
   if (!HaveUserLevel(response, session, SVR_CONST.API_ADMIN_LVL_GET_ACCOUNTS)) {
     return true;
   }
 
-  auto accounts =
-      libcomp::PersistentObject::LoadAll<objects::Account>(GetDatabase());
+  // All filtering, sorting and paging is done by the database so only one
+  // page of accounts is ever loaded. Continuation is keyset based (the last
+  // row of the previous page) instead of an offset so deep pages stay cheap
+  // and do not shift when accounts are added or removed.
+  int limit = API_ACCOUNT_PAGE_DEFAULT;
+  bool sortByLogin = false;
+  bool descending = false;
+
+  auto it = request.find("limit");
+
+  if (it != request.end()) {
+    limit = it->second.getInteger();
+
+    if (1 > limit || API_ACCOUNT_PAGE_MAX < limit) {
+      response["error"] = libcomp::String(
+                              "Limit must be in the range [1, %1].")
+                              .Arg(API_ACCOUNT_PAGE_MAX)
+                              .ToUtf8();
+
+      return true;
+    }
+  }
+
+  it = request.find("sort");
+
+  if (it != request.end()) {
+    libcomp::String sort = libcomp::String(it->second.getString()).ToLower();
+
+    if (sort == "last_login") {
+      sortByLogin = true;
+    } else if (sort != "username") {
+      response["error"] = "Sort must be 'username' or 'last_login'.";
+
+      return true;
+    }
+  }
+
+  it = request.find("order");
+
+  if (it != request.end()) {
+    libcomp::String order = libcomp::String(it->second.getString()).ToLower();
+
+    if (order == "desc") {
+      descending = true;
+    } else if (order != "asc") {
+      response["error"] = "Order must be 'asc' or 'desc'.";
+
+      return true;
+    }
+  }
+
+  std::list<libcomp::String> conditions;
+
+  libcomp::String prefix, prefixLike;
+
+  it = request.find("username_prefix");
+
+  if (it != request.end()) {
+    prefix = libcomp::String(it->second.getString()).ToLower();
+
+    if (!prefix.IsEmpty()) {
+      // LIKE matches the prefix under any collation. The escape character
+      // is not a backslash as MariaDB and SQLite disagree on how to quote
+      // one. The lower bound lets databases that do not use an index for
+      // LIKE still start the scan at the prefix.
+      prefixLike = prefix.Replace("!", "!!")
+                       .Replace("%", "!%")
+                       .Replace("_", "!_") +
+                   "%";
+
+      conditions.push_back("Username >= :prefix");
+      conditions.push_back("Username LIKE :prefixLike ESCAPE '!'");
+    }
+  }
+
+  bool filterEnabled = false;
+  bool enabled = false;
+
+  it = request.find("enabled");
+
+  if (it != request.end()) {
+    filterEnabled = true;
+    enabled = it->second.getBoolean();
+
+    conditions.push_back("Enabled = :enabled");
+  }
+
+  int64_t lastLoginMin = -1;
+  int64_t lastLoginMax = -1;
+
+  it = request.find("last_login_min");
+
+  if (it != request.end()) {
+    lastLoginMin = (int64_t)(uint32_t)it->second.getInteger();
+
+    conditions.push_back("LastLogin >= :lastLoginMin");
+  }
+
+  it = request.find("last_login_max");
+
+  if (it != request.end()) {
+    lastLoginMax = (int64_t)(uint32_t)it->second.getInteger();
+
+    conditions.push_back("LastLogin <= :lastLoginMax");
+  }
+
+  // The cursor is the sort key of the last account returned: the username
+  // or "<last login>:<username>" when sorting by last login.
+  bool haveCursor = false;
+  int64_t cursorLogin = 0;
+  libcomp::String cursorName;
+
+  it = request.find("cursor");
+
+  if (it != request.end() && !it->second.getString().empty()) {
+    libcomp::String cursor = it->second.getString();
+
+    if (sortByLogin) {
+      auto parts = cursor.Split(":");
+
+      bool ok = false;
+
+      if (2 <= parts.size()) {
+        cursorLogin = (int64_t)parts.front().ToInteger<uint32_t>(&ok);
+        parts.pop_front();
+        cursorName = libcomp::String::Join(parts, ":");
+      }
+
+      if (!ok) {
+        response["error"] = "Invalid cursor.";
+
+        return true;
+      }
+    } else {
+      cursorName = cursor;
+    }
+
+    haveCursor = true;
+
+    const char* cmp = descending ? "<" : ">";
+
+    if (sortByLogin) {
+      conditions.push_back(
+          libcomp::String("(LastLogin %1 :cursorLogin OR (LastLogin = "
+                          ":cursorLogin AND Username %1 :cursorName))")
+              .Arg(cmp));
+    } else {
+      conditions.push_back(
+          libcomp::String("Username %1 :cursorName").Arg(cmp));
+    }
+  }
+
+  // Load every column so the page is built from this one query instead of
+  // loading each account again by UUID.
+  libcomp::String sql = "SELECT * FROM Account";
+
+  if (!conditions.empty()) {
+    sql += libcomp::String(" WHERE %1")
+               .Arg(libcomp::String::Join(conditions, " AND "));
+  }
+
+  const char* dir = descending ? "DESC" : "ASC";
+
+  if (sortByLogin) {
+    sql += libcomp::String(" ORDER BY LastLogin %1, Username %1").Arg(dir);
+  } else {
+    sql += libcomp::String(" ORDER BY Username %1").Arg(dir);
+  }
+
+  // Request one extra row to know if another page follows.
+  sql += libcomp::String(" LIMIT %1").Arg(limit + 1);
+
+  auto db = GetDatabase();
+  auto query = db->Prepare(sql);
+
+  bool bound = query.IsValid();
+
+  if (bound && !prefix.IsEmpty()) {
+    bound =
+        query.Bind("prefix", prefix) && query.Bind("prefixLike", prefixLike);
+  }
+
+  if (bound && filterEnabled) {
+    bound = query.Bind("enabled", enabled);
+  }
+
+  if (bound && 0 <= lastLoginMin) {
+    bound = query.Bind("lastLoginMin", lastLoginMin);
+  }
+
+  if (bound && 0 <= lastLoginMax) {
+    bound = query.Bind("lastLoginMax", lastLoginMax);
+  }
+
+  if (bound && haveCursor) {
+    bound = query.Bind("cursorName", cursorName) &&
+            (!sortByLogin || query.Bind("cursorLogin", cursorLogin));
+  }
+
+  if (!bound || !query.Execute()) {
+    LogWebAPIErrorMsg("Failed to query the account list.\n");
+
+    response["error"] = "Failed to query accounts.";
+
+    return true;
+  }
+
+  std::list<std::shared_ptr<objects::Account>> accounts;
+  int rows = 0;
+  bool more = false;
+
+  // Sort key of the last row read, taken from the row itself as an
+  // account already loaded by the server may have changed since.
+  int64_t lastLogin = 0;
+  libcomp::String lastName;
+
+  while (query.Next()) {
+    // The extra row only indicates that another page follows.
+    if (++rows > limit) {
+      more = true;
+      break;
+    }
+
+    int64_t rowLogin = 0;
+    libcomp::String rowName;
+
+    if (!query.GetValue("LastLogin", rowLogin) ||
+        !query.GetValue("Username", rowName)) {
+      continue;
+    }
+
+    // Continue after this row even if the account fails to load.
+    lastLogin = rowLogin;
+    lastName = rowName;
+
+    libobjgen::UUID uuid;
+
+    if (!query.GetValue("UID", uuid)) {
+      continue;
+    }
+
+    // Prefer an account already loaded by the server as it may be newer
+    // than the row.
+    auto account =
+        libcomp::PersistentObject::GetObjectByUUID<objects::Account>(uuid);
+
+    if (!account) {
+      account = std::make_shared<objects::Account>();
+
+      if (!account->LoadDatabaseValues(query) ||
+          !account->Register(account, uuid)) {
+        continue;
+      }
+    }
+
+    accounts.push_back(account);
+  }
 
   JsonBox::Array accountObjects;
 
-  for (auto account : accounts) {
+  for (auto& account : accounts) {
     JsonBox::Object obj;
 
     obj["cp"] = (int)account->GetCP();
@@ -528,14 +789,17 @@ bool ApiHandler::Admin_GetAccounts(const JsonBox::Object& request,
     accountObjects.push_back(obj);
   }
 
-  std::sort(accountObjects.begin(), accountObjects.end(),
-            [](const JsonBox::Value& a, const JsonBox::Value& b) {
-              return a.getObject().at("username").getString() <
-                     b.getObject().at("username").getString();
-            });
-
   response["accounts"] = accountObjects;
 
+  if (more && !lastName.IsEmpty()) {
+    if (sortByLogin) {
+      response["next_cursor"] =
+          libcomp::String("%1:%2").Arg(lastLogin).Arg(lastName).ToUtf8();
+    } else {
+      response["next_cursor"] = lastName.ToUtf8();
+    }
+  }
+
   return true;
 }
 
@@ -1183,6 +1447,83 @@ bool ApiHandler::Admin_PostItems(const JsonBox::Object& request,
   return true;
 }
 
+bool ApiHandler::Admin_ReloadData(const JsonBox::Object& request,
+                                  JsonBox::Object& response,
+                                  const std::shared_ptr<ApiSession>& session) {
+  if (!HaveUserLevel(response, session, SVR_CONST.API_ADMIN_LVL_RELOAD_DATA)) {
+    return true;
+  }
+
+  auto world = GetWorld(request, response);
+  auto worldConnection = world ? world->GetConnection() : nullptr;
+  if (!worldConnection) {
+    return true;
+  }
+
+  // The world forwards the request to each of its channels which reload
+  // in the background and keep their current data if the reload fails.
+  libcomp::Packet reload;
+  reload.WritePacketCode(InternalPacketCode_t::PACKET_SERVER_DATA_RELOAD);
+
+  worldConnection->SendPacket(reload);
+
+  response["error"] = "Success";
+
+  return true;
+}
+
+bool ApiHandler::Admin_MemoryReport(
+    const JsonBox::Object& request, JsonBox::Object& response,
+    const std::shared_ptr<ApiSession>& session) {
+  if (!HaveUserLevel(response, session,
+                     SVR_CONST.API_ADMIN_LVL_MEMORY_REPORT)) {
+    return true;
+  }
+
+  auto world = GetWorld(request, response);
+  auto worldConnection = world ? world->GetConnection() : nullptr;
+  if (!worldConnection) {
+    return true;
+  }
+
+  // Ask for fresh reports but reply with the last ones received rather
+  // than waiting on every channel. Each report carries its own timestamp.
+  libcomp::Packet refresh;
+  refresh.WritePacketCode(InternalPacketCode_t::PACKET_MEMORY_REPORT);
+
+  worldConnection->SendPacket(refresh);
+
+  JsonBox::Array channels;
+
+  for (auto& pair : world->GetMemoryReports()) {
+    JsonBox::Object channel;
+    JsonBox::Array usage;
+
+    channel["id"] = (int)pair.first;
+    channel["timestamp"] = (int)pair.second.Timestamp;
+
+    for (auto& entry : pair.second.Usage) {
+      JsonBox::Object obj;
+
+      // Sizes may not fit in a 32-bit integer
+      obj["name"] = entry.Name.ToUtf8();
+      obj["count"] = (double)entry.Count;
+      obj["bytes"] = (double)entry.Bytes;
+
+      usage.push_back(obj);
+    }
+
+    channel["usage"] = usage;
+
+    channels.push_back(channel);
+  }
+
+  response["channels"] = channels;
+  response["error"] = "Success";
+
+  return true;
+}
+
 bool ApiHandler::Admin_GetPromos(const JsonBox::Object& request,
                                  JsonBox::Object& response,
                                  const std::shared_ptr<ApiSession>& session) {
@@ -141,6 +141,12 @@ class ApiHandler : public CivetHandler {
   bool Admin_PostItems(const JsonBox::Object& request,
                        JsonBox::Object& response,
                        const std::shared_ptr<ApiSession>& session);
+  bool Admin_ReloadData(const JsonBox::Object& request,
+                        JsonBox::Object& response,
+                        const std::shared_ptr<ApiSession>& session);
+  bool Admin_MemoryReport(const JsonBox::Object& request,
+                          JsonBox::Object& response,
+                          const std::shared_ptr<ApiSession>& session);
   bool Admin_GetPromos(const JsonBox::Object& request,
                        JsonBox::Object& response,
                        const std::shared_ptr<ApiSession>& session);
@@ -111,13 +111,14 @@ bool ImportHandler::handlePost(CivetServer *pServer,
   }
 
   // Extract the file from the POST data.
-  libcomp::String importData = ExtractFile(szContentType, szPostData);
+  std::string importData =
+      ExtractFile(szContentType, std::string(szPostData, postContentLength));
 
   delete[] szPostData;
 
   // Import the account and collect the error.
   if (mServer) {
-    if (!importData.IsEmpty()) {
+    if (!importData.empty()) {
       importError =
           mServer->ImportAccount(importData, mConfig->GetImportWorld());
     } else {
@@ -154,41 +155,52 @@ bool ImportHandler::handlePost(CivetServer *pServer,
   return true;
 }
 
-libcomp::String ImportHandler::ExtractFile(const libcomp::String &contentType,
-                                           const libcomp::String &contentData) {
-  libcomp::String boundary;
-
-  auto data = libcomp::String("\r\n") + contentData;
+std::string ImportHandler::ExtractFile(const libcomp::String &contentType,
+                                       const std::string &contentData) {
+  std::string boundary;
 
   for (auto _s : contentType.Split(";")) {
     auto s = _s.Trimmed();
 
     if ("boundary=" == s.Left(strlen("boundary="))) {
       // Grab the boundary value.
-      boundary = s.Mid(strlen("boundary="));
-
-      // Remove the end boundary.
-      data = data.LeftOf(libcomp::String("\r\n--%1--\r\n").Arg(boundary));
-
-      // Save out the proper boundary.
-      boundary = libcomp::String("\r\n--%1\r\n").Arg(boundary);
-
-      // Put back a normal boundary at the end.
-      data += boundary;
+      boundary = libcomp::String("\r\n--%1")
+                     .Arg(s.Mid(strlen("boundary=")))
+                     .ToUtf8();
 
       break;
     }
   }
 
-  if (boundary.IsEmpty()) {
+  if (boundary.empty()) {
     return {};
   }
 
-  while (!data.IsEmpty()) {
-    // Parse each part of the multi-part form.
-    auto part = data.LeftOf(boundary);
-    auto headers = part.LeftOf("\r\n\r\n").Split("\r\n");
-    part = part.RightOf("\r\n\r\n");
+  // The file may be a binary account dump so the data is searched as raw
+  // bytes instead of being converted into a string.
+  auto data = std::string("\r\n") + contentData;
+  size_t partStart = data.find(boundary);
+
+  while (std::string::npos != partStart) {
+    partStart += boundary.size();
+
+    // The end boundary is followed by "--" instead of a new line.
+    if (0 != data.compare(partStart, 2, "\r\n")) {
+      break;
+    }
+
+    partStart += 2;
+
+    size_t partEnd = data.find(boundary, partStart);
+    size_t headersEnd = data.find("\r\n\r\n", partStart);
+
+    if (std::string::npos == partEnd || std::string::npos == headersEnd ||
+        headersEnd > partEnd) {
+      break;
+    }
+
+    libcomp::String headerText(data.substr(partStart, headersEnd - partStart));
+    auto headers = headerText.Split("\r\n");
 
     // Look in the headers to see if this is a file.
     for (auto header : headers) {
@@ -200,13 +212,15 @@ libcomp::String ImportHandler::ExtractFile(const libcomp::String &contentType,
 
           // If this is the first file return the data.
           if (!pair.empty() && "filename" == pair.front()) {
-            return part;
+            headersEnd += 4;
+
+            return data.substr(headersEnd, partEnd - headersEnd);
           }
         }
       }
     }
 
-    data = data.RightOf(boundary);
+    partStart = partEnd;
   }
 
   return {};
@@ -54,8 +54,8 @@ class ImportHandler : public CivetHandler {
                           struct mg_connection* pConnection);
 
  private:
-  libcomp::String ExtractFile(const libcomp::String& contentType,
-                              const libcomp::String& contentData);
+  std::string ExtractFile(const libcomp::String& contentType,
+                          const std::string& contentData);
 
   std::shared_ptr<objects::LobbyConfig> mConfig;
   std::shared_ptr<lobby::LobbyServer> mServer;
@@ -27,15 +27,18 @@
 #include "LobbyServer.h"
 
 // libcomp Includes
+#include <AccountDump.h>
 #include <Crypto.h>
 #include <DatabaseConfigMariaDB.h>
 #include <DatabaseConfigSQLite3.h>
 #include <Log.h>
+#include <MemoryStream.h>
 #include <PacketCodes.h>
 
 // Object Includes
 #include "Account.h"
 #include "Character.h"
+#include "FriendSettings.h"
 #include "LobbyConfig.h"
 #include "RegisteredWorld.h"
 
@@ -121,6 +124,8 @@ bool LobbyServer::Initialize() {
       to_underlying(InternalPacketCode_t::PACKET_DATA_SYNC));
   internalPacketManager->AddParser<Parsers::WebGame>(
       to_underlying(InternalPacketCode_t::PACKET_WEB_GAME));
+  internalPacketManager->AddParser<Parsers::MemoryReport>(
+      to_underlying(InternalPacketCode_t::PACKET_MEMORY_REPORT));
 
   // Add the managers to the main worker.
   mMainWorker.AddManager(internalPacketManager);
@@ -542,17 +547,8 @@ libcomp::String LobbyServer::GetFakeAccountSalt(
   }
 }
 
-libcomp::String LobbyServer::ImportAccount(const libcomp::String& data,
+libcomp::String LobbyServer::ImportAccount(const std::string& data,
                                            uint8_t worldID) {
-  tinyxml2::XMLDocument doc;
-
-  if (tinyxml2::XML_SUCCESS != doc.Parse(data.C())) {
-    return "Failed to parse account data.";
-  }
-
-  const tinyxml2::XMLElement* pImportObject =
-      doc.RootElement()->FirstChildElement("object");
-
   std::shared_ptr<libcomp::Database> lobbyDB, worldDB;
 
   {
@@ -576,51 +572,11 @@ libcomp::String LobbyServer::ImportAccount(const libcomp::String& data,
       std::pair<libobjgen::UUID, std::shared_ptr<libcomp::PersistentObject>>>
       worldObjects;
 
-  while (nullptr != pImportObject) {
-    std::string objectType(pImportObject->Attribute("name"));
-
-    auto typeExists = false;
-    auto typeHash =
-        libcomp::PersistentObject::GetTypeHashByName(objectType, typeExists);
-
-    if (!typeExists) {
-      return libcomp::String("Failed to parse unknown object '%1'.")
-          .Arg(objectType);
-    }
-
-    // Grab the UUID for the object.
-    std::string uuidText;
-    libobjgen::UUID uuid;
-
-    const tinyxml2::XMLElement* pMember =
-        pImportObject->FirstChildElement("member");
-
-    while (nullptr != pMember) {
-      if ("uuid" == libcomp::String(pMember->Attribute("name")).ToLower()) {
-        uuidText = pMember->GetText();
-        uuid = libobjgen::UUID(uuidText);
-
-        break;
-      }
-
-      pMember = pMember->NextSiblingElement("member");
-    }
-
-    // Make sure every object has a UUID.
-    if (uuid.IsNull()) {
-      return libcomp::String("Bad UUID '%1' for object '%2'")
-          .Arg(uuidText)
-          .Arg(objectType);
-    }
-
-    auto obj = libcomp::PersistentObject::New(typeHash);
-
-    if (!obj || !obj->Load(doc, *pImportObject)) {
-      return libcomp::String("Failed to load object '%1' with UUID %2.")
-          .Arg(objectType)
-          .Arg(uuid.ToString());
-    }
-
+  // Check each object as it is read from the dump.
+  auto importObject =
+      [&](const libcomp::String& objectType, const libobjgen::UUID& uuid,
+          const std::shared_ptr<libcomp::PersistentObject>& obj)
+      -> libcomp::String {
     std::shared_ptr<libcomp::Database> db;
 
     if ("Account" == objectType) {
@@ -633,9 +589,9 @@ libcomp::String LobbyServer::ImportAccount(const libcomp::String& data,
       worldObjects.push_back(std::make_pair(uuid, obj));
     }
 
-    if (!db) {
-      return "Failed to connect to database.";
-    }
+    auto typeExists = false;
+    auto typeHash = libcomp::PersistentObject::GetTypeHashByName(
+        objectType.ToUtf8(), typeExists);
 
     auto existingObject =
         libcomp::PersistentObject::LoadObjectByUUID(typeHash, db, uuid);
@@ -646,14 +602,93 @@ libcomp::String LobbyServer::ImportAccount(const libcomp::String& data,
           .Arg(uuid.ToString());
     }
 
-    libcomp::String importError =
-        CheckImportObject(objectType, obj, lobbyDB, worldDB);
+    return CheckImportObject(objectType, obj, lobbyDB, worldDB);
+  };
 
-    if (!importError.IsEmpty()) {
-      return importError;
+  if (libhack::AccountDumpReader::IsAccountDump(data.c_str(), data.size())) {
+    libhack::MemoryInStream in(data);
+    libhack::AccountDumpReader reader(in);
+
+    libcomp::String objectType;
+    libobjgen::UUID uuid;
+    std::shared_ptr<libcomp::PersistentObject> obj;
+
+    while (reader.ReadObject(objectType, uuid, obj)) {
+      libcomp::String importError = importObject(objectType, uuid, obj);
+
+      if (!importError.IsEmpty()) {
+        return importError;
+      }
     }
 
-    pImportObject = pImportObject->NextSiblingElement("object");
+    if (!reader.GetError().IsEmpty()) {
+      return reader.GetError();
+    }
+  } else {
+    // Older dumps are XML.
+    tinyxml2::XMLDocument doc;
+
+    if (tinyxml2::XML_SUCCESS != doc.Parse(data.c_str(), data.size()) ||
+        !doc.RootElement()) {
+      return "Failed to parse account data.";
+    }
+
+    const tinyxml2::XMLElement* pImportObject =
+        doc.RootElement()->FirstChildElement("object");
+
+    while (nullptr != pImportObject) {
+      std::string objectType(pImportObject->Attribute("name"));
+
+      auto typeExists = false;
+      auto typeHash =
+          libcomp::PersistentObject::GetTypeHashByName(objectType, typeExists);
+
+      if (!typeExists) {
+        return libcomp::String("Failed to parse unknown object '%1'.")
+            .Arg(objectType);
+      }
+
+      // Grab the UUID for the object.
+      std::string uuidText;
+      libobjgen::UUID uuid;
+
+      const tinyxml2::XMLElement* pMember =
+          pImportObject->FirstChildElement("member");
+
+      while (nullptr != pMember) {
+        if ("uuid" == libcomp::String(pMember->Attribute("name")).ToLower()) {
+          uuidText = pMember->GetText();
+          uuid = libobjgen::UUID(uuidText);
+
+          break;
+        }
+
+        pMember = pMember->NextSiblingElement("member");
+      }
+
+      // Make sure every object has a UUID.
+      if (uuid.IsNull()) {
+        return libcomp::String("Bad UUID '%1' for object '%2'")
+            .Arg(uuidText)
+            .Arg(objectType);
+      }
+
+      auto obj = libcomp::PersistentObject::New(typeHash);
+
+      if (!obj || !obj->Load(doc, *pImportObject)) {
+        return libcomp::String("Failed to load object '%1' with UUID %2.")
+            .Arg(objectType)
+            .Arg(uuid.ToString());
+      }
+
+      libcomp::String importError = importObject(objectType, uuid, obj);
+
+      if (!importError.IsEmpty()) {
+        return importError;
+      }
+
+      pImportObject = pImportObject->NextSiblingElement("object");
+    }
   }
 
   for (auto pair : lobbyObjects) {
@@ -732,6 +767,19 @@ libcomp::String LobbyServer::CheckImportObject(
                                                 character->GetName())) {
       return libcomp::String("Character '%1' exists").Arg(character->GetName());
     }
+
+    // Data managed by the source server is not carried over.
+    character->SetClan(NULLUUID);
+    character->SetDemonQuest(NULLUUID);
+    character->SetCultureData(NULLUUID);
+    character->SetPvPData(NULLUUID);
+  }
+
+  if ("FriendSettings" == objectType) {
+    auto friendSettings =
+        std::dynamic_pointer_cast<objects::FriendSettings>(obj);
+
+    friendSettings->ClearFriends();
   }
 
   return {};
@@ -150,11 +150,11 @@ class LobbyServer : public libhack::Server {
 
   /**
    * Import an account into the database.
-   * @param data XML data for the account.
+   * @param data Binary or XML account dump for the account.
    * @param worldID ID of the world to import the characters into.
    * @returns Error string or an empty string on success.
    */
-  libcomp::String ImportAccount(const libcomp::String& data,
+  libcomp::String ImportAccount(const std::string& data,
                                 uint8_t worldID = 0);
 
   /**
@@ -54,6 +54,7 @@ PACKET_PARSER_DECL(AccountLogin);    // 0x1004
 PACKET_PARSER_DECL(AccountLogout);   // 0x1005
 PACKET_PARSER_DECL(DataSync);        // 0x1007
 PACKET_PARSER_DECL(WebGame);         // 0x100C
+PACKET_PARSER_DECL(MemoryReport);    // 0x100F
 
 }  // namespace Parsers
 
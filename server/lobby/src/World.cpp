@@ -31,6 +31,9 @@
 #include <Packet.h>
 #include <PacketCodes.h>
 
+// Standard C++11 Includes
+#include <ctime>
+
 using namespace lobby;
 
 World::World() {}
@@ -100,3 +103,28 @@ void World::RegisterWorld(
     const std::shared_ptr<objects::RegisteredWorld>& registeredWorld) {
   mRegisteredWorld = registeredWorld;
 }
+
+void World::SetMemoryReport(
+    uint8_t channelID,
+    const std::list<libhack::MemoryAccounting::Usage>& usage) {
+  std::lock_guard<std::mutex> lock(mMemoryReportLock);
+
+  auto& report = mMemoryReports[channelID];
+  report.Timestamp = (uint32_t)std::time(0);
+  report.Usage = usage;
+}
+
+std::unordered_map<uint8_t, World::MemoryReport> World::GetMemoryReports() {
+  std::lock_guard<std::mutex> lock(mMemoryReportLock);
+
+  // Drop reports from channels that are no longer registered
+  for (auto it = mMemoryReports.begin(); it != mMemoryReports.end();) {
+    if (!GetChannelByID(it->first)) {
+      it = mMemoryReports.erase(it);
+    } else {
+      it++;
+    }
+  }
+
+  return mMemoryReports;
+}
@@ -31,6 +31,11 @@
 // libcomp Includes
 #include <Database.h>
 #include <InternalConnection.h>
+#include <MemoryAccounting.h>
+
+// Standard C++11 Includes
+#include <mutex>
+#include <unordered_map>
 
 // object Includes
 #include <RegisteredChannel.h>
@@ -120,6 +125,30 @@ class World {
   void RegisterWorld(
       const std::shared_ptr<objects::RegisteredWorld>& registeredWorld);
 
+  /// Last memory usage report received from a channel
+  struct MemoryReport {
+    /// Time the report was received
+    uint32_t Timestamp;
+
+    /// Usage of each subsystem on the channel
+    std::list<libhack::MemoryAccounting::Usage> Usage;
+  };
+
+  /**
+   * Store the memory usage report of a channel.
+   * @param channelID ID of the channel the report is from
+   * @param usage Usage of each subsystem on the channel
+   */
+  void SetMemoryReport(
+      uint8_t channelID,
+      const std::list<libhack::MemoryAccounting::Usage>& usage);
+
+  /**
+   * Get the last memory usage report received from each channel.
+   * @return Map of memory usage reports by channel ID
+   */
+  std::unordered_map<uint8_t, MemoryReport> GetMemoryReports();
+
  private:
   /// Pointer to the world's connection
   std::shared_ptr<libcomp::InternalConnection> mConnection;
@@ -132,6 +161,12 @@ class World {
 
   /// List of pointers to the RegisteredChannels
   std::list<std::shared_ptr<objects::RegisteredChannel>> mRegisteredChannels;
+
+  /// Last memory usage report received from each channel by ID
+  std::unordered_map<uint8_t, MemoryReport> mMemoryReports;
+
+  /// Lock for the memory reports which are read by the API handler
+  std::mutex mMemoryReportLock;
 };
 
 }  // namespace lobby
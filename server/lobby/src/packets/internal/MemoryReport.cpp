@@ -0,0 +1,70 @@
+/**
+ * @file server/lobby/src/packets/internal/MemoryReport.cpp
+ * @ingroup lobby
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Parser to handle channel memory usage reports from the world.
+ *
+ * This file is part of the Lobby Server (lobby).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Packets.h"
+
+// libcomp Includes
+#include <Log.h>
+#include <ManagerPacket.h>
+#include <MemoryAccounting.h>
+#include <Packet.h>
+#include <PacketCodes.h>
+
+// lobby Includes
+#include "LobbyServer.h"
+#include "World.h"
+
+using namespace lobby;
+
+bool Parsers::MemoryReport::Parse(
+    libcomp::ManagerPacket* pPacketManager,
+    const std::shared_ptr<libcomp::TcpConnection>& connection,
+    libcomp::ReadOnlyPacket& p) const {
+  if (p.Size() < 1) {
+    return false;
+  }
+
+  uint8_t channelID = p.ReadU8();
+
+  std::list<libhack::MemoryAccounting::Usage> usage;
+  if (!libhack::MemoryAccounting::LoadPacket(p, usage)) {
+    return false;
+  }
+
+  auto server =
+      std::dynamic_pointer_cast<LobbyServer>(pPacketManager->GetServer());
+  auto world = server->GetWorldByConnection(
+      std::dynamic_pointer_cast<libcomp::InternalConnection>(connection));
+  if (!world) {
+    LogGeneralErrorMsg("Memory report received from an unknown world\n");
+
+    return false;
+  }
+
+  world->SetMemoryReport(channelID, usage);
+
+  return true;
+}
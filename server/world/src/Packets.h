@@ -34,18 +34,20 @@ namespace world {
 
 namespace Parsers {
 
-PACKET_PARSER_DECL(GetWorldInfo);    // 0x1001
-PACKET_PARSER_DECL(SetChannelInfo);  // 0x1003
-PACKET_PARSER_DECL(AccountLogin);    // 0x1004
-PACKET_PARSER_DECL(AccountLogout);   // 0x1005
-PACKET_PARSER_DECL(Relay);           // 0x1006
-PACKET_PARSER_DECL(DataSync);        // 0x1007
-PACKET_PARSER_DECL(CharacterLogin);  // 0x1008
-PACKET_PARSER_DECL(FriendsUpdate);   // 0x1009
-PACKET_PARSER_DECL(PartyUpdate);     // 0x100A
-PACKET_PARSER_DECL(ClanUpdate);      // 0x100B
-PACKET_PARSER_DECL(WebGame);         // 0x100C
-PACKET_PARSER_DECL(TeamUpdate);      // 0x100D
+PACKET_PARSER_DECL(GetWorldInfo);      // 0x1001
+PACKET_PARSER_DECL(SetChannelInfo);    // 0x1003
+PACKET_PARSER_DECL(AccountLogin);      // 0x1004
+PACKET_PARSER_DECL(AccountLogout);     // 0x1005
+PACKET_PARSER_DECL(Relay);             // 0x1006
+PACKET_PARSER_DECL(DataSync);          // 0x1007
+PACKET_PARSER_DECL(CharacterLogin);    // 0x1008
+PACKET_PARSER_DECL(FriendsUpdate);     // 0x1009
+PACKET_PARSER_DECL(PartyUpdate);       // 0x100A
+PACKET_PARSER_DECL(ClanUpdate);        // 0x100B
+PACKET_PARSER_DECL(WebGame);           // 0x100C
+PACKET_PARSER_DECL(TeamUpdate);        // 0x100D
+PACKET_PARSER_DECL(ServerDataReload);  // 0x100E
+PACKET_PARSER_DECL(MemoryReport);      // 0x100F
 
 }  // namespace Parsers
 
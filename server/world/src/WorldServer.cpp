@@ -109,6 +109,10 @@ void WorldServer::FinishInitialize() {
       to_underlying(InternalPacketCode_t::PACKET_DATA_SYNC));
   packetManager->AddParser<Parsers::WebGame>(
       to_underlying(InternalPacketCode_t::PACKET_WEB_GAME));
+  packetManager->AddParser<Parsers::ServerDataReload>(
+      to_underlying(InternalPacketCode_t::PACKET_SERVER_DATA_RELOAD));
+  packetManager->AddParser<Parsers::MemoryReport>(
+      to_underlying(InternalPacketCode_t::PACKET_MEMORY_REPORT));
 
   // Add the managers to the main worker.
   mMainWorker.AddManager(packetManager);
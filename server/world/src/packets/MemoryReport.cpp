@@ -0,0 +1,89 @@
+/**
+ * @file server/world/src/packets/MemoryReport.cpp
+ * @ingroup world
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Parser to relay memory usage requests from the lobby to every
+ *  channel and their replies back to the lobby.
+ *
+ * This file is part of the World Server (world).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Packets.h"
+
+// libcomp Includes
+#include <Log.h>
+#include <ManagerPacket.h>
+#include <MemoryAccounting.h>
+#include <Packet.h>
+#include <PacketCodes.h>
+
+// world Includes
+#include "WorldServer.h"
+
+using namespace world;
+
+bool Parsers::MemoryReport::Parse(
+    libcomp::ManagerPacket* pPacketManager,
+    const std::shared_ptr<libcomp::TcpConnection>& connection,
+    libcomp::ReadOnlyPacket& p) const {
+  auto server =
+      std::dynamic_pointer_cast<WorldServer>(pPacketManager->GetServer());
+
+  if (connection == server->GetLobbyConnection()) {
+    if (p.Size() != 0) {
+      return false;
+    }
+
+    for (auto& cPair : server->GetChannels()) {
+      libcomp::Packet request;
+      request.WritePacketCode(InternalPacketCode_t::PACKET_MEMORY_REPORT);
+
+      cPair.first->SendPacket(request);
+    }
+
+    return true;
+  }
+
+  auto channel = server->GetChannel(
+      std::dynamic_pointer_cast<libcomp::InternalConnection>(connection));
+  if (!channel) {
+    LogGeneralErrorMsg("Memory report received from an unregistered channel\n");
+
+    return false;
+  }
+
+  std::list<libhack::MemoryAccounting::Usage> usage;
+  if (!libhack::MemoryAccounting::LoadPacket(p, usage)) {
+    return false;
+  }
+
+  auto lobbyConnection = server->GetLobbyConnection();
+  if (lobbyConnection) {
+    libcomp::Packet relay;
+    relay.WritePacketCode(InternalPacketCode_t::PACKET_MEMORY_REPORT);
+    relay.WriteU8(channel->GetID());
+
+    libhack::MemoryAccounting::SavePacket(relay, usage);
+
+    lobbyConnection->SendPacket(relay);
+  }
+
+  return true;
+}
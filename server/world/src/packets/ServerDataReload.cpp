@@ -0,0 +1,68 @@
+/**
+ * @file server/world/src/packets/ServerDataReload.cpp
+ * @ingroup world
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Parser to relay server data reload requests from the lobby to
+ *  every channel.
+ *
+ * This file is part of the World Server (world).
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Packets.h"
+
+// libcomp Includes
+#include <Log.h>
+#include <ManagerPacket.h>
+#include <Packet.h>
+#include <PacketCodes.h>
+
+// world Includes
+#include "WorldServer.h"
+
+using namespace world;
+
+bool Parsers::ServerDataReload::Parse(
+    libcomp::ManagerPacket* pPacketManager,
+    const std::shared_ptr<libcomp::TcpConnection>& connection,
+    libcomp::ReadOnlyPacket& p) const {
+  if (p.Size() != 0) {
+    return false;
+  }
+
+  auto server =
+      std::dynamic_pointer_cast<WorldServer>(pPacketManager->GetServer());
+  if (connection != server->GetLobbyConnection()) {
+    LogGeneralErrorMsg(
+        "Server data reload requested by a server other than the lobby\n");
+
+    return false;
+  }
+
+  LogGeneralInfoMsg("Requesting a server data reload on all channels\n");
+
+  for (auto& cPair : server->GetChannels()) {
+    libcomp::Packet request;
+    request.WritePacketCode(InternalPacketCode_t::PACKET_SERVER_DATA_RELOAD);
+
+    cPair.first->SendPacket(request);
+  }
+
+  return true;
+}
@@ -0,0 +1,337 @@
+/**
+ * @file tools/combatsim/src/main.cpp
+ * @ingroup tools
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Tool to simulate skill damage outside of the channel server.
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Standard C++11 Includes
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// libcomp Includes
+#include <DataStore.h>
+#include <DefinitionManager.h>
+#include <Log.h>
+#include <Randomizer.h>
+
+// object Includes
+#include <MiBattleDamageData.h>
+#include <MiCastBasicData.h>
+#include <MiCastData.h>
+#include <MiConditionData.h>
+#include <MiDamageData.h>
+#include <MiSkillBasicData.h>
+#include <MiSkillData.h>
+
+// channel Includes
+#include <DamageFormula.h>
+
+namespace {
+
+/// Simulation settings read from the command line
+struct Settings {
+  /// ID of the skill to simulate
+  uint32_t SkillID = 0;
+
+  /// Number of hits to simulate
+  uint32_t Count = 0;
+
+  /// Offense value of the source
+  uint16_t Offense = 0;
+
+  /// Defense value of the target
+  uint16_t Defense = 0;
+
+  /// Critical hit chance as a percentage
+  int32_t CritRate = 0;
+
+  /// Limit break chance as a percentage
+  int32_t LimitBreakRate = 0;
+
+  /// Limit break damage rate of the source as a percentage
+  int32_t LimitBreakDamage = 0;
+
+  /// Portion of the defense ignored by critical hits and limit breaks
+  float CritDefenseReduction = 1.f;
+};
+
+int Usage(const char *szAppName) {
+  std::cerr << "USAGE: " << szAppName
+            << " SKILL COUNT OFFENSE DEFENSE CRIT LB LBDAMAGE CRITDEF STORE..."
+            << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "Simulates COUNT hits of the normal damage skill SKILL from a "
+               "source with the OFFENSE value against a target with the "
+               "DEFENSE value."
+            << std::endl;
+  std::cerr << "CRIT and LB are the critical hit and limit break chances as "
+               "percentages from 0 to 100. Limit breaks are checked first."
+            << std::endl;
+  std::cerr << "LBDAMAGE is the limit break damage rate of the source as a "
+               "percentage (the LB_DAMAGE stat)."
+            << std::endl;
+  std::cerr << "CRITDEF is the portion of the target defense ignored by "
+               "critical hits and limit breaks from 0 to 1 (the "
+               "CritDefenseReduction world setting)."
+            << std::endl;
+  std::cerr
+      << "STORE indicates a list of paths to use when loading the datastore."
+      << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "Damage per second assumes the skill is used back to back "
+               "using the charge time and cooldown from the skill data. "
+               "The time spent simulating is reported as well so the tool "
+               "can be used to benchmark the damage formula the channel "
+               "uses once the source and target values are known."
+            << std::endl;
+
+  return EXIT_FAILURE;
+}
+
+bool ParseNumber(const char *szValue, uint32_t maxValue, uint32_t &value) {
+  try {
+    size_t end = 0;
+    unsigned long parsed = std::stoul(szValue, &end);
+
+    if (szValue[end] != 0 || parsed > maxValue) {
+      return false;
+    }
+
+    value = (uint32_t)parsed;
+
+    return true;
+  } catch (...) {
+    return false;
+  }
+}
+
+bool ParseDecimal(const char *szValue, float maxValue, float &value) {
+  try {
+    size_t end = 0;
+    float parsed = std::stof(szValue, &end);
+
+    if (szValue[end] != 0 || parsed < 0.f || parsed > maxValue) {
+      return false;
+    }
+
+    value = parsed;
+
+    return true;
+  } catch (...) {
+    return false;
+  }
+}
+
+bool ParseSettings(int argc, char *argv[], Settings &settings) {
+  uint32_t offense = 0;
+  uint32_t defense = 0;
+  uint32_t critRate = 0;
+  uint32_t lbRate = 0;
+  uint32_t lbDamage = 0;
+
+  if (argc < 10 || !ParseNumber(argv[1], UINT32_MAX, settings.SkillID) ||
+      !ParseNumber(argv[2], UINT32_MAX, settings.Count) ||
+      !ParseNumber(argv[3], UINT16_MAX, offense) ||
+      !ParseNumber(argv[4], UINT16_MAX, defense) ||
+      !ParseNumber(argv[5], 100, critRate) ||
+      !ParseNumber(argv[6], 100, lbRate) ||
+      !ParseNumber(argv[7], INT16_MAX, lbDamage) ||
+      !ParseDecimal(argv[8], 1.f, settings.CritDefenseReduction) ||
+      !settings.Count) {
+    return false;
+  }
+
+  settings.Offense = (uint16_t)offense;
+  settings.Defense = (uint16_t)defense;
+  settings.CritRate = (int32_t)critRate;
+  settings.LimitBreakRate = (int32_t)lbRate;
+  settings.LimitBreakDamage = (int32_t)lbDamage;
+
+  return true;
+}
+
+void PrintDistribution(const char *szLabel, std::vector<int32_t> &values,
+                       double scale) {
+  std::sort(values.begin(), values.end());
+
+  double sum = 0.0;
+  for (int32_t value : values) {
+    sum += (double)value;
+  }
+
+  auto percentile = [&values, scale](double p) {
+    size_t idx = (size_t)((double)(values.size() - 1) * p);
+
+    return (double)values[idx] * scale;
+  };
+
+  std::cout << szLabel << ":" << std::endl;
+  std::cout << "  Mean: " << (sum / (double)values.size()) * scale
+            << std::endl;
+  std::cout << "  Min:  " << percentile(0.0) << std::endl;
+  std::cout << "  P10:  " << percentile(0.1) << std::endl;
+  std::cout << "  P50:  " << percentile(0.5) << std::endl;
+  std::cout << "  P90:  " << percentile(0.9) << std::endl;
+  std::cout << "  P99:  " << percentile(0.99) << std::endl;
+  std::cout << "  Max:  " << percentile(1.0) << std::endl;
+}
+
+int Simulate(const Settings &settings,
+             const std::shared_ptr<objects::MiSkillData> &skillData) {
+  auto battleDamage = skillData->GetDamage()->GetBattleDamage();
+  auto formula = battleDamage->GetFormula();
+
+  if (formula != objects::MiBattleDamageData::Formula_t::DMG_NORMAL &&
+      formula != objects::MiBattleDamageData::Formula_t::DMG_NORMAL_SIMPLE) {
+    std::cerr << "Skill " << settings.SkillID
+              << " does not use a normal damage formula." << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  uint16_t mod = battleDamage->GetModifier1();
+  if (!mod) {
+    std::cerr << "Skill " << settings.SkillID << " does not deal HP damage."
+              << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  // Non-combat skills are not defended against
+  uint16_t defense =
+      skillData->GetBasic()->GetCombatSkill() ? settings.Defense : 0;
+
+  // The target has no resistances, boosts or rates applied
+  channel::DamageRateParams rates;
+  rates.ApplyEntityRates = true;
+  rates.ApplyDependencyDealt = true;
+
+  std::vector<int32_t> damage;
+  damage.reserve(settings.Count);
+
+  uint32_t crits = 0;
+  uint32_t limitBreaks = 0;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint32_t i = 0; i < settings.Count; i++) {
+    channel::NormalDamageParams params;
+    params.Offense = settings.Offense;
+    params.Modifier = mod;
+    params.Defense = defense;
+    params.CritDefenseReduction = settings.CritDefenseReduction;
+
+    if (settings.LimitBreakRate &&
+        RNG(int32_t, 1, 100) <= settings.LimitBreakRate) {
+      params.CritLevel = 2;
+      limitBreaks++;
+    } else if (settings.CritRate && RNG(int32_t, 1, 100) <= settings.CritRate) {
+      params.CritLevel = 1;
+      crits++;
+    }
+
+    params.Scale = channel::DamageFormula::GetScale(
+        params.CritLevel, settings.LimitBreakDamage);
+
+    damage.push_back(channel::DamageFormula::CalculateNormalHit(params, rates));
+  }
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+
+  std::cout << "Skill:    " << settings.SkillID << std::endl;
+  std::cout << "Hits:     " << settings.Count << std::endl;
+  std::cout << "Crits:    " << crits << std::endl;
+  std::cout << "LBs:      " << limitBreaks << std::endl;
+  std::cout << "Time:     " << (double)elapsed / 1000.0 << " ms" << std::endl;
+  std::cout << "Hits/sec: "
+            << (elapsed ? (double)settings.Count * 1000000.0 / (double)elapsed
+                        : 0.0)
+            << std::endl;
+
+  uint32_t cycleTime =
+      skillData->GetCast()->GetBasic()->GetChargeTime() +
+      skillData->GetCondition()->GetCooldownTime();
+
+  PrintDistribution("Damage per hit", damage, 1.0);
+
+  if (cycleTime) {
+    // Cycle time is in milliseconds
+    PrintDistribution("Damage per second", damage,
+                      1000.0 / (double)cycleTime);
+  } else {
+    std::cout << "Damage per second: skill has no charge time or cooldown"
+              << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  Settings settings;
+
+  if (!ParseSettings(argc, argv, settings)) {
+    return Usage(argv[0]);
+  }
+
+  auto log = libhack::Log::GetSingletonPtr();
+  log->SetLogLevel(to_underlying(libhack::LogComponent_t::DefinitionManager),
+                   libcomp::BaseLog::LOG_LEVEL_WARNING);
+  log->AddStandardOutputHook();
+
+  int result = EXIT_FAILURE;
+
+  libcomp::DataStore datastore(argv[0]);
+
+  bool fail = false;
+  for (int i = 9; i < argc; i++) {
+    if (!datastore.AddSearchPath(argv[i])) {
+      fail = true;
+    }
+  }
+
+  libhack::DefinitionManager definitionManager;
+
+  if (!fail && definitionManager.LoadAllData(&datastore)) {
+    auto skillData = definitionManager.GetSkillData(settings.SkillID);
+
+    if (skillData) {
+      result = Simulate(settings, skillData);
+    } else {
+      std::cerr << "Skill " << settings.SkillID << " does not exist."
+                << std::endl;
+    }
+  }
+
+#ifndef EXOTIC_PLATFORM
+  // Stop the logger
+  delete libcomp::BaseLog::GetBaseSingletonPtr();
+#endif  // !EXOTIC_PLATFORM
+
+  return result;
+}
@@ -0,0 +1,257 @@
+/**
+ * @file tools/combatsim/tests/DamageFormula.cpp
+ * @ingroup tools
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Test the damage formulas shared by the channel and the combat
+ *  simulator against the formula the channel used before they were shared.
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Ignore warnings
+#include <PushIgnore.h>
+
+#include <gtest/gtest.h>
+
+// Stop ignoring warnings
+#include <PopIgnore.h>
+
+// Standard C++11 Includes
+#include <cmath>
+#include <limits>
+#include <list>
+
+// channel Includes
+#include <DamageFormula.h>
+
+using namespace channel;
+
+namespace {
+
+/// Rates as SkillManager::AdjustDamageRates determined them
+struct Rates {
+  bool SourceIsTarget;
+  bool IsHeal;
+  bool Pierce;
+  int32_t EntityDealt;
+  int32_t EntityTaken;
+  int32_t DependencyDealt;
+  int32_t DependencyTaken;
+  double TokuseiDealt;
+  double TokuseiTaken;
+};
+
+/// Inline rate adjustment from SkillManager::AdjustDamageRates before it
+/// used DamageFormula
+int32_t OldAdjustDamageRates(int32_t damage, const Rates& r) {
+  float calc = (float)damage;
+  std::list<float> rateTaken;
+
+  if (!r.SourceIsTarget) {
+    calc = calc * (float)(r.EntityDealt * 0.01);
+    rateTaken.push_back((float)(r.EntityTaken * 0.01));
+  }
+
+  if (r.IsHeal || !r.SourceIsTarget) {
+    calc = calc * (float)(r.DependencyDealt * 0.01);
+  }
+
+  if (r.TokuseiDealt != 0.0) {
+    calc = calc * (float)(1.0 + r.TokuseiDealt);
+  }
+
+  rateTaken.push_back((float)(r.DependencyTaken * 0.01));
+  rateTaken.push_back((float)r.TokuseiTaken);
+
+  for (float taken : rateTaken) {
+    if (!r.Pierce || taken > 1.f) {
+      calc = calc * taken;
+    }
+  }
+
+  if (calc < 0.f) {
+    calc = 0.f;
+  } else if (calc > (float)std::numeric_limits<int32_t>::max()) {
+    return std::numeric_limits<int32_t>::max();
+  }
+
+  return (int32_t)floor(calc);
+}
+
+/// Inline normal damage from SkillManager::CalculateDamage_Normal before it
+/// used DamageFormula, once the offense, defense and scale are known
+int32_t OldCalculateDamageNormal(uint16_t off, uint16_t mod,
+                                 uint8_t expertiseRankBoost, uint16_t def,
+                                 uint8_t critLevel, float reduction,
+                                 float scale, float resist, float boost,
+                                 const Rates& rates) {
+  int32_t amount = 0;
+
+  float calc = (float)off * ((float)mod * 0.01f);
+  calc = calc + (float)expertiseRankBoost * 0.5f;
+
+  if (critLevel > 0) {
+    if (reduction != 1.f) {
+      calc = calc - (float)def * (1.f - reduction);
+    }
+  } else {
+    calc = calc - (float)def;
+  }
+
+  if (calc > 0.f) {
+    calc = calc * scale;
+    calc = calc * (1.f + resist * -1.f);
+    calc = calc * (1.f + boost);
+
+    if (calc > (float)std::numeric_limits<int32_t>::max()) {
+      amount = OldAdjustDamageRates(std::numeric_limits<int32_t>::max(), rates);
+    } else {
+      amount = OldAdjustDamageRates((int32_t)floor(calc), rates);
+    }
+  }
+
+  if (amount < 1) {
+    amount = 1;
+  }
+
+  return amount;
+}
+
+/// Convert rates the same way SkillManager::GetDamageRates does
+DamageRateParams GetRateParams(const Rates& r) {
+  DamageRateParams params;
+  if (!r.SourceIsTarget) {
+    params.ApplyEntityRates = true;
+    params.EntityRateDealt = (float)(r.EntityDealt * 0.01);
+    params.EntityRateTaken = (float)(r.EntityTaken * 0.01);
+  }
+
+  params.ApplyDependencyDealt = r.IsHeal || !r.SourceIsTarget;
+  params.DependencyDealt = (float)(r.DependencyDealt * 0.01);
+  params.DependencyTaken = (float)(r.DependencyTaken * 0.01);
+  params.PowerBoost = r.TokuseiDealt;
+  params.DamageTaken = r.TokuseiTaken;
+  params.Pierce = r.Pierce;
+
+  return params;
+}
+
+const Rates RATES[] = {
+    {false, false, false, 100, 100, 100, 100, 0.0, 1.0},
+    {true, false, false, 100, 100, 100, 100, 0.0, 1.0},
+    {false, false, false, 150, 50, 120, 80, 0.25, 0.7},
+    {false, false, true, 150, 50, 120, 80, 0.25, 0.7},
+    {false, false, true, 80, 130, 90, 140, 0.0, 1.3},
+    {true, true, false, 100, 100, 135, 110, 0.1, 1.0},
+    {false, false, false, 100, 100, 0, 100, 0.0, 0.0},
+};
+
+}  // namespace
+
+TEST(DamageFormula, ScaleMatchesOldFormula) {
+  EXPECT_EQ(1.2f, DamageFormula::GetScale(1, 0));
+  EXPECT_EQ(1.2f, DamageFormula::GetScale(1, 250));
+
+  for (int32_t lbDamage : {0, 100, 150, 275, 32767}) {
+    EXPECT_EQ(1.5f * (float)lbDamage * 0.01f,
+              DamageFormula::GetScale(2, lbDamage));
+  }
+
+  for (int i = 0; i < 1000; i++) {
+    float scale = DamageFormula::GetScale(0, 0);
+    EXPECT_GE(scale, 0.8f);
+    EXPECT_LE(scale, 0.99f);
+  }
+}
+
+TEST(DamageFormula, RatesMatchOldFormula) {
+  for (auto& rates : RATES) {
+    auto params = GetRateParams(rates);
+
+    for (int32_t damage : {0, 1, 7, 100, 12345, 999999, 2147483647}) {
+      EXPECT_EQ(OldAdjustDamageRates(damage, rates),
+                DamageFormula::ApplyRates(damage, params))
+          << "Damage " << damage;
+    }
+  }
+}
+
+TEST(DamageFormula, NormalMatchesOldFormula) {
+  struct Hit {
+    uint8_t CritLevel;
+    float Scale;
+  };
+
+  const Hit hits[] = {
+      {0, 0.8f},
+      {0, 0.91f},
+      {0, 0.99f},
+      {1, DamageFormula::GetScale(1, 0)},
+      {2, DamageFormula::GetScale(2, 100)},
+      {2, DamageFormula::GetScale(2, 185)},
+  };
+
+  size_t count = 0;
+  for (uint16_t off : {0, 1, 50, 999, 65535}) {
+    for (uint16_t mod : {1, 100, 250, 5000}) {
+      for (uint16_t def : {0, 30, 400, 65535}) {
+        for (uint8_t expertise : {0, 40}) {
+          for (auto& hit : hits) {
+            for (float reduction : {1.f, 0.5f, 0.f}) {
+              for (float resist : {-0.5f, 0.f, 0.5f, 1.f}) {
+                for (float boost : {-1.f, 0.f, 0.35f}) {
+                  for (auto& rates : RATES) {
+                    NormalDamageParams params;
+                    params.Offense = off;
+                    params.Modifier = mod;
+                    params.ExpertiseRankBoost = expertise;
+                    params.Defense = def;
+                    params.CritLevel = hit.CritLevel;
+                    params.CritDefenseReduction = reduction;
+                    params.Scale = hit.Scale;
+                    params.Resist = resist;
+                    params.Boost = boost;
+
+                    ASSERT_EQ(OldCalculateDamageNormal(
+                                  off, mod, expertise, def, hit.CritLevel,
+                                  reduction, hit.Scale, resist, boost, rates),
+                              DamageFormula::CalculateNormalHit(
+                                  params, GetRateParams(rates)))
+                        << "Offense " << off << ", modifier " << mod
+                        << ", defense " << def << ", crit level "
+                        << (int)hit.CritLevel << ", scale " << hit.Scale;
+
+                    count++;
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  EXPECT_GT(count, (size_t)0);
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
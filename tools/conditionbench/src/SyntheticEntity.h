@@ -0,0 +1,172 @@
+/**
+ * @file tools/conditionbench/src/SyntheticEntity.h
+ * @ingroup tools
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Synthetic entity state to evaluate tokusei conditions against.
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOOLS_CONDITIONBENCH_SRC_SYNTHETICENTITY_H
+#define TOOLS_CONDITIONBENCH_SRC_SYNTHETICENTITY_H
+
+// object Includes
+#include <Tokusei.h>
+#include <TokuseiCondition.h>
+
+// Standard C++11 Includes
+#include <list>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Entity state holding one value per tokusei condition type. Conditions
+ * are evaluated following the same rules TokuseiManager uses for each
+ * condition type so the compiled and interpreted conditions can be
+ * compared without a running channel.
+ */
+class SyntheticEntity {
+ public:
+  /// Values compared against by each condition type
+  typedef std::unordered_map<int8_t, std::vector<int32_t>> ValueTable;
+
+  /**
+   * Gather the values compared against by the conditions of a set of
+   * tokusei so entities can be generated that pass some of them.
+   * @param tokusei Tokusei to gather the condition values of
+   * @return Values compared against by each condition type
+   */
+  static ValueTable GatherValues(
+      const std::list<std::shared_ptr<objects::Tokusei>>& tokusei) {
+    ValueTable values;
+    for (auto& t : tokusei) {
+      for (auto& condition : t->GetConditions()) {
+        values[(int8_t)condition->GetType()].push_back(
+            condition->GetValue());
+      }
+    }
+
+    return values;
+  }
+
+  /**
+   * Generate an entity with a value close to one compared against for
+   * each condition type.
+   * @param values Values compared against by each condition type
+   * @param rng Random number source
+   * @return Generated entity
+   */
+  static SyntheticEntity Random(const ValueTable& values, std::mt19937& rng) {
+    SyntheticEntity entity;
+    entity.mIsCharacter = std::uniform_int_distribution<int>(0, 1)(rng) == 1;
+
+    std::uniform_int_distribution<int32_t> offsetDist(-1, 1);
+    for (auto& pair : values) {
+      std::uniform_int_distribution<size_t> valueDist(
+          0, pair.second.size() - 1);
+      entity.mValues[pair.first] =
+          pair.second[valueDist(rng)] + offsetDist(rng);
+    }
+
+    return entity;
+  }
+
+  /**
+   * Check if the entity is a character.
+   * @return true if the entity is a character
+   */
+  bool IsCharacter() const { return mIsCharacter; }
+
+  /**
+   * Evaluate a single condition.
+   * @param condition Condition to evaluate
+   * @return true if the condition passes
+   */
+  bool Evaluate(
+      const std::shared_ptr<objects::TokuseiCondition>& condition) const {
+    bool numericCompare =
+        condition->GetComparator() !=
+            objects::TokuseiCondition::Comparator_t::EQUALS &&
+        condition->GetComparator() !=
+            objects::TokuseiCondition::Comparator_t::NOT_EQUAL;
+
+    switch (condition->GetType()) {
+      case objects::TokuseiCondition::Type_t::CURRENT_HP:
+      case objects::TokuseiCondition::Type_t::CURRENT_MP:
+      case objects::TokuseiCondition::Type_t::DIASPORA_MINIBOSS_COUNT:
+      case objects::TokuseiCondition::Type_t::GAME_TIME:
+      case objects::TokuseiCondition::Type_t::MOON_PHASE:
+        break;
+      case objects::TokuseiCondition::Type_t::LNC:
+      case objects::TokuseiCondition::Type_t::GENDER:
+      case objects::TokuseiCondition::Type_t::STATUS_ACTIVE:
+      case objects::TokuseiCondition::Type_t::PARTY_DEMON_TYPE:
+        if (numericCompare) {
+          return false;
+        }
+        break;
+      case objects::TokuseiCondition::Type_t::DIGITALIZED:
+      case objects::TokuseiCondition::Type_t::EQUIPPED_WEAPON_TYPE:
+      case objects::TokuseiCondition::Type_t::PARTNER_TYPE:
+      case objects::TokuseiCondition::Type_t::PARTNER_FAMILY:
+      case objects::TokuseiCondition::Type_t::PARTNER_RACE:
+        if (numericCompare || !mIsCharacter) {
+          return false;
+        }
+        break;
+      case objects::TokuseiCondition::Type_t::EXPERTISE:
+      case objects::TokuseiCondition::Type_t::PARTNER_FAMILIARITY:
+      case objects::TokuseiCondition::Type_t::PARTNER_MITAMA:
+        if (!mIsCharacter) {
+          return false;
+        }
+        break;
+      case objects::TokuseiCondition::Type_t::SKILL_STATE:
+      default:
+        // Never valid outside of skill processing
+        return false;
+    }
+
+    auto it = mValues.find((int8_t)condition->GetType());
+    int32_t value = it != mValues.end() ? it->second : 0;
+
+    switch (condition->GetComparator()) {
+      case objects::TokuseiCondition::Comparator_t::EQUALS:
+        return value == condition->GetValue();
+      case objects::TokuseiCondition::Comparator_t::NOT_EQUAL:
+        return value != condition->GetValue();
+      case objects::TokuseiCondition::Comparator_t::GTE:
+        return value >= condition->GetValue();
+      case objects::TokuseiCondition::Comparator_t::LTE:
+        return value <= condition->GetValue();
+      default:
+        return false;
+    }
+  }
+
+ private:
+  /// true if the entity is a character
+  bool mIsCharacter = false;
+
+  /// Value of each condition type
+  std::unordered_map<int8_t, int32_t> mValues;
+};
+
+#endif  // TOOLS_CONDITIONBENCH_SRC_SYNTHETICENTITY_H
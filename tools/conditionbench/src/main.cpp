@@ -0,0 +1,249 @@
+/**
+ * @file tools/conditionbench/src/main.cpp
+ * @ingroup tools
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Tool to benchmark compiled tokusei conditions against the
+ *  interpreted conditions.
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Standard C++11 Includes
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+// libcomp Includes
+#include <DataStore.h>
+#include <DefinitionManager.h>
+#include <Log.h>
+#include <ServerDataManager.h>
+
+// object Includes
+#include <Tokusei.h>
+
+// channel Includes
+#include <TokuseiConditionProgram.h>
+
+// conditionbench Includes
+#include "SyntheticEntity.h"
+
+namespace {
+
+int Usage(const char *szAppName) {
+  std::cerr << "USAGE: " << szAppName << " COUNT STORE..." << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "Evaluates the conditions of every tokusei in the server data "
+               "for COUNT synthetic entities, first interpreted and then "
+               "compiled the way the channel evaluates them. Both must "
+               "produce the same results."
+            << std::endl;
+  std::cerr
+      << "STORE indicates a list of paths to use when loading the datastore."
+      << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "Each condition is checked against a fixed value per "
+               "condition type so the times measure the cost of walking the "
+               "conditions rather than looking up entity state."
+            << std::endl;
+
+  return EXIT_FAILURE;
+}
+
+bool ParseCount(const char *szValue, uint32_t &value) {
+  try {
+    size_t end = 0;
+    unsigned long parsed = std::stoul(szValue, &end);
+
+    if (szValue[end] != 0 || !parsed || parsed > UINT32_MAX) {
+      return false;
+    }
+
+    value = (uint32_t)parsed;
+
+    return true;
+  } catch (...) {
+    return false;
+  }
+}
+
+double ElapsedMS(const std::chrono::steady_clock::time_point &start) {
+  return (double)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         1000.0;
+}
+
+int Benchmark(uint32_t count,
+              const std::list<std::shared_ptr<objects::Tokusei>> &tokusei) {
+  size_t conditionCount = 0;
+  for (auto &t : tokusei) {
+    conditionCount += t->ConditionsCount();
+  }
+
+  // Fixed seed so runs can be compared
+  std::mt19937 rng(43);
+
+  auto values = SyntheticEntity::GatherValues(tokusei);
+
+  std::vector<SyntheticEntity> entities;
+  entities.reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    entities.push_back(SyntheticEntity::Random(values, rng));
+  }
+
+  std::vector<bool> expected;
+  expected.reserve((size_t)count * tokusei.size());
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (auto &entity : entities) {
+    auto evaluate =
+        [&entity](const std::shared_ptr<objects::TokuseiCondition> &c) {
+          return entity.Evaluate(c);
+        };
+
+    for (auto &t : tokusei) {
+      expected.push_back(
+          channel::TokuseiConditionProgram::EvaluateInterpreted(t, evaluate));
+    }
+  }
+
+  double interpretedMS = ElapsedMS(start);
+
+  start = std::chrono::steady_clock::now();
+
+  std::vector<channel::TokuseiConditionProgram> programs;
+  programs.reserve(tokusei.size());
+  for (auto &t : tokusei) {
+    programs.push_back(channel::TokuseiConditionProgram(t));
+  }
+
+  double compileMS = ElapsedMS(start);
+
+  std::vector<bool> results;
+  results.reserve(expected.size());
+
+  start = std::chrono::steady_clock::now();
+
+  for (auto &entity : entities) {
+    auto evaluate =
+        [&entity](const std::shared_ptr<objects::TokuseiCondition> &c) {
+          return entity.Evaluate(c);
+        };
+
+    for (auto &program : programs) {
+      results.push_back(program.Evaluate(entity.IsCharacter(), evaluate));
+    }
+  }
+
+  double compiledMS = ElapsedMS(start);
+
+  size_t passed = 0;
+  size_t mismatches = 0;
+  for (size_t i = 0; i < expected.size(); i++) {
+    if (expected[i]) {
+      passed++;
+    }
+
+    if (expected[i] != results[i]) {
+      mismatches++;
+    }
+  }
+
+  std::cout << "Tokusei:     " << tokusei.size() << std::endl;
+  std::cout << "Conditions:  " << conditionCount << std::endl;
+  std::cout << "Entities:    " << count << std::endl;
+  std::cout << "Evaluations: " << expected.size() << std::endl;
+  std::cout << "Passed:      " << passed << std::endl;
+  std::cout << "Compile:     " << compileMS << " ms" << std::endl;
+  std::cout << "Interpreted: " << interpretedMS << " ms" << std::endl;
+  std::cout << "Compiled:    " << compiledMS << " ms" << std::endl;
+  std::cout << "Speedup:     "
+            << (compiledMS > 0.0 ? interpretedMS / compiledMS : 0.0) << "x"
+            << std::endl;
+
+  if (mismatches) {
+    std::cerr << mismatches
+              << " evaluations differ between the interpreted and compiled "
+                 "conditions."
+              << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  uint32_t count = 0;
+
+  if (argc < 3 || !ParseCount(argv[1], count)) {
+    return Usage(argv[0]);
+  }
+
+  auto log = libhack::Log::GetSingletonPtr();
+  log->SetLogLevel(to_underlying(libhack::LogComponent_t::DefinitionManager),
+                   libcomp::BaseLog::LOG_LEVEL_WARNING);
+  log->SetLogLevel(to_underlying(libhack::LogComponent_t::ServerDataManager),
+                   libcomp::BaseLog::LOG_LEVEL_WARNING);
+  log->AddStandardOutputHook();
+
+  int result = EXIT_FAILURE;
+
+  libcomp::DataStore datastore(argv[0]);
+
+  bool fail = false;
+  for (int i = 2; i < argc; i++) {
+    if (!datastore.AddSearchPath(argv[i])) {
+      fail = true;
+    }
+  }
+
+  libhack::DefinitionManager definitionManager;
+  libhack::ServerDataManager serverDataManager;
+
+  if (!fail && definitionManager.LoadAllData(&datastore) &&
+      serverDataManager.LoadData(&datastore, &definitionManager)) {
+    std::list<std::shared_ptr<objects::Tokusei>> tokusei;
+    for (auto &pair : definitionManager.GetAllTokuseiData()) {
+      if (pair.second->ConditionsCount() > 0) {
+        tokusei.push_back(pair.second);
+      }
+    }
+
+    if (!tokusei.empty()) {
+      result = Benchmark(count, tokusei);
+    } else {
+      std::cerr << "No tokusei with conditions were loaded." << std::endl;
+    }
+  }
+
+#ifndef EXOTIC_PLATFORM
+  // Stop the logger
+  delete libcomp::BaseLog::GetBaseSingletonPtr();
+#endif  // !EXOTIC_PLATFORM
+
+  return result;
+}
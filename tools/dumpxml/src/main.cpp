@@ -0,0 +1,72 @@
+/**
+ * @file tools/dumpxml/src/main.cpp
+ * @ingroup tools
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Tool to convert a binary account dump into XML.
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// libhack Includes
+#include <AccountDump.h>
+
+// Standard C++11 Includes
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char *argv[]) {
+  if (3 != argc) {
+    std::cerr << "USAGE: " << argv[0] << " IN OUT" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Converts the binary account dump IN into the XML account "
+                 "dump OUT. The dump must have been written by a server "
+                 "with the same version of the objects as this tool."
+              << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  std::ifstream in;
+  in.open(argv[1], std::ifstream::in | std::ifstream::binary);
+
+  if (!in.good()) {
+    std::cerr << "Failed to open input file." << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  std::ofstream out;
+  out.open(argv[2], std::ofstream::out | std::ofstream::binary);
+
+  if (!out.good()) {
+    std::cerr << "Failed to open output file." << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  libcomp::String error = libhack::AccountDumpReader::ConvertToXml(in, out);
+
+  if (!error.IsEmpty()) {
+    std::cerr << error.ToUtf8() << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
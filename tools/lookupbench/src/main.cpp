@@ -0,0 +1,191 @@
+/**
+ * @file tools/lookupbench/src/main.cpp
+ * @ingroup tools
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Tool to benchmark skill definition lookups through the map
+ *  against the flat definition index.
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Standard C++11 Includes
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// libcomp Includes
+#include <DataStore.h>
+#include <DefinitionManager.h>
+#include <Log.h>
+
+// object Includes
+#include <MiCategoryData.h>
+#include <MiSkillData.h>
+#include <MiSkillItemStatusCommonData.h>
+
+namespace {
+
+int Usage(const char *szAppName) {
+  std::cerr << "USAGE: " << szAppName << " COUNT STORE..." << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "Looks up COUNT random skill definitions the way stat "
+               "recalculation does, first through the shared pointer map "
+               "and then through the flat definition index. Both must find "
+               "the same definitions."
+            << std::endl;
+  std::cerr
+      << "STORE indicates a list of paths to use when loading the datastore."
+      << std::endl;
+
+  return EXIT_FAILURE;
+}
+
+bool ParseCount(const char *szValue, uint32_t &value) {
+  try {
+    size_t end = 0;
+    unsigned long parsed = std::stoul(szValue, &end);
+
+    if (szValue[end] != 0 || !parsed || parsed > UINT32_MAX) {
+      return false;
+    }
+
+    value = (uint32_t)parsed;
+
+    return true;
+  } catch (...) {
+    return false;
+  }
+}
+
+double ElapsedMS(const std::chrono::steady_clock::time_point &start) {
+  return (double)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         1000.0;
+}
+
+double PerSecond(uint32_t count, double ms) {
+  return ms > 0.0 ? (double)count * 1000.0 / ms : 0.0;
+}
+
+int Benchmark(uint32_t count, libhack::DefinitionManager &definitionManager) {
+  std::vector<uint32_t> skillIDs;
+  for (auto &pair : definitionManager.GetAllSkillData()) {
+    skillIDs.push_back(pair.first);
+  }
+
+  if (skillIDs.empty()) {
+    std::cerr << "No skills were loaded." << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  // Fixed seed so runs can be compared
+  std::mt19937 rng(43);
+  std::uniform_int_distribution<size_t> idDist(0, skillIDs.size() - 1);
+
+  std::vector<uint32_t> lookups;
+  lookups.reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    lookups.push_back(skillIDs[idDist(rng)]);
+  }
+
+  // Read the category of each skill like ApplySkillCorrectTbls so the
+  // definition itself is touched and the lookups are not optimized out
+  uint64_t mapSum = 0;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint32_t skillID : lookups) {
+    auto skillData = definitionManager.GetSkillData(skillID);
+    mapSum += skillData->GetCommon()->GetCategory()->GetMainCategory();
+  }
+
+  double mapMS = ElapsedMS(start);
+
+  uint64_t indexSum = 0;
+
+  start = std::chrono::steady_clock::now();
+
+  for (uint32_t skillID : lookups) {
+    auto skillData = definitionManager.GetSkillDataPtr(skillID);
+    indexSum += skillData->GetCommon()->GetCategory()->GetMainCategory();
+  }
+
+  double indexMS = ElapsedMS(start);
+
+  std::cout << "Skills:  " << skillIDs.size() << std::endl;
+  std::cout << "Lookups: " << count << std::endl;
+  std::cout << "Map:     " << mapMS << " ms (" << PerSecond(count, mapMS)
+            << " lookups/s)" << std::endl;
+  std::cout << "Index:   " << indexMS << " ms (" << PerSecond(count, indexMS)
+            << " lookups/s)" << std::endl;
+  std::cout << "Speedup: " << (indexMS > 0.0 ? mapMS / indexMS : 0.0) << "x"
+            << std::endl;
+
+  if (mapSum != indexSum) {
+    std::cerr << "The map and the index returned different definitions."
+              << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  uint32_t count = 0;
+
+  if (argc < 3 || !ParseCount(argv[1], count)) {
+    return Usage(argv[0]);
+  }
+
+  auto log = libhack::Log::GetSingletonPtr();
+  log->SetLogLevel(to_underlying(libhack::LogComponent_t::DefinitionManager),
+                   libcomp::BaseLog::LOG_LEVEL_WARNING);
+  log->AddStandardOutputHook();
+
+  int result = EXIT_FAILURE;
+
+  libcomp::DataStore datastore(argv[0]);
+
+  bool fail = false;
+  for (int i = 2; i < argc; i++) {
+    if (!datastore.AddSearchPath(argv[i])) {
+      fail = true;
+    }
+  }
+
+  libhack::DefinitionManager definitionManager;
+
+  if (!fail && definitionManager.LoadAllData(&datastore)) {
+    result = Benchmark(count, definitionManager);
+  }
+
+#ifndef EXOTIC_PLATFORM
+  // Stop the logger
+  delete libcomp::BaseLog::GetBaseSingletonPtr();
+#endif  // !EXOTIC_PLATFORM
+
+  return result;
+}
@@ -0,0 +1,202 @@
+/**
+ * @file tools/poolbench/src/main.cpp
+ * @ingroup tools
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Tool to benchmark pooled enemy allocation when many threads
+ *  spawn and despawn at once.
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Standard C++11 Includes
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// libcomp Includes
+#include <ObjectPool.h>
+
+// object Includes
+#include <Enemy.h>
+
+namespace {
+
+/// Number of enemies spawned together before the previous wave despawns
+const size_t WAVE_SIZE = 32;
+
+int Usage(const char *szAppName) {
+  std::cerr << "USAGE: " << szAppName << " THREADS COUNT" << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "Spawns COUNT enemies on each of THREADS threads in waves, "
+               "despawning each wave after the next one spawns. This is run "
+               "once with std::make_shared, once with a pool per thread the "
+               "way each zone has its own pool and once with a single pool "
+               "shared by every thread."
+            << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "The shared pool shows the cost of lock contention on the "
+               "free list when zones on different threads spawn at once."
+            << std::endl;
+
+  return EXIT_FAILURE;
+}
+
+bool ParseCount(const char *szValue, uint32_t &value) {
+  try {
+    size_t end = 0;
+    unsigned long parsed = std::stoul(szValue, &end);
+
+    if (szValue[end] != 0 || !parsed || parsed > UINT32_MAX) {
+      return false;
+    }
+
+    value = (uint32_t)parsed;
+
+    return true;
+  } catch (...) {
+    return false;
+  }
+}
+
+double ElapsedMS(const std::chrono::steady_clock::time_point &start) {
+  return (double)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         1000.0;
+}
+
+/**
+ * Spawn and despawn enemies on several threads at once.
+ * @param threadCount Number of threads to spawn on
+ * @param count Number of enemies to spawn on each thread
+ * @param create Function taking the thread index that creates an enemy
+ * @return Time taken in milliseconds
+ */
+template <typename Create>
+double Spawn(uint32_t threadCount, uint32_t count, Create create) {
+  std::list<std::thread> threads;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint32_t t = 0; t < threadCount; t++) {
+    threads.push_back(std::thread([t, count, &create]() {
+      std::vector<std::shared_ptr<objects::Enemy>> wave;
+      std::vector<std::shared_ptr<objects::Enemy>> previous;
+      wave.reserve(WAVE_SIZE);
+      previous.reserve(WAVE_SIZE);
+
+      for (uint32_t i = 0; i < count; i++) {
+        wave.push_back(create(t));
+
+        if (wave.size() == WAVE_SIZE) {
+          // Despawn the previous wave now that the new one is up
+          previous.clear();
+          previous.swap(wave);
+        }
+      }
+    }));
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  return ElapsedMS(start);
+}
+
+void PrintResult(const char *szName, uint64_t total, double ms) {
+  std::cout << szName << std::endl;
+  std::cout << "  Total:   " << ms << " ms" << std::endl;
+  std::cout << "  Spawns:  " << (ms > 0.0 ? (double)total * 1000.0 / ms : 0.0)
+            << " per second" << std::endl;
+}
+
+void PrintStats(uint64_t hits, uint64_t misses, size_t pooled) {
+  std::cout << "  Hits:    " << hits << std::endl;
+  std::cout << "  Misses:  " << misses << std::endl;
+  std::cout << "  Pooled:  " << pooled << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  uint32_t threadCount = 0;
+  uint32_t count = 0;
+
+  if (argc != 3 || !ParseCount(argv[1], threadCount) ||
+      !ParseCount(argv[2], count)) {
+    return Usage(argv[0]);
+  }
+
+  uint64_t total = (uint64_t)threadCount * count;
+
+  std::cout << "Threads: " << threadCount << std::endl;
+  std::cout << "Enemies: " << count << " per thread" << std::endl;
+
+  double ms = Spawn(threadCount, count, [](uint32_t) {
+    return std::make_shared<objects::Enemy>();
+  });
+
+  PrintResult("make_shared", total, ms);
+
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  size_t pooled = 0;
+
+  {
+    std::vector<libhack::ObjectPool<objects::Enemy>> pools(threadCount);
+
+    ms = Spawn(threadCount, count,
+               [&pools](uint32_t t) { return pools[t].Create(); });
+
+    PrintResult("Pool per thread", total, ms);
+
+    uint64_t poolHits, poolMisses;
+    size_t poolPooled;
+
+    for (auto &pool : pools) {
+      pool.GetStats(poolHits, poolMisses, poolPooled);
+
+      hits += poolHits;
+      misses += poolMisses;
+      pooled += poolPooled;
+    }
+
+    PrintStats(hits, misses, pooled);
+  }
+
+  {
+    libhack::ObjectPool<objects::Enemy> pool;
+
+    ms = Spawn(threadCount, count,
+               [&pool](uint32_t) { return pool.Create(); });
+
+    PrintResult("Shared pool", total, ms);
+
+    pool.GetStats(hits, misses, pooled);
+
+    PrintStats(hits, misses, pooled);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,257 @@
+/**
+ * @file tools/sbinbench/src/main.cpp
+ * @ingroup tools
+ *
+ * @author COMP Omega <compomega@tutanota.com>
+ *
+ * @brief Tool to benchmark parsing the largest binary data files.
+ *
+ * Copyright (C) 2012-2020 COMP_hack Team <compomega@tutanota.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Standard C++11 Includes
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+// POSIX Includes
+#include <sys/resource.h>
+#endif  // !_WIN32
+
+// libcomp Includes
+#include <DataStore.h>
+#include <Log.h>
+#include <MemoryStream.h>
+#include <Object.h>
+
+// object Includes
+#include <MiDevilData.h>
+#include <MiItemData.h>
+
+namespace {
+
+int Usage(const char *szAppName) {
+  std::cerr << "USAGE: " << szAppName << " MODE COUNT STORE..." << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "Decrypts ItemData.sbin and DevilData.sbin once and then "
+               "parses each of them COUNT times."
+            << std::endl;
+  std::cerr << "MODE is 'memory' to parse straight from the decrypted data "
+               "the way the server does or 'copy' to copy it into a string "
+               "and a string stream first."
+            << std::endl;
+  std::cerr
+      << "STORE indicates a list of paths to use when loading the datastore."
+      << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "The peak resident size is process wide so run each mode "
+               "separately to compare them."
+            << std::endl;
+
+  return EXIT_FAILURE;
+}
+
+bool ParseCount(const char *szValue, uint32_t &value) {
+  try {
+    size_t end = 0;
+    unsigned long parsed = std::stoul(szValue, &end);
+
+    if (szValue[end] != 0 || !parsed || parsed > UINT32_MAX) {
+      return false;
+    }
+
+    value = (uint32_t)parsed;
+
+    return true;
+  } catch (...) {
+    return false;
+  }
+}
+
+double ElapsedMS(const std::chrono::steady_clock::time_point &start) {
+  return (double)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         1000.0;
+}
+
+/**
+ * Get the peak resident size of the process.
+ * @return Peak resident size in bytes or 0 if it is not known
+ */
+uint64_t PeakResidentSize() {
+#ifdef _WIN32
+  return 0;
+#else   // _WIN32
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+
+#ifdef __APPLE__
+  return (uint64_t)usage.ru_maxrss;
+#else   // __APPLE__
+  // Linux reports the size in kilobytes
+  return (uint64_t)usage.ru_maxrss * 1024;
+#endif  // __APPLE__
+#endif  // _WIN32
+}
+
+/**
+ * Parse every record of a binary data file the same way
+ * DefinitionManager::LoadBinaryData does.
+ * @param in Stream holding the decrypted file
+ * @param records Output list to load the records into
+ * @return true if every record was parsed
+ */
+template <class T>
+bool Parse(std::istream &in, std::list<std::shared_ptr<T>> &records) {
+  libcomp::ObjectInStream ois(in);
+
+  uint16_t entryCount, tableCount;
+  ois.stream.read(reinterpret_cast<char *>(&entryCount), sizeof(entryCount));
+  ois.stream.read(reinterpret_cast<char *>(&tableCount), sizeof(tableCount));
+
+  if (!ois.stream.good()) {
+    return false;
+  }
+
+  size_t dynamicCounts = (size_t)(entryCount * tableCount);
+  for (size_t i = 0; i < dynamicCounts; i++) {
+    uint16_t ds;
+    ois.stream.read(reinterpret_cast<char *>(&ds), sizeof(ds));
+    ois.dynamicSizes.push_back(ds);
+  }
+
+  for (uint16_t i = 0; i < entryCount; i++) {
+    auto entry = std::shared_ptr<T>(new T);
+
+    if (!entry->Load(ois)) {
+      return false;
+    }
+
+    records.push_back(entry);
+  }
+
+  return ois.stream.good();
+}
+
+template <class T>
+bool Benchmark(libcomp::DataStore &datastore, const char *szPath,
+               uint32_t count, bool copy) {
+  std::vector<char> data = datastore.DecryptFile(szPath);
+  if (data.empty()) {
+    std::cerr << "Failed to load/decrypt '" << szPath << "'." << std::endl;
+
+    return false;
+  }
+
+  size_t entries = 0;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint32_t i = 0; i < count; i++) {
+    std::list<std::shared_ptr<T>> records;
+
+    bool success = false;
+    if (copy) {
+      // How the data was parsed before MemoryInStream
+      std::stringstream ss(std::string(data.begin(), data.end()));
+      success = Parse(ss, records);
+    } else {
+      libhack::MemoryInStream ss(data);
+      success = Parse(ss, records);
+    }
+
+    if (!success) {
+      std::cerr << "Failed to parse '" << szPath << "'." << std::endl;
+
+      return false;
+    }
+
+    entries = records.size();
+  }
+
+  double totalMS = ElapsedMS(start);
+
+  std::cout << szPath << std::endl;
+  std::cout << "  Size:      " << data.size() << " bytes" << std::endl;
+  std::cout << "  Records:   " << entries << std::endl;
+  std::cout << "  Total:     " << totalMS << " ms" << std::endl;
+  std::cout << "  Per parse: " << totalMS / count << " ms" << std::endl;
+
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  uint32_t count = 0;
+
+  if (argc < 4 || !ParseCount(argv[2], count)) {
+    return Usage(argv[0]);
+  }
+
+  std::string mode = argv[1];
+  if (mode != "memory" && mode != "copy") {
+    return Usage(argv[0]);
+  }
+
+  bool copy = mode == "copy";
+
+  auto log = libhack::Log::GetSingletonPtr();
+  log->AddStandardOutputHook();
+
+  int result = EXIT_FAILURE;
+
+  libcomp::DataStore datastore(argv[0]);
+
+  bool fail = false;
+  for (int i = 3; i < argc; i++) {
+    if (!datastore.AddSearchPath(argv[i])) {
+      fail = true;
+    }
+  }
+
+  if (!fail &&
+      Benchmark<objects::MiItemData>(datastore, "Shield/ItemData.sbin", count,
+                                     copy) &&
+      Benchmark<objects::MiDevilData>(datastore, "Shield/DevilData.sbin",
+                                      count, copy)) {
+    uint64_t peak = PeakResidentSize();
+    if (peak) {
+      std::cout << "Peak resident size: " << peak / 1024 << " KiB"
+                << std::endl;
+    } else {
+      std::cout << "Peak resident size: unknown" << std::endl;
+    }
+
+    result = EXIT_SUCCESS;
+  }
+
+#ifndef EXOTIC_PLATFORM
+  // Stop the logger
+  delete libcomp::BaseLog::GetBaseSingletonPtr();
+#endif  // !EXOTIC_PLATFORM
+
+  return result;
+}